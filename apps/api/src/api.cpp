@@ -4,6 +4,7 @@
 #include <biocma_cst_config.hpp>
 #include <common/common.hpp>
 #include <common/execinfo.hpp>
+#include <common/instrumentation.hpp>
 #include <common/logger.hpp>
 #include <common/traits.hpp>
 #include <core/case_data.hpp>
@@ -369,6 +370,15 @@ namespace Api
   SimulationInstance::register_parameters(
       Core::UserControlParameters&& _params) noexcept
   {
+    // Instrumentation given by user takes precedence over env variable
+    if (_params.instrumentation.has_value())
+    {
+      if (const auto mask
+          = Common::InstrumentationMask::parse(*_params.instrumentation))
+      {
+        _data.exec_info.kernel_options.instrumentation = *mask;
+      }
+    }
     params = std::move(_params);
     registered = true;
     return ApiResult();
@@ -1,5 +1,6 @@
 #include "common/logger.hpp"
 #include <cli_parser.hpp>
+#include <common/instrumentation.hpp>
 #include <core/simulation_parameters.hpp>
 #include <cstdlib>
 #include <exception>
@@ -149,6 +150,18 @@ parseArg(Core::UserControlParameters& user_control,
             {
               user_control.load_serde = true;
               user_control.serde_file = std::string(value);
+            } },
+          { "instr",
+            [&user_control](std::string_view value)
+            {
+              if (!Common::InstrumentationMask::parse(value).has_value())
+              {
+                throw std::invalid_argument(
+                    "Unknown instrumentation (expected probe,event,dump, all "
+                    "or none): "
+                    + std::string(value));
+              }
+              user_control.instrumentation = std::string(value);
             } } };
 
   auto it = param_handlers.find(current_param);
@@ -316,6 +329,9 @@ get_help_message() noexcept
   //   os << i << "\r\n";
   // }
 
+  os << "\nInstrumentation (overrides BIOMC_INSTRUMENTATION):" << '\n';
+  os << "  -instr <probe,event,dump|all|none>" << '\n';
+
   os << "\nExample:" << '\n';
   os << "  BIOCMA-MCST -np 100 -ff /path/to/flow_file_folder/ [-v]" << '\n';
 
@@ -0,0 +1,86 @@
+#ifndef __CORE_CHUNK_STREAM_HPP__
+#define __CORE_CHUNK_STREAM_HPP__
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Core
+{
+  /**
+   * @brief Elements [begin, end) of a streamed chunk, index selects the
+   * staging buffer (index % 2)
+   */
+  struct ChunkRange
+  {
+    std::size_t index;
+    std::size_t begin;
+    std::size_t end;
+
+    [[nodiscard]] constexpr std::size_t
+    size() const noexcept
+    {
+      return end - begin;
+    }
+  };
+
+  /**
+   * @brief Elements per chunk such that n_buffer buffers of n_row rows of
+   * doubles fit in memory_bound bytes, at least one element
+   */
+  constexpr std::size_t
+  stream_chunk_size(const std::size_t memory_bound,
+                    const std::size_t n_row,
+                    const std::size_t n_element,
+                    const std::size_t n_buffer = 2) noexcept
+  {
+    // HDF5 chunks are limited to 4GB
+    constexpr std::size_t max_chunk = std::size_t{ 1 } << 28;
+    const std::size_t row_bytes = std::max<std::size_t>(n_buffer, 1)
+                                  * std::max<std::size_t>(n_row, 1)
+                                  * sizeof(double);
+    const std::size_t upper
+        = std::clamp<std::size_t>(n_element, 1, max_chunk);
+    return std::clamp<std::size_t>(memory_bound / row_bytes, 1, upper);
+  }
+
+  /**
+   * @brief Double buffered streaming of n_element elements by chunk.
+   *
+   * stage(k) starts an asynchronous copy of chunk k, wait() blocks until
+   * staged copies are done and write(k) consumes chunk k. The copy of chunk
+   * k is issued before chunk k-1 is written so that both overlap, a staging
+   * buffer is only reused once its chunk has been written.
+   */
+  template <typename Stage, typename Wait, typename Write>
+  void
+  stream_chunks(const std::size_t n_element,
+                const std::size_t chunk,
+                Stage&& stage,
+                Wait&& wait,
+                Write&& write)
+  {
+    if (n_element == 0 || chunk == 0)
+    {
+      return;
+    }
+    const auto range = [n_element, chunk](std::size_t index)
+    {
+      const std::size_t begin = index * chunk;
+      return ChunkRange{ index, begin, std::min(begin + chunk, n_element) };
+    };
+    const std::size_t n_chunk = (n_element + chunk - 1) / chunk;
+
+    stage(range(0));
+    for (std::size_t index = 1; index < n_chunk; ++index)
+    {
+      wait();
+      stage(range(index));
+      write(range(index - 1));
+    }
+    wait();
+    write(range(n_chunk - 1));
+  }
+
+} // namespace Core
+
+#endif
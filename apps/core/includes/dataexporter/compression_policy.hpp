@@ -0,0 +1,110 @@
+#ifndef __CORE_COMPRESSION_POLICY_HPP__
+#define __CORE_COMPRESSION_POLICY_HPP__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Core
+{
+  /**
+   * @brief Exported datasets sharing the same compression settings
+   */
+  enum class DatasetClass : std::uint8_t
+  {
+    Fields = 0, ///< Concentrations, volumes, particle numbers and tallies
+    Particles,  ///< Particle properties and ages
+    Probes      ///< Probe buffers
+  };
+
+  constexpr std::size_t n_dataset_class = 3;
+
+  constexpr std::array<std::string_view, n_dataset_class> dataset_class_names
+      = { "fields", "particles", "probes" };
+
+  /**
+   * @brief Filters applied to the compressed datasets of one class.
+   *
+   * Settings are read from a comma separated list:
+   * - `none`: no compression filter
+   * - `deflate:<level>` or `<level>`: gzip level 0-9, 0 disables it
+   * - `lz4`, `zstd[:<level>]`, `filter:<id>[:<value>...]`: registered HDF5
+   *   filter plugin used instead of deflate, deflate level is the fallback
+   *   if the plugin is not available
+   * - `noshuffle`: do not shuffle bytes of chunked datasets
+   * - `bits:<n>`: round float values to n mantissa bits before compression
+   *   (lossy, particle properties only)
+   */
+  struct CompressionSettings
+  {
+    static constexpr unsigned max_level = 9;
+    static constexpr unsigned lz4_filter = 32004;
+    static constexpr unsigned zstd_filter = 32015;
+
+    unsigned level = max_level;          ///< Deflate level, 0 disables it
+    std::optional<unsigned> filter_id;   ///< HDF5 filter plugin used instead
+    std::vector<unsigned> filter_values; ///< Client data of the plugin
+    bool shuffle = true;                 ///< Shuffle chunked datasets
+    std::optional<unsigned> keep_bits;   ///< Mantissa bits kept, lossy
+
+    /**
+     * @brief Parse comma separated settings
+     * @return nullopt if one of the items is invalid
+     */
+    [[nodiscard]] static std::optional<CompressionSettings>
+    parse(std::string_view list);
+
+    /**
+     * @brief Settings written in the same format as parse
+     */
+    [[nodiscard]] std::string to_string() const;
+  };
+
+  /**
+   * @brief Compression settings of each dataset class, read from
+   * BIOMC_COMPRESSION_FIELDS, BIOMC_COMPRESSION_PARTICLES and
+   * BIOMC_COMPRESSION_PROBES. Unset or invalid variables keep the default
+   * (shuffle and deflate 9), `bits` is invalid for fields and probes which
+   * are never rounded.
+   */
+  class CompressionPolicy
+  {
+  public:
+    static constexpr std::array<std::string_view, n_dataset_class> env_names
+        = { "BIOMC_COMPRESSION_FIELDS",
+            "BIOMC_COMPRESSION_PARTICLES",
+            "BIOMC_COMPRESSION_PROBES" };
+
+    [[nodiscard]] static CompressionPolicy from_env();
+
+    [[nodiscard]] const CompressionSettings&
+    get(DatasetClass dataset_class) const noexcept
+    {
+      return settings[static_cast<std::size_t>(dataset_class)];
+    }
+
+    CompressionSettings&
+    get_mut(DatasetClass dataset_class) noexcept
+    {
+      return settings[static_cast<std::size_t>(dataset_class)];
+    }
+
+  private:
+    std::array<CompressionSettings, n_dataset_class> settings{};
+  };
+
+  /**
+   * @brief Round values to keep_bits mantissa bits (round to nearest, ties to
+   * even). Trailing bits are zeros and compress well, the relative error is
+   * at most 2^-(keep_bits+1). Non finite values are not modified.
+   */
+  void round_mantissa(std::span<double> values, unsigned keep_bits) noexcept;
+
+} // namespace Core
+
+#endif
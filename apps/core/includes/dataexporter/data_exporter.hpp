@@ -7,6 +7,7 @@
 #include <core/simulation_parameters.hpp>
 #include <cstddef>
 #include <cstdint>
+#include <dataexporter/compression_policy.hpp>
 #include <memory>
 #include <optional>
 #include <span>
@@ -114,6 +115,8 @@ namespace Core
           chunk_dims;   ///< Data chunk along each dimension
       bool compression; ///< Matrix data has to be compressed or not
       bool is_integer;  ///< Matrix data is integer type or floating point
+      DatasetClass dataset_class
+          = DatasetClass::Fields; ///< Compression settings used
     };
 
     // Using type definitions with aligned comments
@@ -155,13 +158,15 @@ namespace Core
 
     void write_matrix(std::string_view name,
                       std::span<const double> values,
-                      bool compress = false);
+                      bool compress = false,
+                      DatasetClass dataset_class = DatasetClass::Fields);
 
     void write_matrix(std::string_view name,
                       std::span<const double> values,
                       size_t n_row,
                       size_t n_col,
-                      bool compress = false);
+                      bool compress = false,
+                      DatasetClass dataset_class = DatasetClass::Fields);
 
     void prepare_matrix(MultiMatrixDescription description);
 
@@ -171,6 +176,14 @@ namespace Core
                       std::span<const double> data,
                       uint64_t last_size = 0);
 
+    /**
+     * @brief Write values in elements [offset, offset + values.size()) of a
+     * 1D dataset created with prepare_matrix, the dataset is not resized
+     */
+    void write_slab(std::string_view name,
+                    std::span<const double> values,
+                    std::size_t offset);
+
     void write_properties(std::optional<std::string> specific_dataspace,
                           const export_metadata_kv& values);
 
@@ -181,6 +194,7 @@ namespace Core
 
     export_metadata_kv metadata;
     uint64_t export_counter = 0;
+    CompressionPolicy compression_policy = CompressionPolicy::from_env();
 
     const auto&
     get_descriptor(std::string_view name) const
@@ -3,6 +3,7 @@
 
 #include "simulation/simulation_getter.hpp"
 #include <common/execinfo.hpp>
+#include <common/instrumentation.hpp>
 #include <core/simulation_parameters.hpp>
 #include <cstddef>
 #include <cstdint>
@@ -102,6 +103,8 @@ namespace Core
         base_group_name; /**< Base group name for exported data organization. */
     uint64_t n_expected_export{}; /**< Expected number of exports for tracking
                                      purposes. */
+    Common::InstrumentationMask
+        instrumentation; /**< Runtime enabled instrumentation. */
   };
 
 } // namespace Core
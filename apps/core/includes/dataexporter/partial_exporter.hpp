@@ -2,6 +2,7 @@
 #define __CORE_PARTIAL_EXPORTER_HPP__
 
 #include <common/execinfo.hpp>
+#include <common/instrumentation.hpp>
 #include <core/post_process.hpp>
 #include <cstddef>
 #include <cstdint>
@@ -45,8 +46,12 @@ namespace Core
      *
      * @param n_iter Number of iterations for the simulation or process.
      * @param n_compartments Number of compartments to manage.
+     * @param instrumentation Runtime enabled instrumentation, probe datasets
+     * are only created if probes are enabled.
      */
-    void init_fields(uint64_t n_iter, uint64_t n_compartments);
+    void init_fields(uint64_t n_iter,
+                     uint64_t n_compartments,
+                     Common::InstrumentationMask instrumentation);
 
     /**
      * @brief Writes particle data to the output.
@@ -57,6 +62,23 @@ namespace Core
     void write_particle_data(PostProcessing::BonceBuffer&& bonce,
                              const std::string& ds_name,
                              bool compress_data);
+
+    /**
+     * @brief Writes particle data extracted by chunk from the container,
+     * datasets are the same as write_particle_data.
+     *
+     * Datasets are created with their final size and filled by chunk: the
+     * extraction and device to host copy of a chunk overlap the write of the
+     * previous one.
+     *
+     * @param memory_bound Bytes of the chunk extraction buffer and of the two
+     * host staging buffers
+     */
+    void write_particle_stream(PostProcessing::DeviceBonceBuffer&& bonce,
+                               const std::string& ds_name,
+                               bool compress_data,
+                               std::size_t memory_bound);
+
     /**
      * @brief Writes the number of particles in each compartment.
      *
@@ -83,6 +105,14 @@ namespace Core
     void write_tally(std::span<const std::size_t> data);
 
   private:
+    /**
+     * @brief Writes per compartment statistics of particle variables, one
+     * group per variable
+     */
+    void write_statistics(const PostProcessing::ParticleStatistics& statistics,
+                          const std::string& ds_name,
+                          bool compress_data);
+
     // uint64_t probe_counter_n_element; /**< Counter for the number of probe
     //                                      elements. */
     std::unordered_map<std::string, uint64_t> probe_counter_n_element;
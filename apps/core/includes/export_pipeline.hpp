@@ -0,0 +1,121 @@
+#ifndef __CORE_EXPORT_PIPELINE_HPP__
+#define __CORE_EXPORT_PIPELINE_HPP__
+
+#include <condition_variable>
+#include <core/post_process.hpp>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <impl_post_process.hpp>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Core
+{
+  class PartialExporter;
+
+  /**
+   * @brief Host copy of everything written at one export step.
+   *
+   * Snapshots are recycled by the pipeline, vectors keep their capacity from
+   * one export to the next. Empty optional fields (gas, mtr) are empty
+   * vectors.
+   */
+  struct ExportSnapshot
+  {
+    PartialExporter* partial = nullptr;
+    double time{};
+    std::vector<double> concentration_liquid;
+    std::vector<double> volume_liquid;
+    std::vector<double> concentration_gas;
+    std::vector<double> volume_gas;
+    std::vector<double> mtr;
+    bool with_tally = false;
+    std::vector<std::size_t> tally;
+    std::vector<std::size_t> repartition;
+    std::vector<PostProcessing::ProbeSnapshot> probes;
+    std::optional<std::pair<std::string, PostProcessing::BonceBuffer>>
+        particles;
+  };
+
+  /**
+   * @brief Writes export snapshots from a dedicated I/O thread.
+   *
+   * The simulation thread fills a snapshot taken from a pool of staging
+   * buffers and submits it, the I/O thread compresses and writes it while the
+   * simulation goes on. The simulation only blocks when every buffer is
+   * waiting to be written (two buffers: double buffering).
+   *
+   * HDF5 is not thread safe, exporters given to the writer must not be used
+   * by another thread before flush().
+   */
+  class ExportPipeline
+  {
+  public:
+    using Writer = std::function<void(ExportSnapshot&)>;
+
+    /**
+     * @param n_buffer Number of staging buffers, 0 writes each snapshot in
+     * the calling thread at submit
+     * @param writer Called from the I/O thread on each submitted snapshot
+     */
+    ExportPipeline(std::size_t n_buffer, Writer writer);
+
+    /**
+     * @brief Write pending snapshots and join the I/O thread, errors raised
+     * by the writer are dropped
+     */
+    ~ExportPipeline();
+    ExportPipeline(const ExportPipeline&) = delete;
+    ExportPipeline(ExportPipeline&&) = delete;
+    ExportPipeline& operator=(const ExportPipeline&) = delete;
+    ExportPipeline& operator=(ExportPipeline&&) = delete;
+
+    /**
+     * @brief Number of staging buffers read from BIOMC_EXPORT_QUEUE, 2 if
+     * not set
+     */
+    static std::size_t n_buffer_from_env();
+
+    /**
+     * @brief Free snapshot to fill, blocks while every buffer is queued
+     * @throw Rethrows the first error raised by the writer
+     */
+    ExportSnapshot& acquire();
+
+    /**
+     * @brief Queue snapshot returned by acquire, snapshots are written in
+     * submission order
+     */
+    void submit(ExportSnapshot& snapshot);
+
+    /**
+     * @brief Block until every submitted snapshot is written
+     * @throw Rethrows the first error raised by the writer
+     */
+    void flush();
+
+  private:
+    void run();
+    void rethrow_error();
+
+    Writer writer;
+    std::vector<ExportSnapshot> buffers;
+    std::vector<ExportSnapshot*> free_buffers;
+    std::deque<ExportSnapshot*> queue;
+    bool stop = false;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable free_cv;
+    std::thread worker;
+  };
+
+} // namespace Core
+
+#endif
@@ -4,19 +4,32 @@
 #include <cma_utils/alias.hpp>
 #include <dataexporter/main_exporter.hpp>
 #include <dataexporter/partial_exporter.hpp>
+#include <export_pipeline.hpp>
+#include <memory>
 #include <progress_bar.hpp>
 #include <simulation/simulation_getter.hpp>
 
+namespace WrapMPI
+{
+  class CommandChannel;
+} // namespace WrapMPI
+
 class ExportHandler final
 {
 
 public:
   ExportHandler() = default;
 
+  /**
+   * Staging buffers of the export pipeline are read from BIOMC_EXPORT_QUEUE.
+   *
+   * @param _commands Channel used to send DUMP to workers, null without MPI
+   */
   ExportHandler(std::shared_ptr<Core::MainExporter> _main_exporter,
                 ExecInfo _exec,
                 std::size_t _dump_interval,
-                std::size_t _n_iter_simulation);
+                std::size_t _n_iter_simulation,
+                WrapMPI::CommandChannel* _commands = nullptr);
 
   /**
    * @brief Handles periodic export of simulation data.
@@ -25,6 +38,8 @@ public:
    * simulation state.
    * It updates the main exporter, writes particle counts, and optionally saves
    * data based on compile-time flag.
+   * Data is copied on host and written by the I/O thread of the export
+   * pipeline, partial_exporter must not be used directly before flush().
    *
    * @param current_time The current simulation time.
    * @param loop_counter The current loop iteration counter.
@@ -56,12 +71,20 @@ public:
   void pre_post_export(const Simulation::Getter& getter,
                        const CmaUtils::TransitionnerPtrType& transitioner);
 
+  /**
+   * @brief Wait until periodic exports are written, must be called before
+   * writing to the exporters outside of the handler
+   */
+  void flush();
+
 private:
   size_t dump_counter{};
   size_t dump_interval{};
   size_t n_iter_simulation{};
   [[maybe_unused]] ExecInfo exec{};
   std::shared_ptr<Core::MainExporter> main_exporter;
+  [[maybe_unused]] WrapMPI::CommandChannel* commands = nullptr;
+  std::unique_ptr<Core::ExportPipeline> pipeline;
 
   IO::ProgressBar progressbar;
 };
@@ -4,8 +4,14 @@
 #include "dataexporter/main_exporter.hpp"
 #include "dataexporter/partial_exporter.hpp"
 #include <common/execinfo.hpp>
+#include <core/post_process.hpp>
 #include <core/simulation_parameters.hpp>
+#include <cstddef>
 #include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace IO
 {
@@ -19,6 +25,15 @@ namespace Simulation
 
 namespace PostProcessing
 {
+  /**
+   * @brief Host copy of a probe buffer
+   */
+  struct ProbeSnapshot
+  {
+    std::string name;
+    std::vector<double> values;
+  };
+
   void save_results(const ExecInfo& exec,
                     const Core::SimulationParameters& params,
                     Simulation::SimulationUnit& simulation);
@@ -39,6 +54,28 @@ namespace PostProcessing
                    Core::PartialExporter& pde,
                    bool force = false);
 
+  /**
+   * @brief Copy probes that need export (all if force) to host and clear
+   * them, entries of snapshot are reused
+   */
+  void snapshot_probes(const Simulation::Getter& getter,
+                       std::vector<ProbeSnapshot>& snapshot,
+                       bool force = false);
+
+  /**
+   * @brief Host copy of particle properties and the dataset name they are
+   * written to, advances the counter used by save_particle_state
+   */
+  std::optional<std::pair<std::string, BonceBuffer>>
+  snapshot_particle_state(const Simulation::Getter& getter);
+
+  /**
+   * @brief Host memory bound in bytes of particle dumps streamed from device
+   * by chunk, read once from BIOMC_DUMP_MEMORY_MB. 0 (default, or statistics
+   * dumps) copies whole dumps to host with snapshot_particle_state
+   */
+  std::size_t dump_memory_bound();
+
   void reset_counter();
   // get_particle_properties(unit,
 
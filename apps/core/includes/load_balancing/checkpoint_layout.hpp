@@ -0,0 +1,71 @@
+#ifndef __CHECKPOINT_LAYOUT_HPP__
+#define __CHECKPOINT_LAYOUT_HPP__
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+class ILoadBalancer;
+
+/**
+ * @brief Particles [first, last) of one checkpoint shard
+ */
+struct ShardSlice
+{
+  uint64_t shard;
+  uint64_t first;
+  uint64_t last;
+};
+
+/**
+ * @brief Global particle index of a checkpoint written by any number of
+ * ranks.
+ *
+ * Each rank writes its particles in one shard, the manifest stores the
+ * particle count of each shard. Particles are numbered shard after shard,
+ * a run restarted on another number of ranks splits this global index with
+ * the load balancer and each rank reads the slices of the shards covering
+ * its range.
+ */
+class CheckpointLayout
+{
+public:
+  /**
+   * @param counts Number of particles of each shard
+   */
+  explicit CheckpointLayout(std::span<const uint64_t> counts);
+
+  [[nodiscard]] uint64_t
+  total() const noexcept
+  {
+    return m_offsets.back();
+  }
+
+  [[nodiscard]] uint64_t
+  n_shard() const noexcept
+  {
+    return m_offsets.size() - 1;
+  }
+
+  /**
+   * @brief Global range [begin, end) of rank, ranges of consecutive ranks
+   * are contiguous and cover the whole index
+   */
+  [[nodiscard]] static std::pair<uint64_t, uint64_t>
+  rank_range(ILoadBalancer& balancer,
+             uint32_t rank,
+             uint32_t n_rank,
+             uint64_t total);
+
+  /**
+   * @brief Non empty shard slices covering [begin, end), ordered by shard
+   */
+  [[nodiscard]] std::vector<ShardSlice> slices(uint64_t begin,
+                                               uint64_t end) const;
+
+private:
+  std::vector<uint64_t> m_offsets;
+};
+
+#endif
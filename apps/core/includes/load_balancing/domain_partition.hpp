@@ -0,0 +1,111 @@
+#ifndef __DOMAIN_PARTITION_HPP__
+#define __DOMAIN_PARTITION_HPP__
+
+#include <common/execinfo.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Simulation
+{
+  class SimulationUnit;
+}
+
+/**
+ * @brief Compartments owned by each rank when the domain is decomposed
+ * (BIOMC_DOMAIN_DECOMPOSITION).
+ *
+ * Each rank owns a contiguous range of internal compartments. Internal
+ * numbering is the Reverse Cuthill-McKee ordering of the flowmap graph (or
+ * the flowmap numbering if its bandwidth is already smaller), so that
+ * compartments connected by a flow are in the same range or in close
+ * ranges: cutting the ordered graph in contiguous ranges is the graph
+ * partitioner. Ranges are balanced by compartment volume, the expected share
+ * of particles of a well mixed reactor.
+ *
+ * Particles only live in the compartments of their rank between steps, they
+ * are sent to the owner of their compartment after leaving the range. As
+ * particle processing reads concentrations and writes contributions before
+ * moving particles, a rank only needs the concentrations of its own range
+ * and only contributes to it, there is no halo. Particles move once per
+ * step from an owned compartment, so domain tables (neighbors, transition
+ * probabilities, volumes) are also only kept for the owned rows. Workers
+ * hold concentrations and contributions of their range only, the host keeps
+ * every compartment to integrate scalars.
+ */
+class DomainPartition
+{
+public:
+  /**
+   * @param offsets First compartment of each rank followed by the number of
+   * compartments (size n_rank + 1)
+   * @throw std::invalid_argument if offsets are not increasing from 0
+   */
+  explicit DomainPartition(std::vector<uint64_t> offsets);
+
+  /**
+   * @brief Contiguous ranges with close total weight, each rank gets at least
+   * one compartment
+   * @throw std::invalid_argument if there are fewer compartments than ranks
+   */
+  static DomainPartition balanced(std::span<const double> weights,
+                                  std::size_t n_rank);
+
+  /**
+   * @brief True if BIOMC_DOMAIN_DECOMPOSITION is set, every rank must read
+   * the same value
+   */
+  static bool enabled_from_env();
+
+  [[nodiscard]] uint32_t owner(uint64_t compartment) const noexcept;
+
+  [[nodiscard]] uint64_t
+  begin(std::size_t rank) const noexcept
+  {
+    return m_offsets[rank];
+  }
+
+  [[nodiscard]] uint64_t
+  end(std::size_t rank) const noexcept
+  {
+    return m_offsets[rank + 1];
+  }
+
+  [[nodiscard]] std::size_t
+  n_rank() const noexcept
+  {
+    return m_offsets.size() - 1;
+  }
+
+  [[nodiscard]] const std::vector<uint64_t>&
+  offsets() const noexcept
+  {
+    return m_offsets;
+  }
+
+private:
+  std::vector<uint64_t> m_offsets;
+};
+
+/**
+ * @brief Volume balanced partition of the current domain of simulation,
+ * called once the first flowmap is loaded and before domain tables are
+ * restricted to the owned range. Same result on every rank.
+ */
+DomainPartition make_domain_partition(const ExecInfo& exec,
+                                      Simulation::SimulationUnit& simulation);
+
+/**
+ * @brief Send particles out of the range of the calling rank to the owner of
+ * their compartment and insert particles received from other ranks.
+ * Collective: every rank must call it at the same step, between particle
+ * cycles.
+ *
+ * @return Number of particles sent by the calling rank
+ */
+uint64_t exchange_particles(const ExecInfo& exec,
+                            Simulation::SimulationUnit& simulation,
+                            const DomainPartition& partition);
+
+#endif
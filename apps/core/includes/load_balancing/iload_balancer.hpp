@@ -44,6 +44,10 @@ private:
   uint32_t _size;
 };
 
-std::unique_ptr<ILoadBalancer> lb_factory();
+/**
+ * @brief Balancer of the initial particle split, BoundLoadBalancer if
+ * BIOMC_LBBOUND is set, UniformLoadBalancer otherwise
+ */
+std::unique_ptr<ILoadBalancer> lb_factory(uint32_t s);
 
 #endif
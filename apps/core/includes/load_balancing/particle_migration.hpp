@@ -0,0 +1,130 @@
+#ifndef __PARTICLE_MIGRATION_HPP__
+#define __PARTICLE_MIGRATION_HPP__
+
+#include <common/execinfo.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Simulation
+{
+  class SimulationUnit;
+}
+
+/**
+ * @brief Particles moved from one rank to another
+ */
+struct MigrationTransfer
+{
+  uint32_t from;
+  uint32_t to;
+  uint64_t n;
+};
+
+/**
+ * @brief Runtime rebalancing of particles between ranks.
+ *
+ * ILoadBalancer only splits the initial particle number, rank populations
+ * then drift through division and washout. Each rank records the duration of
+ * its particle cycles and, when rebalancing, particle counts and mean cycle
+ * times are shared so that particles of slow ranks are moved to fast ranks.
+ * Targets equalize predicted cycle times using the measured cost per
+ * particle of each rank.
+ *
+ * Rank 0 also runs the scalar ODE and export, this host work is measured and
+ * added to its predicted step time so that it gets fewer particles, as
+ * HostImportantLoadBalancer does with a user given alpha. With a calibration
+ * window, the split is computed from the first steps and computed again
+ * after each flowmap change.
+ *
+ * To avoid thrashing, nothing is moved while the slowest rank is less than
+ * `trigger` slower than the mean and ranks within `tolerance` of their
+ * target neither send nor receive.
+ */
+class ParticleMigration
+{
+public:
+  struct Parameters
+  {
+    uint64_t interval;    ///< Steps between rebalancing, 0 disables it
+    double trigger;       ///< Relative imbalance that starts migration
+    double tolerance;     ///< Relative dead band around target
+    uint64_t calibration; ///< Steps measured before split, 0 disables it
+    uint64_t export_interval; ///< Steps between exports, calibration window
+                              ///< covers at least one (host only)
+  };
+
+  explicit ParticleMigration(Parameters _params) noexcept;
+
+  /**
+   * @brief Parameters from BIOMC_MIGRATION_INTERVAL (default 0, disabled),
+   * BIOMC_MIGRATION_TRIGGER, BIOMC_MIGRATION_TOLERANCE and
+   * BIOMC_LB_CALIBRATION (default 0, disabled)
+   */
+  static Parameters parameters_from_env();
+
+  /**
+   * @brief Add the duration of one particle cycle
+   */
+  void record_cycle(double seconds) noexcept;
+
+  /**
+   * @brief Add the duration of work done besides particles (scalar ODE,
+   * export), only on host
+   */
+  void record_host_work(double seconds) noexcept;
+
+  /**
+   * @brief Measure again and rebalance after the calibration window, called
+   * on every rank when the cost of a step changes (new flowmap) so that all
+   * ranks share the same window. Does nothing if calibration is disabled or
+   * already pending.
+   */
+  void recalibrate() noexcept;
+
+  /**
+   * @brief True once interval cycles have been recorded since last
+   * rebalancing or once the calibration window is measured
+   */
+  [[nodiscard]] bool due() const noexcept;
+
+  /**
+   * @brief Transfers minimizing the largest predicted step time
+   *
+   * Step time of rank i is counts[i] * cost[i] + overheads[i], with cost the
+   * measured cycle time per particle. Senders only send and receivers only
+   * receive, transfers are ordered by sender then receiver rank.
+   *
+   * @param counts Number of particles per rank
+   * @param times Mean cycle time per rank, non positive if not measured
+   * @param overheads Mean time per step spent out of particle cycle, empty if
+   * not measured
+   */
+  [[nodiscard]] static std::vector<MigrationTransfer>
+  plan(std::span<const uint64_t> counts,
+       std::span<const double> times,
+       double trigger,
+       double tolerance,
+       std::span<const double> overheads = {});
+
+  /**
+   * @brief Share counts and cycle times then move particles following
+   * `plan`. Collective: every rank must call it at the same step, between
+   * particle cycles. Recorded times are reset.
+   *
+   * @return Number of particles sent or received by the calling rank
+   */
+  uint64_t rebalance(const ExecInfo& exec,
+                     Simulation::SimulationUnit& simulation);
+
+private:
+  [[nodiscard]] uint64_t calibration_window() const noexcept;
+
+  Parameters params;
+  double cycle_time = 0.;
+  double host_work = 0.;
+  uint64_t n_cycle = 0;
+  bool calibrating;
+};
+
+#endif
@@ -9,10 +9,27 @@
 #ifdef USE_CEAREAL
 namespace SerDe
 {
+  /**
+   * @brief Write the shard of the calling rank (`_serde_<rank>.raw`) and, on
+   * rank 0, the manifest (`_serde_manifest.raw`) with the particle count of
+   * every shard, scalars, reduced contributions and random seed.
+   * Collective.
+   */
   void save_simulation(const Core::CaseData& case_data);
   bool load_simulation(Core::GlobalInitialiser& gi,
                        Core::CaseData& case_data,
                        std::string_view ser_filename);
+
+  /**
+   * @brief Restart from the checkpoint whose files start with prefix.
+   *
+   * With a manifest, particles are split between the current ranks with the
+   * load balancer whatever the number of ranks which wrote the checkpoint.
+   * Without manifest, each rank reads its own shard (same rank count only).
+   */
+  bool load_checkpoint(Core::GlobalInitialiser& gi,
+                       Core::CaseData& case_data,
+                       std::string_view prefix);
 } // namespace SerDe
 
 #endif // USE_CEAREAL
@@ -56,13 +73,12 @@ impl_load(std::shared_ptr<IO::Logger>& logger,
     {
       return std::nullopt;
     }
-    std::string serde_filename
-        = *params.serde_file + std::to_string(exec.current_rank) + ".raw";
     if (logger)
     {
-      logger->print("Serde", serde_filename);
+      logger->print("Serde", *params.serde_file);
     }
-    const bool ok_init = SerDe::load_simulation(gi, case_data, serde_filename);
+    const bool ok_init
+        = SerDe::load_checkpoint(gi, case_data, *params.serde_file);
 
     if (!gi.check_init_terminate() || !ok_init)
     {
@@ -9,24 +9,133 @@ namespace Simulation
 }
 
 #ifndef NO_MPI
+#  include <memory>
 #  include <mpi_w/wrap_mpi.hpp>
 #else
 using MPI_Request = int;
+namespace WrapMPI
+{
+  class CompressedExchange;
+  class NodeSharedMemory;
+  class PartitionedExchange;
+  class SharedBroadcast;
+} // namespace WrapMPI
+#endif
+
+/**
+ * @brief Alternatives to the exact collectives used for contributions and
+ * concentrations, all null by default. The partitioned exchange has
+ * priority over the others, the node shared broadcast has priority over
+ * compression for concentrations. tables holds the domain tables shared by
+ * the workers of a node.
+ */
+struct SyncExchange
+{
+  WrapMPI::CompressedExchange* compression = nullptr;
+  WrapMPI::PartitionedExchange* partition = nullptr;
+  WrapMPI::SharedBroadcast* shared = nullptr;
+  WrapMPI::NodeSharedMemory* tables = nullptr;
+};
+
+#ifndef NO_MPI
+/**
+ * @brief Reduced volume exchange selected by BIOMC_MPI_COMPRESSION: 0 (or
+ * unset) keeps the exact collectives and returns nullptr, 1 sends sparse or
+ * dense exact contributions, 2 also allows float32 contributions and
+ * concentration deltas.
+ *
+ * Every rank must read the same value.
+ */
+std::unique_ptr<WrapMPI::CompressedExchange>
+make_sync_compression(Simulation::SimulationUnit& simulation);
+
+/**
+ * @brief Concentration broadcast through node leaders and a node shared
+ * window if BIOMC_MPI_SHARED_MEMORY is set, nullptr otherwise.
+ *
+ * When concentrations are in host memory
+ * (`SimulationUnit::host_aliases_device`), ranks other than the host read
+ * and write concentrations in place in the window: it must be called
+ * before `init_functors`. Otherwise each rank copies the window in its own
+ * concentrations.
+ *
+ * Collective: every rank must call it at the same point and read the same
+ * value.
+ */
+std::unique_ptr<WrapMPI::SharedBroadcast>
+make_sync_shared(Simulation::SimulationUnit& simulation);
+
+/**
+ * @brief Domain tables shared by the workers of a node if
+ * BIOMC_MPI_SHARED_MEMORY is set and domain tables are in host memory,
+ * nullptr otherwise or with BIOMC_DOMAIN_DECOMPOSITION. The host keeps its
+ * own tables.
+ *
+ * Collective: every rank must call it at the same point and read the same
+ * value.
+ */
+std::unique_ptr<WrapMPI::NodeSharedMemory> make_sync_tables();
+
+/**
+ * @brief Hydro update of a worker from payload. With shared tables, the
+ * lowest worker of each node writes the tables of the node while the others
+ * wait, every worker must call it.
+ */
+void sync_update_hydro(Simulation::SimulationUnit& simulation,
+                       WrapMPI::IterationPayload& payload,
+                       const SyncExchange& exchange);
 #endif
 
+/**
+ * @brief Start the reduction of particle contributions to the host rank.
+ *
+ * Called right after particle processing. The reduction is nonblocking so
+ * that ranks can go on with work independent from contributions (hydro
+ * update, probes, events and export) until `sync_step`. With MPI >= 4 the
+ * request is persistent and reused from one step to the next, it must be
+ * initialised to MPI_REQUEST_NULL and released with `sync_release`.
+ *
+ * @param exec The `ExecInfo` object containing details about the execution
+ * environment.
+ * @param simulation The `Simulation::SimulationUnit` object whose
+ * contributions are reduced.
+ * @param request Reduction request, kept between calls.
+ * @param exchange Compressed or partitioned exchange, both null for the
+ * exact collective reduction.
+ */
+void sync_contributions_start(const ExecInfo& exec,
+                              Simulation::SimulationUnit& simulation,
+                              MPI_Request* request,
+                              const SyncExchange& exchange);
+
 /**
  * @brief Synchronization after particle processing.
  *
- * This function performs synchronization operations for the simulation. It
- * ensures every computing unit is synchronized before going forward in time
- * step
+ * Completes the contribution reduction started by `sync_contributions_start`,
+ * after this call the host holds the contributions of every rank. Does
+ * nothing if no reduction is pending.
  *
  * @param exec The `ExecInfo` object containing details about the execution
  * environment.
  * @param simulation The `Simulation::SimulationUnit` object representing the
  * simulation to be synchronized.
+ * @param request Reduction request given to `sync_contributions_start`.
+ * @param exchange Exchange given to `sync_contributions_start`.
  */
-void sync_step(const ExecInfo& exec, Simulation::SimulationUnit& simulation);
+void sync_step(const ExecInfo& exec,
+               Simulation::SimulationUnit& simulation,
+               MPI_Request* request,
+               const SyncExchange& exchange);
+
+/**
+ * @brief Complete and free the contribution reduction request at the end of
+ * the time loop. Concentrations and domain tables read in place are copied
+ * to the simulation before node shared windows are released, every rank
+ * must call it.
+ */
+void sync_release(Simulation::SimulationUnit& simulation,
+                  MPI_Request* request,
+                  const SyncExchange& exchange);
 
 /**
  * @brief Synchronizes and resets simulation state for the next time step.
@@ -42,7 +151,18 @@ void sync_step(const ExecInfo& exec, Simulation::SimulationUnit& simulation);
  */
 void sync_prepare_next(const ExecInfo& exec,
                        Simulation::SimulationUnit& simulation,
-                       MPI_Request* request);
+                       MPI_Request* request,
+                       const SyncExchange& exchange);
+
+/**
+ * @brief Complete the concentration broadcast started by
+ * `sync_prepare_next`, concentrations are then the same on every rank.
+ * Called by every rank, host included, once per `sync_prepare_next`.
+ */
+void sync_wait_next(const ExecInfo& exec,
+                    Simulation::SimulationUnit& simulation,
+                    MPI_Request* request,
+                    const SyncExchange& exchange);
 
 /**
  * @brief Final synchronization before exporting results.
@@ -0,0 +1,308 @@
+#ifndef __CORE_PARTICLE_STATISTICS_HPP__
+#define __CORE_PARTICLE_STATISTICS_HPP__
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_ScatterView.hpp>
+#include <array>
+#include <common/common.hpp>
+#include <cstddef>
+#include <limits>
+#include <mc/alias.hpp>
+#include <mc/particles_container.hpp>
+#include <mc/traits.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace PostProcessing
+{
+  template <typename MemorySpace>
+  using StatisticsViewType
+      = Kokkos::View<double**, Kokkos::LayoutRight, MemorySpace>;
+
+  /**
+   * @brief Particle dumps reduced on device to per compartment statistics
+   * instead of raw particle values, read once from BIOMC_DUMP_STATS and
+   * BIOMC_DUMP_STATS_BINS
+   */
+  struct StatisticsParameters
+  {
+    bool enabled = false;
+    std::size_t n_bins = 32; ///< Histogram bins, 0 only computes moments
+
+    static const StatisticsParameters& from_env();
+  };
+
+  /**
+   * @brief Per compartment statistics of the exported particle variables
+   * (model properties, mass and ages), host copy.
+   *
+   * Variables are rows, compartments are columns. Histograms and quantiles
+   * hold n_bins (quantile_levels.size()) consecutive values per compartment.
+   * Histograms of a variable share bin_edges, from its min to its max over
+   * the particles of the rank. Quantiles are interpolated in the histogram,
+   * their error is at most one bin width. Empty compartments have NaN
+   * moments.
+   */
+  struct ParticleStatistics
+  {
+    static constexpr std::array<double, 5> quantile_levels
+        = { 0.05, 0.25, 0.5, 0.75, 0.95 };
+
+    std::vector<std::string> names;
+    std::size_t n_compartment{};
+    std::size_t n_bins{};
+    StatisticsViewType<HostSpace> count;     ///< (1, n_compartment)
+    StatisticsViewType<HostSpace> mean;      ///< (n_var, n_compartment)
+    StatisticsViewType<HostSpace> variance;  ///< (n_var, n_compartment)
+    StatisticsViewType<HostSpace> min;       ///< (n_var, n_compartment)
+    StatisticsViewType<HostSpace> max;       ///< (n_var, n_compartment)
+    StatisticsViewType<HostSpace> bin_edges; ///< (n_var, n_bins + 1)
+    StatisticsViewType<HostSpace> histogram; ///< (n_var, n_compartment*n_bins)
+    StatisticsViewType<HostSpace> quantiles; ///< (n_var, n_compartment*n_q)
+
+    [[nodiscard]] std::size_t
+    n_var() const noexcept
+    {
+      return names.size();
+    }
+  };
+
+  /**
+   * @brief Turn sums of the first pass (count, mean holding sums, min, max)
+   * into means and set bin edges of every variable
+   */
+  void prepare_histograms(ParticleStatistics& statistics);
+
+  /**
+   * @brief Turn sums of squared deviations of the second pass (variance) into
+   * variances, compute quantiles and mark empty compartments
+   */
+  void finalize_statistics(ParticleStatistics& statistics);
+
+  namespace
+  {
+    template <typename Op>
+    using StatisticsScatterView = Kokkos::Experimental::
+        ScatterView<double**, Kokkos::LayoutRight, ComputeSpace, Op>;
+
+    /**
+     * @brief Value of exported variable k of a particle: model properties,
+     * mass then ages
+     */
+    template <typename Model> struct StatisticsValue
+    {
+      typename Model::SelfParticle model;
+      MC::ParticleAges ages;
+      Kokkos::View<const std::size_t*, ComputeSpace> kindices;
+      std::size_t n_property{};
+
+      KOKKOS_INLINE_FUNCTION double
+      operator()(const std::size_t i_particle, std::size_t k_var) const
+      {
+        if constexpr (HasExportProperties<Model>)
+        {
+          if (k_var < n_property)
+          {
+            if constexpr (HasExportPropertiesPartial<Model>)
+            {
+              return model(i_particle, kindices(k_var));
+            }
+            else
+            {
+              return model(i_particle, k_var);
+            }
+          }
+          if (k_var == n_property)
+          {
+            return Model::mass(i_particle, model);
+          }
+          k_var -= n_property + 1;
+        }
+        return ages(i_particle, k_var);
+      }
+    };
+
+    template <typename Model>
+    StatisticsValue<Model>
+    make_statistics_value(MC::ParticlesContainer<Model>& container,
+                          std::vector<std::string>& names,
+                          const bool with_age)
+    {
+      StatisticsValue<Model> value{ .model = container.model,
+                                    .ages = container.ages };
+      if constexpr (HasExportProperties<Model>)
+      {
+        const auto ar = Model::names();
+        names.assign(ar.begin(), ar.end());
+        value.n_property = names.size();
+        names.emplace_back("mass");
+        if constexpr (HasExportPropertiesPartial<Model>)
+        {
+          static const auto indices = Model::get_number();
+          Kokkos::View<std::size_t*, HostSpace> host_index("host_index",
+                                                           indices.size());
+          for (std::size_t i = 0; i < indices.size(); ++i)
+          {
+            host_index(i) = indices[i];
+          }
+          value.kindices
+              = Kokkos::create_mirror_view_and_copy(ComputeSpace(), host_index);
+        }
+        else
+        {
+          value.n_property = Model::n_var;
+        }
+      }
+      if (with_age)
+      {
+        names.emplace_back("age_hydro");
+        names.emplace_back("age");
+      }
+      return value;
+    }
+  } // namespace
+
+  /**
+   * @brief Per compartment statistics of the idle particles of container,
+   * reduced on device in two passes (count, sums and extrema, then squared
+   * deviations and histograms). Only statistics are copied to host.
+   *
+   * @return nullopt if the model exports no variable
+   */
+  template <ModelType M>
+  std::optional<ParticleStatistics>
+  get_statistics(MC::ParticlesContainer<M>& container,
+                 const std::size_t n_compartment,
+                 const std::size_t n_bins,
+                 const bool with_age)
+  {
+    using Kokkos::Experimental::ScatterMax;
+    using Kokkos::Experimental::ScatterMin;
+    using Kokkos::Experimental::ScatterSum;
+
+    ParticleStatistics statistics;
+    const auto value
+        = make_statistics_value(container, statistics.names, with_age);
+    const std::size_t n_var = statistics.n_var();
+    if (n_var == 0)
+    {
+      return std::nullopt;
+    }
+    container.force_remove_dead();
+    // USE list size not Kokkos View size
+    const std::size_t n_p = container.n_particles();
+    statistics.n_compartment = n_compartment;
+    statistics.n_bins = n_bins;
+
+    const auto position = container.position;
+    const auto status = container.status;
+    const auto policy = Kokkos::RangePolicy<ComputeSpace>(0, n_p);
+
+    // First pass: count, sums and extrema
+    StatisticsViewType<ComputeSpace> count(
+        "statistics_count", 1, n_compartment);
+    StatisticsViewType<ComputeSpace> sum(
+        "statistics_sum", n_var, n_compartment);
+    StatisticsViewType<ComputeSpace> minimum(
+        "statistics_min", n_var, n_compartment);
+    StatisticsViewType<ComputeSpace> maximum(
+        "statistics_max", n_var, n_compartment);
+    Kokkos::deep_copy(minimum, std::numeric_limits<double>::max());
+    Kokkos::deep_copy(maximum, std::numeric_limits<double>::lowest());
+    {
+      StatisticsScatterView<ScatterSum> s_count(count);
+      StatisticsScatterView<ScatterSum> s_sum(sum);
+      StatisticsScatterView<ScatterMin> s_min(minimum);
+      StatisticsScatterView<ScatterMax> s_max(maximum);
+      Kokkos::parallel_for(
+          "statistics_moments",
+          policy,
+          KOKKOS_LAMBDA(const std::size_t i_particle) {
+            if (status(i_particle) != MC::Status::Idle)
+            {
+              return;
+            }
+            const auto i_compartment = position(i_particle);
+            auto a_sum = s_sum.access();
+            auto a_min = s_min.access();
+            auto a_max = s_max.access();
+            s_count.access()(0, i_compartment) += 1.;
+            for (std::size_t k_var = 0; k_var < n_var; ++k_var)
+            {
+              const double current = value(i_particle, k_var);
+              a_sum(k_var, i_compartment) += current;
+              a_min(k_var, i_compartment).update(current);
+              a_max(k_var, i_compartment).update(current);
+            }
+          });
+      Kokkos::Experimental::contribute(count, s_count);
+      Kokkos::Experimental::contribute(sum, s_sum);
+      Kokkos::Experimental::contribute(minimum, s_min);
+      Kokkos::Experimental::contribute(maximum, s_max);
+    }
+
+    const auto to_host = [](const auto& view)
+    { return Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), view); };
+    statistics.count = to_host(count);
+    statistics.mean = to_host(sum);
+    statistics.min = to_host(minimum);
+    statistics.max = to_host(maximum);
+    prepare_histograms(statistics);
+
+    // Second pass: squared deviations and histograms
+    const auto mean
+        = Kokkos::create_mirror_view_and_copy(ComputeSpace(), statistics.mean);
+    const auto edges = Kokkos::create_mirror_view_and_copy(
+        ComputeSpace(), statistics.bin_edges);
+    StatisticsViewType<ComputeSpace> squares(
+        "statistics_squares", n_var, n_compartment);
+    StatisticsViewType<ComputeSpace> histogram(
+        "statistics_histogram", n_var, n_compartment * n_bins);
+    {
+      StatisticsScatterView<ScatterSum> s_squares(squares);
+      StatisticsScatterView<ScatterSum> s_histogram(histogram);
+      Kokkos::parallel_for(
+          "statistics_histograms",
+          policy,
+          KOKKOS_LAMBDA(const std::size_t i_particle) {
+            if (status(i_particle) != MC::Status::Idle)
+            {
+              return;
+            }
+            const auto i_compartment = position(i_particle);
+            auto a_squares = s_squares.access();
+            auto a_histogram = s_histogram.access();
+            for (std::size_t k_var = 0; k_var < n_var; ++k_var)
+            {
+              const double current = value(i_particle, k_var);
+              const double deviation = current - mean(k_var, i_compartment);
+              a_squares(k_var, i_compartment) += deviation * deviation;
+              if (n_bins == 0)
+              {
+                continue;
+              }
+              const double lower = edges(k_var, 0);
+              const double width = edges(k_var, 1) - lower;
+              std::size_t bin = 0;
+              if (width > 0)
+              {
+                bin = Kokkos::min(
+                    static_cast<std::size_t>((current - lower) / width),
+                    n_bins - 1);
+              }
+              a_histogram(k_var, i_compartment * n_bins + bin) += 1.;
+            }
+          });
+      Kokkos::Experimental::contribute(squares, s_squares);
+      Kokkos::Experimental::contribute(histogram, s_histogram);
+    }
+    statistics.variance = to_host(squares);
+    statistics.histogram = to_host(histogram);
+    finalize_statistics(statistics);
+    return statistics;
+  }
+
+} // namespace PostProcessing
+
+#endif
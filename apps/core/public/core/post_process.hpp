@@ -5,6 +5,8 @@
 #include <Kokkos_Macros.hpp>
 #include <Kokkos_ScatterView.hpp>
 #include <common/common.hpp>
+#include <core/particle_statistics.hpp>
+#include <functional>
 #include <mc/alias.hpp>
 #include <mc/particles_container.hpp>
 #include <mc/traits.hpp>
@@ -25,6 +27,29 @@ namespace PostProcessing
     std::optional<ParticlePropertyViewType<HostSpace>> spatial_values;
     std::optional<ParticlePropertyViewType<HostSpace>> ages;
     std::optional<std::vector<std::string>> vnames;
+    std::optional<ParticleStatistics> statistics; ///< Instead of raw values
+  };
+
+  /**
+   * @brief Particle properties and ages extracted by chunk when written, no
+   * per particle view is allocated. Spatial values are small and reduced
+   * once to host.
+   */
+  struct DeviceBonceBuffer
+  {
+    /// Writes the rows of particles [begin, end) to the columns
+    /// [0, end - begin) of chunk, asynchronously on the given instance
+    using ChunkFill
+        = std::function<void(const ComputeSpace&,
+                             std::size_t,
+                             std::size_t,
+                             const ParticlePropertyViewType<ComputeSpace>&)>;
+
+    std::size_t n_particles{};
+    bool with_age{}; ///< First two rows are ages (hydro, total)
+    std::optional<ParticlePropertyViewType<HostSpace>> spatial_values;
+    std::optional<std::vector<std::string>> vnames; ///< Next rows
+    ChunkFill fill;
   };
 
   namespace
@@ -50,10 +75,44 @@ namespace PostProcessing
       {
       }
 
+      struct TagSpatial
+      {
+      };
+      struct TagChunk
+      {
+      };
+
+      KOKKOS_INLINE_FUNCTION
+      std::size_t
+      n_exported() const
+      {
+        if constexpr (HasExportPropertiesPartial<Model>)
+        {
+          return kindices.extent(0);
+        }
+        else
+        {
+          return Model::n_var;
+        }
+      }
+
+      KOKKOS_INLINE_FUNCTION
+      double
+      exported(const std::size_t i_particle, const std::size_t k_var) const
+      {
+        if constexpr (HasExportPropertiesPartial<Model>)
+        {
+          return model(i_particle, kindices(k_var));
+        }
+        else
+        {
+          return model(i_particle, k_var);
+        }
+      }
+
       KOKKOS_INLINE_FUNCTION
       void
       operator()(const int i_particle) const
-        requires(HasExportPropertiesFull<Model>)
       {
         if (status(i_particle) != MC::Status::Idle)
         {
@@ -61,24 +120,24 @@ namespace PostProcessing
         }
 
         auto access = scatter_spatial_values.access();
-        for (size_t k_var = 0; k_var < Model::n_var; ++k_var)
+        const std::size_t n_value = n_exported();
+        for (size_t k_var = 0; k_var < n_value; ++k_var)
         {
-          const auto current = model(i_particle, k_var);
+          const auto current = exported(i_particle, k_var);
           access(k_var, position(i_particle)) += current;
           particle_values(k_var, i_particle) = current;
         }
 
         const auto mass = Model::mass(i_particle, model);
-        access(Model::n_var, position(i_particle)) += mass;
-        particle_values(Model::n_var, i_particle) = mass;
+        access(n_value, position(i_particle)) += mass;
+        particle_values(n_value, i_particle) = mass;
         ages_value(0, i_particle) = ages(i_particle, 0);
         ages_value(1, i_particle) = ages(i_particle, 1);
       }
 
       KOKKOS_INLINE_FUNCTION
       void
-      operator()(const int i_particle) const
-        requires(HasExportPropertiesPartial<Model>)
+      operator()(TagSpatial /*tag*/, const int i_particle) const
       {
         if (status(i_particle) != MC::Status::Idle)
         {
@@ -86,27 +145,40 @@ namespace PostProcessing
         }
 
         auto access = scatter_spatial_values.access();
-        for (size_t k_var = 0; k_var < kindices.extent(0); ++k_var)
+        const std::size_t n_value = n_exported();
+        for (size_t k_var = 0; k_var < n_value; ++k_var)
         {
-          const auto current = model(i_particle, kindices(k_var));
-          access(k_var, position(i_particle)) += current;
-          particle_values(k_var, i_particle) = current;
+          access(k_var, position(i_particle)) += exported(i_particle, k_var);
         }
-
-        const auto mass = Model::mass(i_particle, model);
-        access(kindices.extent(0), position(i_particle)) += mass;
-        particle_values(kindices.extent(0), i_particle) = mass;
-        ages_value(0, i_particle) = ages(i_particle, 0);
-        ages_value(1, i_particle) = ages(i_particle, 1);
+        access(n_value, position(i_particle))
+            += Model::mass(i_particle, model);
       }
 
+      // Column i of the chunk is particle first + i, values of non idle
+      // particles are zero as in the full views
+      KOKKOS_INLINE_FUNCTION
       void
-      run()
+      operator()(TagChunk /*tag*/, const int i) const
       {
+        const std::size_t i_particle = first + i;
+        const bool idle = status(i_particle) == MC::Status::Idle;
+        const std::size_t n_value = n_exported();
+        for (size_t k_var = 0; k_var < n_value; ++k_var)
+        {
+          particle_values(k_var, i) = idle ? exported(i_particle, k_var) : 0.;
+        }
+        particle_values(n_value, i)
+            = idle ? static_cast<double>(Model::mass(i_particle, model)) : 0.;
+        if (ages_value.extent(0) != 0)
+        {
+          ages_value(0, i) = idle ? ages(i_particle, 0) : 0.;
+          ages_value(1, i) = idle ? ages(i_particle, 1) : 0.;
+        }
+      }
 
-        scatter_spatial_values
-            = Kokkos::Experimental::create_scatter_view(spatial_values);
-
+      void
+      load_indices()
+      {
         // Use kindices for partial to map with correct vector position
         // Warning UB  if len(kindex)!=len(vnames)
         if constexpr (HasExportPropertiesPartial<Model>)
@@ -122,6 +194,15 @@ namespace PostProcessing
           kindices
               = Kokkos::create_mirror_view_and_copy(ComputeSpace(), host_index);
         }
+      }
+
+      void
+      run()
+      {
+
+        scatter_spatial_values
+            = Kokkos::Experimental::create_scatter_view(spatial_values);
+        load_indices();
 
         Kokkos::parallel_for("get_properties",
                              Kokkos::RangePolicy<ExecutionSpace>(0, n_p),
@@ -132,6 +213,40 @@ namespace PostProcessing
                                          scatter_spatial_values);
       }
 
+      /// Spatial sums only, particle values are left to run_chunk
+      void
+      run_spatial()
+      {
+        scatter_spatial_values
+            = Kokkos::Experimental::create_scatter_view(spatial_values);
+        load_indices();
+
+        Kokkos::parallel_for(
+            "get_spatial_properties",
+            Kokkos::RangePolicy<ExecutionSpace, TagSpatial>(0, n_p),
+            *this);
+
+        Kokkos::fence();
+        Kokkos::Experimental::contribute(spatial_values,
+                                         scatter_spatial_values);
+        scatter_spatial_values = {};
+      }
+
+      /// Values of particles [begin, end) to particle_values and ages_value
+      /// (rows of a chunk), asynchronously on exec. run_spatial loads kindices
+      void
+      run_chunk(const ExecutionSpace& exec,
+                const std::size_t begin,
+                const std::size_t end) const
+      {
+        auto chunk = *this;
+        chunk.first = begin;
+        Kokkos::parallel_for(
+            "get_chunk_properties",
+            Kokkos::RangePolicy<ExecutionSpace, TagChunk>(exec, 0, end - begin),
+            chunk);
+      }
+
       std::size_t n_p;
       MC::ParticlePositions position;
       typename Model::SelfParticle model;
@@ -141,6 +256,7 @@ namespace PostProcessing
       ParticlePropertyViewType<ComputeSpace> ages_value;
       MC::ParticleStatus status;
       Kokkos::View<const size_t*, ComputeSpace> kindices;
+      std::size_t first{};
       Kokkos::Experimental::
           ScatterView<double**, Kokkos::LayoutRight, ComputeSpace>
               scatter_spatial_values;
@@ -168,6 +284,115 @@ namespace PostProcessing
     return ages_values;
   }
 
+  /**
+   * @brief Writes ages of particles [begin, end) to the two rows of chunk
+   */
+  inline void
+  get_chunk_ages(const ComputeSpace& exec,
+                 const MC::ParticleAges& ages,
+                 const std::size_t begin,
+                 const std::size_t end,
+                 const ParticlePropertyViewType<ComputeSpace>& chunk)
+  {
+    Kokkos::parallel_for(
+        "get_chunk_ages",
+        Kokkos::RangePolicy<ComputeSpace>(exec, 0, end - begin),
+        KOKKOS_LAMBDA(const std::size_t i) {
+          chunk(0, i) = ages(begin + i, 0);
+          chunk(1, i) = ages(begin + i, 1);
+        });
+  }
+
+  template <ModelType M>
+  std::vector<std::string>
+  get_export_names()
+  {
+    auto ar = M::names();
+    if constexpr (HasExportPropertiesPartial<M>)
+    {
+      if (ar.size() != M::get_number().size())
+      {
+        throw std::invalid_argument("Partial export Model need to have same "
+                                    "number of name and indices");
+      }
+    }
+    std::vector<std::string> names(ar.begin(), ar.end());
+    names.emplace_back("mass");
+    return names;
+  }
+
+  /**
+   * @brief Properties written by chunk: only spatial sums are reduced here,
+   * particle values are extracted from the container when each chunk is
+   * written so that no full length view is allocated.
+   */
+  template <ModelType M>
+  std::optional<DeviceBonceBuffer>
+  get_stream_properties(MC::ParticlesContainer<M>& container,
+                        const std::size_t n_compartment,
+                        const bool with_age)
+  {
+    using ChunkView = ParticlePropertyViewType<ComputeSpace>;
+    if constexpr (HasExportProperties<M>)
+    {
+      container.force_remove_dead();
+      DeviceBonceBuffer properties;
+      properties.n_particles = container.n_particles();
+      properties.with_age = with_age;
+      properties.vnames = get_export_names<M>();
+      const std::size_t n_var = properties.vnames->size();
+
+      ParticlePropertyViewType<ComputeSpace> spatial_values(
+          "property_spatial", n_var, n_compartment);
+
+      GetPropertiesFunctor<M, ComputeSpace> functor(properties.n_particles,
+                                                    container.position,
+                                                    container.model,
+                                                    container.ages,
+                                                    {},
+                                                    spatial_values,
+                                                    {},
+                                                    container.status);
+      functor.run_spatial();
+      properties.spatial_values = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace(), spatial_values);
+
+      const std::size_t n_age = with_age ? 2 : 0;
+      properties.fill = [functor, n_age, n_var](const ComputeSpace& exec,
+                                                const std::size_t begin,
+                                                const std::size_t end,
+                                                const ChunkView& chunk)
+      {
+        auto rows = functor;
+        if (n_age != 0)
+        {
+          rows.ages_value = Kokkos::subview(
+              chunk, std::make_pair(std::size_t{ 0 }, n_age), Kokkos::ALL);
+        }
+        rows.particle_values = Kokkos::subview(
+            chunk, std::make_pair(n_age, n_age + n_var), Kokkos::ALL);
+        rows.run_chunk(exec, begin, end);
+      };
+      return properties;
+    }
+    else
+    {
+      if (with_age)
+      {
+        DeviceBonceBuffer properties;
+        properties.n_particles = container.n_particles();
+        properties.with_age = true;
+        properties.fill = [ages = container.ages](const ComputeSpace& exec,
+                                                  const std::size_t begin,
+                                                  const std::size_t end,
+                                                  const ChunkView& chunk)
+        { get_chunk_ages(exec, ages, begin, end, chunk); };
+        return properties;
+      }
+      return std::nullopt;
+    }
+  }
+
   template <ModelType M>
   std::optional<PostProcessing::BonceBuffer>
   get_properties(MC::ParticlesContainer<M>& container,
@@ -183,20 +408,8 @@ namespace PostProcessing
           = container.n_particles(); // USE list size not Kokkos View size.
                                      // bcause container allocates more
                                      // particles than needed
-      auto ar = M::names();
-      properties.vnames = std::vector<std::string>(ar.begin(), ar.end());
-      properties.vnames->emplace_back("mass");
-
-      std::size_t n_var = M::n_var + 1;
-      if constexpr (HasExportPropertiesPartial<M>)
-      {
-        n_var = ar.size() + 1;
-        if (ar.size() != M::get_number().size())
-        {
-          throw std::invalid_argument("Partial export Model need to have same "
-                                      "number of name and indices");
-        }
-      }
+      properties.vnames = get_export_names<M>();
+      const std::size_t n_var = properties.vnames->size();
 
       ParticlePropertyViewType<ComputeSpace> spatial_values(
           "property_spatial", n_var, n_compartment);
@@ -226,9 +439,6 @@ namespace PostProcessing
 
       if (with_age)
       {
-        // ParticlePropertyViewType<ComputeSpace> ages_values(
-        //     "ages_values", 2, n_p);
-
         properties.ages = Kokkos::create_mirror_view_and_copy(
             Kokkos::HostSpace(), ages_values);
       }
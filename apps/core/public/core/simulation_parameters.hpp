@@ -41,6 +41,8 @@ namespace Core
     std::string cma_case_path; ///< Path to the CMA case file.
     std::optional<std::string>
         serde_file; ///< Optional file path for serialized data.
+    std::optional<std::string>
+        instrumentation; ///< Optional instrumentation list, overrides env.
 
     /**
      * @brief Provides default settings for the UserControlParameters structure.
@@ -1,12 +1,18 @@
 #include "simulation/simulation_exception.hpp"
 #include <Kokkos_Core.hpp>
+#include <algorithm>
 #include <biocma_cst_config.hpp>
 #include <bit>
+#include <cctype>
+#include <common/env_var.hpp>
 #include <common/execinfo.hpp>
 #include <common/logger.hpp>
 #include <core/case_data.hpp>
 #include <core/global_initaliser.hpp>
 #include <core/simulation_parameters.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <host_specific.hpp>
 #include <impl_post_process.hpp>
 #include <ios>
@@ -19,19 +25,169 @@
 #include <simulation/probe.hpp>
 #include <simulation/simulation.hpp>
 #include <simulation/simulation_getter.hpp>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <utility>
+#include <vector>
 #include <worker_specific.hpp>
 
 #ifndef NO_MPI
 #  include <mpi_w/wrap_mpi.hpp>
 #endif
 
+#ifdef __linux__
+#  include <sched.h>
+#endif
+
 namespace
 {
 
+  // Width of the line of each rank gathered on rank 0
+  constexpr std::size_t topology_line_size = 256;
+
+  // sysfs cpu list: "0-3,8,10-11"
+  std::vector<int>
+  parse_cpu_list(const std::string& list)
+  {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ','))
+    {
+      if (range.empty())
+      {
+        continue;
+      }
+      const auto dash = range.find('-');
+      const int first = std::stoi(range.substr(0, dash));
+      const int last = (dash == std::string::npos)
+                           ? first
+                           : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu)
+      {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+
+  std::string
+  format_cpu_list(const std::vector<int>& cpus)
+  {
+    std::string out;
+    for (std::size_t i = 0; i < cpus.size();)
+    {
+      std::size_t j = i;
+      while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+      {
+        ++j;
+      }
+      out += (out.empty() ? "" : ",") + std::to_string(cpus[i]);
+      if (j > i)
+      {
+        out += "-" + std::to_string(cpus[j]);
+      }
+      i = j + 1;
+    }
+    return out.empty() ? "?" : out;
+  }
+
+  /**
+   * @brief Threads, allowed cpus and NUMA nodes of these cpus for the calling
+   * process, read from its affinity mask and sysfs
+   */
+  std::string
+  binding_topology(int rank)
+  {
+    std::stringstream os;
+    os << "rank " << rank << ": " << Kokkos::num_threads() << " threads";
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+      std::vector<int> cpus;
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+      {
+        if (CPU_ISSET(cpu, &set))
+        {
+          cpus.push_back(cpu);
+        }
+      }
+
+      std::vector<int> nodes;
+      std::error_code ec;
+      for (const auto& entry : std::filesystem::directory_iterator(
+               "/sys/devices/system/node", ec))
+      {
+        const auto name = entry.path().filename().string();
+        if (!name.starts_with("node") || name.size() == 4
+            || !std::isdigit(static_cast<unsigned char>(name[4])))
+        {
+          continue;
+        }
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        std::getline(file, list);
+        const auto node_cpus = parse_cpu_list(list);
+        if (std::ranges::any_of(node_cpus,
+                                [&set](int cpu)
+                                { return CPU_ISSET(cpu, &set) != 0; }))
+        {
+          nodes.push_back(std::stoi(name.substr(4)));
+        }
+      }
+      std::ranges::sort(nodes);
+      os << ", cpus " << format_cpu_list(cpus) << ", NUMA nodes "
+         << format_cpu_list(nodes);
+    }
+#endif
+    const auto env = [](const char* name)
+    {
+      const char* value = std::getenv(name); // NOLINT
+      return std::string(value != nullptr ? value : "unset");
+    };
+    os << ", OMP_PROC_BIND=" << env("OMP_PROC_BIND")
+       << ", OMP_PLACES=" << env("OMP_PLACES");
+    return os.str();
+  }
+
+  /**
+   * @brief Print binding topology of every rank on rank 0 (BIOMC_NUMA).
+   * Collective.
+   */
+  void
+  report_topology(std::ostream& out_stream, int rank, int size)
+  {
+    std::string line = binding_topology(rank);
+    line.resize(topology_line_size - 1);
+    std::vector<char> lines(line.begin(), line.end());
+    lines.push_back('\0');
+#ifndef NO_MPI
+    if (size > 1)
+    {
+      lines = WrapMPI::gather<char>(std::span<const char>(lines),
+                                    static_cast<std::size_t>(size));
+    }
+#else
+    (void)size;
+#endif
+    if (rank != 0)
+    {
+      return;
+    }
+    for (std::size_t i = 0; i + topology_line_size <= lines.size();
+         i += topology_line_size)
+    {
+      out_stream << IO::AnsiCode::green << "[Topology]: "
+                 << IO::AnsiCode::reset << lines.data() + i << '\n';
+    }
+    std::flush(out_stream);
+  }
+
   KernelDispatchOptions
   read_options() noexcept
   {
@@ -66,7 +222,8 @@ namespace
              .m_p_p_team_contribs = ceil_power_of_two(p_p_t_contribs),
 
              .m_p_p_team_move = ceil_power_of_two(p_p_t_move),
-             .m_p_p_team_leave = 0 };
+             .m_p_p_team_leave = 0,
+             .instrumentation = Common::InstrumentationMask::from_env() };
   }
 }
 
@@ -88,19 +245,22 @@ namespace Core
   {
     auto getter = case_data.simulation->getter();
     const auto [_, n_compartment] = getter.getDimensions();
+    const auto instrumentation
+        = case_data.exec_info.kernel_options.instrumentation;
     partial_exporter.init_fields(case_data.params.number_exported_result,
-                                 n_compartment);
+                                 n_compartment,
+                                 instrumentation);
 
     // TODO: so far all probes are active or all probes are inactive
-    // Find a way to select them without branching in kernels
+    const bool use_probe = instrumentation.probe();
     {
-      auto probes = Simulation::ProbeAutogeneratedBuffer();
+      auto probes = Simulation::ProbeAutogeneratedBuffer(use_probe);
       case_data.simulation->setProbes(Simulation::ProbeType::LeavingTime,
                                       std::move(probes));
     }
 
     {
-      auto probes = Simulation::ProbeAutogeneratedBuffer();
+      auto probes = Simulation::ProbeAutogeneratedBuffer(use_probe);
       case_data.simulation->setProbes(Simulation::ProbeType::DivisionTime,
                                       std::move(probes));
     }
@@ -157,7 +317,7 @@ namespace Core
 #endif
     }
 
-    if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+    if (case_data.exec_info.kernel_options.instrumentation.probe())
     {
       PostProcessing::save_probes(sim->getter(), partial_exporter, true);
     }
@@ -225,6 +385,11 @@ namespace Core
     WrapMPI::barrier();
 #endif
 
+    if (Common::read_env_or("BIOMC_NUMA", false))
+    {
+      report_topology(out_stream, rank, size);
+    }
+
     if (rank == 0)
     {
       if constexpr (AutoGenerated::FlagCompileTime::verbose)
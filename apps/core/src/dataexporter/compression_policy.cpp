@@ -0,0 +1,232 @@
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <common/env_var.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <dataexporter/compression_policy.hpp>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  std::string_view
+  trim(std::string_view s)
+  {
+    const auto first = s.find_first_not_of(" \t");
+    if (first == std::string_view::npos)
+    {
+      return {};
+    }
+    const auto last = s.find_last_not_of(" \t");
+    return s.substr(first, last - first + 1);
+  }
+
+  // Split on sep, first element is removed from s
+  std::string_view
+  next_token(std::string_view& s, char sep)
+  {
+    const auto pos = s.find(sep);
+    const auto token = s.substr(0, pos);
+    s = (pos == std::string_view::npos) ? std::string_view{}
+                                        : s.substr(pos + 1);
+    return token;
+  }
+
+  std::optional<unsigned>
+  to_unsigned(std::string_view s)
+  {
+    unsigned value = 0;
+    const auto* end = s.data() + s.size();
+    const auto [ptr, ec] = std::from_chars(s.data(), end, value);
+    if (s.empty() || ec != std::errc() || ptr != end)
+    {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  std::optional<unsigned>
+  to_level(std::string_view s)
+  {
+    const auto level = to_unsigned(s);
+    if (!level || *level > Core::CompressionSettings::max_level)
+    {
+      return std::nullopt;
+    }
+    return level;
+  }
+
+  constexpr unsigned double_mantissa_bits
+      = std::numeric_limits<double>::digits - 1;
+
+  // Apply one item of the list, value is the text after the first ':'
+  bool
+  parse_item(Core::CompressionSettings& settings,
+             std::string_view name,
+             std::string_view value)
+  {
+    using Core::CompressionSettings;
+    if (name == "none" || name == "noshuffle")
+    {
+      if (name == "none")
+      {
+        settings.level = 0;
+        settings.filter_id.reset();
+      }
+      else
+      {
+        settings.shuffle = false;
+      }
+      return value.empty();
+    }
+    if (name == "bits")
+    {
+      const auto bits = to_unsigned(value);
+      settings.keep_bits = bits;
+      return bits && *bits <= double_mantissa_bits;
+    }
+    if (name == "lz4" || name == "zstd" || name == "filter")
+    {
+      if (name == "filter")
+      {
+        settings.filter_id = to_unsigned(next_token(value, ':'));
+      }
+      else
+      {
+        settings.filter_id = (name == "lz4") ? CompressionSettings::lz4_filter
+                                             : CompressionSettings::zstd_filter;
+      }
+      settings.filter_values.clear();
+      while (!value.empty())
+      {
+        const auto cd_value = to_unsigned(next_token(value, ':'));
+        if (!cd_value)
+        {
+          return false;
+        }
+        settings.filter_values.push_back(*cd_value);
+      }
+      return settings.filter_id.has_value();
+    }
+
+    // deflate:<level> or <level>
+    const auto level = (name == "deflate") ? to_level(value)
+                       : value.empty()     ? to_level(name)
+                                           : std::nullopt;
+    if (!level)
+    {
+      return false;
+    }
+    settings.level = *level;
+    return true;
+  }
+
+} // namespace
+
+namespace Core
+{
+
+  std::optional<CompressionSettings>
+  CompressionSettings::parse(std::string_view list)
+  {
+    CompressionSettings settings;
+    list = trim(list);
+    while (!list.empty())
+    {
+      auto value = trim(next_token(list, ','));
+      const auto name = next_token(value, ':');
+      if (!parse_item(settings, name, value))
+      {
+        return std::nullopt;
+      }
+    }
+    return settings;
+  }
+
+  std::string
+  CompressionSettings::to_string() const
+  {
+    std::string res;
+    if (filter_id)
+    {
+      res = "filter:" + std::to_string(*filter_id);
+      for (const auto value : filter_values)
+      {
+        res += ":" + std::to_string(value);
+      }
+      // Fallback if the plugin is not available
+      res += ",deflate:" + std::to_string(level);
+    }
+    else
+    {
+      res = (level == 0) ? "none" : "deflate:" + std::to_string(level);
+    }
+    if (!shuffle)
+    {
+      res += ",noshuffle";
+    }
+    if (keep_bits)
+    {
+      res += ",bits:" + std::to_string(*keep_bits);
+    }
+    return res;
+  }
+
+  CompressionPolicy
+  CompressionPolicy::from_env()
+  {
+    CompressionPolicy policy;
+    for (std::size_t i = 0; i < n_dataset_class; ++i)
+    {
+      const auto value = Common::read_env<std::string>(env_names[i]);
+      if (!value.has_value())
+      {
+        continue;
+      }
+      // Only particle values are rounded, other classes are written exactly
+      auto settings = CompressionSettings::parse(*value);
+      const bool lossy_allowed
+          = static_cast<DatasetClass>(i) == DatasetClass::Particles;
+      if (settings && (lossy_allowed || !settings->keep_bits))
+      {
+        policy.settings[i] = std::move(*settings);
+        continue;
+      }
+      std::printf("[Config] Invalid %s value '%s', use default\r\n",
+                  env_names[i].data(),
+                  value->c_str());
+    }
+    return policy;
+  }
+
+  void
+  round_mantissa(std::span<double> values, unsigned keep_bits) noexcept
+  {
+    if (keep_bits >= double_mantissa_bits)
+    {
+      return;
+    }
+    const unsigned drop = double_mantissa_bits - keep_bits;
+    const std::uint64_t mask = ~((std::uint64_t{ 1 } << drop) - 1);
+    const std::uint64_t half = (std::uint64_t{ 1 } << (drop - 1)) - 1;
+    for (auto& value : values)
+    {
+      if (!std::isfinite(value))
+      {
+        continue;
+      }
+      auto bits = std::bit_cast<std::uint64_t>(value);
+      // Adding half minus one and the last kept bit rounds ties to even, a
+      // carry into the exponent gives the next power of two
+      bits += half + ((bits >> drop) & 1);
+      value = std::bit_cast<double>(bits & mask);
+    }
+  }
+
+} // namespace Core
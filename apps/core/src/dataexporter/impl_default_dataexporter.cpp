@@ -28,7 +28,8 @@ namespace Core
   void
   DataExporter::write_matrix(std::string_view name,
                              std::span<const double> values,
-                             bool compress)
+                             bool compress,
+                             DatasetClass dataset_class)
   {
   }
 
@@ -49,6 +50,13 @@ namespace Core
   {
   }
 
+  void
+  DataExporter::write_slab(std::string_view name,
+                           std::span<const double> values,
+                           std::size_t offset)
+  {
+  }
+
   void
   DataExporter::write_properties(std::optional<std::string> specific_dataspace,
                                  const export_metadata_kv& values)
@@ -60,7 +68,8 @@ namespace Core
                              std::span<const double> values,
                              size_t n_row,
                              size_t n_col,
-                             bool compress)
+                             bool compress,
+                             DatasetClass dataset_class)
   {
   }
 
@@ -1,10 +1,13 @@
 
 #ifdef USE_HIGHFIVE
+#  include <H5Ppublic.h>
+#  include <H5Zpublic.h>
 #  include <Kokkos_Assert.hpp>
 #  include <chrono>
 #  include <common/common.hpp>
 #  include <cstddef>
 #  include <ctime>
+#  include <dataexporter/compression_policy.hpp>
 #  include <dataexporter/data_exporter.hpp>
 #  include <highfive/H5DataSpace.hpp>
 #  include <highfive/H5File.hpp>
@@ -40,6 +43,11 @@ namespace
                                             std::size_t n_row,
                                             std::size_t n_col);
 
+  void add_compression(HighFive::DataSetCreateProps& props,
+                       const Core::CompressionSettings& settings,
+                       bool chunked,
+                       bool compress);
+
 } // namespace
 
 namespace Core
@@ -111,7 +119,6 @@ namespace Core
     HighFive::File* file;
   };
 
-  constexpr size_t hdf5_max_compression = 9;
   DataExporter::DataExporter(const ExecInfo& info,
                              std::string_view _filename,
 
@@ -127,6 +134,11 @@ namespace Core
     metadata["author"] = get_user_name();
     metadata["description"] = description;
     metadata["run_id"] = info.run_id;
+    for (std::size_t i = 0; i < n_dataset_class; ++i)
+    {
+      metadata["compression_" + std::string(dataset_class_names[i])]
+          = compression_policy.get(static_cast<DatasetClass>(i)).to_string();
+    }
   }
 
   void
@@ -176,17 +188,16 @@ namespace Core
     HighFive::DataSpace dataspace(description.dims, description.max_dims);
     HighFive::DataSetCreateProps props;
 
-    if (description.chunk_dims.has_value())
+    const bool chunked = description.chunk_dims.has_value();
+    if (chunked)
     {
       auto chunk_dims = description.chunk_dims.value();
-      props.add(HighFive::Shuffle());
       props.add(HighFive::Chunking(ensure_conversion(chunk_dims)));
     }
-
-    if (description.compression)
-    {
-      props.add(HighFive::Deflate(hdf5_max_compression));
-    }
+    add_compression(props,
+                    compression_policy.get(description.dataset_class),
+                    chunked,
+                    description.compression);
 
     if (description.is_integer)
     {
@@ -250,10 +261,25 @@ namespace Core
     dataset.flush();
   }
 
+  void
+  DataExporter::write_slab(std::string_view name,
+                           std::span<const double> values,
+                           std::size_t offset)
+  {
+    CHECK_PIMPL
+    auto dataset = pimpl->file->getDataSet(name.data());
+    KOKKOS_ASSERT(offset + values.size() <= this->get_dim(name)[0]);
+
+    const std::vector<std::size_t> select_start = { offset };
+    const std::vector<std::size_t> select_size = { values.size() };
+    dataset.select(select_start, select_size).write_raw(values.data());
+  }
+
   void
   DataExporter::write_matrix(std::string_view name,
                              std::span<const double> values,
-                             bool compress)
+                             bool compress,
+                             DatasetClass dataset_class)
   {
     CHECK_PIMPL
 
@@ -262,19 +288,16 @@ namespace Core
     // With size=0, nothing will be saved it will not change anything to skip
     // property in this case
     // TODO: if values is 0 early return ?
-    if (values.size() > 1)
+    const bool chunked = values.size() > 1;
+    if (chunked)
     {
       // If error occurs, try to debug with fixed chunk of 1
       ds_props.add(HighFive::Chunking(
           std::min(get_chunk_size(values.size()), values.size())));
-      ds_props.add(HighFive::Shuffle());
     }
     const auto data_space = HighFive::DataSpace(values.size());
-
-    if (compress)
-    {
-      ds_props.add(HighFive::Deflate(hdf5_max_compression));
-    }
+    add_compression(
+        ds_props, compression_policy.get(dataset_class), chunked, compress);
 
     auto dataset
         = pimpl->file->createDataSet<double>(name.data(), data_space, ds_props);
@@ -287,7 +310,8 @@ namespace Core
                              std::span<const double> values,
                              size_t n_row,
                              size_t n_col,
-                             bool compress)
+                             bool compress,
+                             DatasetClass dataset_class)
   {
     CHECK_PIMPL
 
@@ -295,11 +319,8 @@ namespace Core
     auto data = mk_eigen_view(values, n_row, n_col);
     HighFive::DataSetCreateProps ds_props;
     ds_props.add(HighFive::Chunking({ n_row, n_col }));
-    ds_props.add(HighFive::Shuffle());
-    if (compress)
-    {
-      ds_props.add(HighFive::Deflate(hdf5_max_compression));
-    }
+    add_compression(
+        ds_props, compression_policy.get(dataset_class), true, compress);
     pimpl->file->createDataSet(name.data(), data, ds_props);
 
     pimpl->file->flush();
@@ -408,6 +429,70 @@ namespace
              EIGEN_INDEX(n_col) };
   }
 
+  // Dataset creation property of a registered filter plugin
+  class PluginFilter
+  {
+  public:
+    PluginFilter(unsigned _id, std::span<const unsigned> _values)
+        : id(_id), values(_values)
+    {
+    }
+
+    void
+    apply(hid_t hid) const
+    {
+      if (H5Pset_filter(hid,
+                        static_cast<H5Z_filter_t>(id),
+                        H5Z_FLAG_OPTIONAL,
+                        values.size(),
+                        values.data())
+          < 0)
+      {
+        throw std::runtime_error("DataExporter: cannot set HDF5 filter "
+                                 + std::to_string(id));
+      }
+    }
+
+  private:
+    unsigned id;
+    std::span<const unsigned> values;
+  };
+
+  bool
+  filter_available(unsigned id)
+  {
+    return H5Zfilter_avail(static_cast<H5Z_filter_t>(id)) > 0;
+  }
+
+  void
+  add_compression(HighFive::DataSetCreateProps& props,
+                  const Core::CompressionSettings& settings,
+                  const bool chunked,
+                  const bool compress)
+  {
+    // Filters need chunked layout
+    if (!chunked)
+    {
+      return;
+    }
+    if (settings.shuffle)
+    {
+      props.add(HighFive::Shuffle());
+    }
+    if (!compress)
+    {
+      return;
+    }
+    if (settings.filter_id && filter_available(*settings.filter_id))
+    {
+      props.add(PluginFilter(*settings.filter_id, settings.filter_values));
+    }
+    else if (settings.level != 0)
+    {
+      props.add(HighFive::Deflate(settings.level));
+    }
+  }
+
 } // namespace
 
 #endif
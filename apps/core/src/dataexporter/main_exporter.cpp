@@ -19,12 +19,14 @@ namespace Core
                              std::string_view _filename,
                              const std::vector<std::string>& species_names,
                              std::optional<export_metadata_t> user_description)
-      : DataExporter(info, _filename, std::move(user_description))
+      : DataExporter(info, _filename, std::move(user_description)),
+        instrumentation(info.kernel_options.instrumentation)
   {
 
     write_properties(std::nullopt, metadata);
     write_simple("misc/n_node_thread", info.thread_per_process);
     write_simple("misc/n_rank", info.n_rank);
+    write_simple("misc/instrumentation", instrumentation.to_string());
 
     write_simple("misc/species_names", species_names);
   };
@@ -159,7 +161,7 @@ namespace Core
     export_initial_kv final_values;
     final_values["number_particles"] = number_particles;
 
-    if constexpr (AutoGenerated::FlagCompileTime::enable_event_counter)
+    if (instrumentation.event_counter())
     {
       final_values["events/move"] = event.get<MC::EventType::Move>();
       final_values["events/total_division"]
@@ -1,12 +1,18 @@
 #include <Kokkos_Assert.hpp>
+#include <Kokkos_Core.hpp>
+#include <array>
 #include <biocma_cst_config.hpp>
 #include <common/common.hpp>
 #include <common/logger.hpp>
+#include <dataexporter/chunk_stream.hpp>
+#include <dataexporter/compression_policy.hpp>
 #include <dataexporter/data_exporter.hpp>
 #include <dataexporter/partial_exporter.hpp>
 #include <mc/events.hpp>
 #include <optional>
 #include <simulation/probe.hpp>
+#include <span>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -23,7 +29,9 @@ namespace Core
   }
 
   void
-  PartialExporter::init_fields(uint64_t n_iter, uint64_t n_compartments)
+  PartialExporter::init_fields(uint64_t n_iter,
+                               uint64_t n_compartments,
+                               Common::InstrumentationMask instrumentation)
   {
     std::vector<unsigned long long> chunk = { 1, n_compartments };
     const uint64_t n_expected_export = n_iter + 2; // Add first + last
@@ -47,7 +55,7 @@ namespace Core
     this->prepare_matrix(particle_repartition);
     this->prepare_matrix(tallies);
 
-    if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+    if (instrumentation.probe())
     {
       // Warning: with some STL implementation,initialiser list constructor
       // with ONE value (vector({value})) leads to vector of zeros with
@@ -74,7 +82,8 @@ namespace Core
                               * AutoGenerated::probe_buffer_size },
                 .chunk_dims = chunk,
                 .compression = true,
-                .is_integer = false };
+                .is_integer = false,
+                .dataset_class = DatasetClass::Probes };
 
         this->prepare_matrix(probes);
       }
@@ -109,20 +118,47 @@ namespace Core
                                        bool compress_data)
   {
     PROFILE_SECTION("write_particle_data")
-    const auto& [_particle_values, _spatial_values, _ages_values, _names]
+    const auto& [_particle_values,
+                 _spatial_values,
+                 _ages_values,
+                 _names,
+                 _statistics]
         = bonce;
+    constexpr auto particles = DatasetClass::Particles;
 
-    ;
+    if (_statistics.has_value())
+    {
+      write_statistics(*_statistics, ds_name + "statistics/", compress_data);
+    }
+
+    // Buffer is owned by this call, lossy rounding is done in place
+    const auto keep_bits = compression_policy.get(particles).keep_bits;
+    const auto round = [&keep_bits](const auto& values)
+    {
+      if (values.has_value())
+      {
+        round_mantissa({ values->data(), values->size() }, *keep_bits);
+      }
+    };
+    if (compress_data && keep_bits.has_value())
+    {
+      round(_particle_values);
+      round(_ages_values);
+    }
 
     if (_ages_values.has_value())
     {
       const size_t n_particles = _ages_values->extent(1);
       auto* ptr_ages = Kokkos::subview(*_ages_values, 0, Kokkos::ALL).data();
-      this->write_matrix(
-          ds_name + "age_hydro/", { ptr_ages, n_particles }, compress_data);
+      this->write_matrix(ds_name + "age_hydro/",
+                         { ptr_ages, n_particles },
+                         compress_data,
+                         particles);
       ptr_ages = Kokkos::subview(*_ages_values, 1, Kokkos::ALL).data();
-      this->write_matrix(
-          ds_name + "age/", { ptr_ages, n_particles }, compress_data);
+      this->write_matrix(ds_name + "age/",
+                         { ptr_ages, n_particles },
+                         compress_data,
+                         particles);
     }
 
     if (_particle_values.has_value() && _spatial_values.has_value(),
@@ -147,13 +183,197 @@ namespace Core
 
         this->write_matrix(ds_name + names[i_name],
                            { ptr_particles, n_particles },
-                           compress_data);
+                           compress_data,
+                           particles);
+        this->write_matrix(ds_name + "spatial/" + names[i_name],
+                           { ptr_spatial, n_compartments },
+                           false);
+      }
+    }
+  }
+  void
+  PartialExporter::write_particle_stream(
+      PostProcessing::DeviceBonceBuffer&& bonce,
+      const std::string& ds_name,
+      bool compress_data,
+      std::size_t memory_bound)
+  {
+    PROFILE_SECTION("write_particle_stream")
+    const auto& [n_particles, with_age, _spatial_values, _names, fill] = bonce;
+    constexpr auto particles = DatasetClass::Particles;
+
+    // Streamed rows in the order of write_particle_data, which is also the
+    // order of the rows filled by the chunk extraction
+    std::vector<std::string> rows;
+    if (with_age)
+    {
+      rows.emplace_back(ds_name + "age_hydro/");
+      rows.emplace_back(ds_name + "age/");
+    }
+    if (_spatial_values.has_value() && _names.has_value())
+    {
+      const auto& spatial_values = *_spatial_values;
+      const auto& names = *_names;
+      const size_t n_compartments = spatial_values.extent(1);
+
+      KOKKOS_ASSERT(spatial_values.extent(0) == names.size());
+      for (size_t i_name = 0; i_name < names.size(); ++i_name)
+      {
+        rows.emplace_back(ds_name + names[i_name]);
+
+        const auto* ptr_spatial
+            = Kokkos::subview(spatial_values, i_name, Kokkos::ALL).data();
         this->write_matrix(ds_name + "spatial/" + names[i_name],
                            { ptr_spatial, n_compartments },
                            false);
       }
     }
+    if (rows.empty() || !fill)
+    {
+      return;
+    }
+
+    if (n_particles == 0)
+    {
+      // Chunked datasets cannot be empty
+      for (const auto& name : rows)
+      {
+        this->write_matrix(name, {}, compress_data, particles);
+      }
+      return;
+    }
+
+    // One HDF5 chunk per streamed chunk, each is compressed once. The bound
+    // covers the extraction buffer and the two staging buffers
+    const size_t chunk
+        = stream_chunk_size(memory_bound, rows.size(), n_particles, 3);
+    for (const auto& name : rows)
+    {
+      this->prepare_matrix({ .name = name,
+                             .dims = { n_particles },
+                             .max_dims = { n_particles },
+                             .chunk_dims = std::vector<unsigned long long>(
+                                 1, static_cast<unsigned long long>(chunk)),
+                             .compression = compress_data,
+                             .is_integer = false,
+                             .dataset_class = particles });
+    }
+
+    // Chunks are extracted from the container into extracted, then copied
+    // to staging buffers pinned so that device copies are asynchronous
+    using StagingView = Kokkos::View<double**,
+                                     Kokkos::LayoutRight,
+                                     Kokkos::SharedHostPinnedSpace>;
+    const ParticlePropertyViewType<ComputeSpace> extracted(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "dump_chunk"),
+        rows.size(),
+        chunk);
+    const std::array<StagingView, 2> staging
+        = { StagingView("dump_staging_0", rows.size(), chunk),
+            StagingView("dump_staging_1", rows.size(), chunk) };
+    const auto keep_bits = compression_policy.get(particles).keep_bits;
+    const bool round = compress_data && keep_bits.has_value();
+    const ComputeSpace exec;
+
+    // Work on exec runs in order: the extraction of chunk k only overwrites
+    // extracted once the copy of chunk k-1 is done
+    stream_chunks(
+        n_particles,
+        chunk,
+        [&](const ChunkRange& range)
+        {
+          const auto& buffer = staging[range.index % 2];
+          const auto buffer_range = std::make_pair(size_t{ 0 }, range.size());
+          fill(exec, range.begin, range.end, extracted);
+          for (size_t i_row = 0; i_row < rows.size(); ++i_row)
+          {
+            Kokkos::deep_copy(exec,
+                              Kokkos::subview(buffer, i_row, buffer_range),
+                              Kokkos::subview(extracted, i_row, buffer_range));
+          }
+        },
+        [&exec] { exec.fence(); },
+        [&](const ChunkRange& range)
+        {
+          const auto& buffer = staging[range.index % 2];
+          for (size_t i_row = 0; i_row < rows.size(); ++i_row)
+          {
+            const std::span<double> values(&buffer(i_row, 0), range.size());
+            // Buffer is owned by this call, lossy rounding is done in place
+            if (round)
+            {
+              round_mantissa(values, *keep_bits);
+            }
+            this->write_slab(rows[i_row], values, range.begin);
+          }
+        });
+  }
+
+  void
+  PartialExporter::write_statistics(
+      const PostProcessing::ParticleStatistics& statistics,
+      const std::string& ds_name,
+      bool compress_data)
+  {
+    constexpr auto particles = DatasetClass::Particles;
+    const std::size_t n_compartment = statistics.n_compartment;
+    const std::size_t n_bins = statistics.n_bins;
+    const auto& levels = PostProcessing::ParticleStatistics::quantile_levels;
+    const auto row = [](const auto& view, std::size_t i)
+    {
+      return std::span<const double>(&view(i, 0), view.extent(1));
+    };
+
+    if (n_compartment == 0)
+    {
+      return;
+    }
+    this->write_matrix(ds_name + "count",
+                       row(statistics.count, 0),
+                       compress_data,
+                       particles);
+    if (n_bins != 0)
+    {
+      this->write_matrix(ds_name + "quantile_levels", levels, false);
+    }
+
+    for (std::size_t i_var = 0; i_var < statistics.n_var(); ++i_var)
+    {
+      const auto group = ds_name + statistics.names[i_var] + "/";
+      this->write_matrix(group + "mean",
+                         row(statistics.mean, i_var),
+                         compress_data,
+                         particles);
+      this->write_matrix(group + "variance",
+                         row(statistics.variance, i_var),
+                         compress_data,
+                         particles);
+      this->write_matrix(
+          group + "min", row(statistics.min, i_var), compress_data, particles);
+      this->write_matrix(
+          group + "max", row(statistics.max, i_var), compress_data, particles);
+      if (n_bins == 0)
+      {
+        continue;
+      }
+      // Column major matrices (bin, compartment) as concentrations
+      this->write_matrix(
+          group + "bin_edges", row(statistics.bin_edges, i_var), false);
+      this->write_matrix(group + "histogram",
+                         row(statistics.histogram, i_var),
+                         n_bins,
+                         n_compartment,
+                         compress_data,
+                         particles);
+      this->write_matrix(group + "quantiles",
+                         row(statistics.quantiles, i_var),
+                         levels.size(),
+                         n_compartment,
+                         compress_data,
+                         particles);
+    }
   }
+
   void
   PartialExporter::write_tally(std::span<const std::size_t> data)
   {
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <common/common.hpp>
+#include <common/env_var.hpp>
+#include <cstddef>
+#include <exception>
+#include <export_pipeline.hpp>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace Core
+{
+
+  ExportPipeline::ExportPipeline(std::size_t n_buffer, Writer _writer)
+      : writer(std::move(_writer)), buffers(std::max<std::size_t>(n_buffer, 1))
+  {
+    free_buffers.reserve(buffers.size());
+    for (auto& buffer : buffers)
+    {
+      free_buffers.push_back(&buffer);
+    }
+    if (n_buffer != 0)
+    {
+      worker = std::thread([this] { run(); });
+    }
+  }
+
+  ExportPipeline::~ExportPipeline()
+  {
+    if (!worker.joinable())
+    {
+      return;
+    }
+    {
+      const std::lock_guard lock(mutex);
+      stop = true;
+    }
+    work_cv.notify_one();
+    worker.join();
+  }
+
+  std::size_t
+  ExportPipeline::n_buffer_from_env()
+  {
+    return Common::read_env_or("BIOMC_EXPORT_QUEUE", std::size_t{ 2 });
+  }
+
+  void
+  ExportPipeline::rethrow_error()
+  {
+    if (error)
+    {
+      std::rethrow_exception(std::exchange(error, nullptr));
+    }
+  }
+
+  ExportSnapshot&
+  ExportPipeline::acquire()
+  {
+    PROFILE_SECTION("host:export_acquire")
+    std::unique_lock lock(mutex);
+    free_cv.wait(lock, [this] { return !free_buffers.empty(); });
+    rethrow_error();
+    auto* snapshot = free_buffers.back();
+    free_buffers.pop_back();
+    return *snapshot;
+  }
+
+  void
+  ExportPipeline::submit(ExportSnapshot& snapshot)
+  {
+    if (!worker.joinable())
+    {
+      // Buffer goes back to the pool even if writer throws
+      try
+      {
+        writer(snapshot);
+      }
+      catch (...)
+      {
+        free_buffers.push_back(&snapshot);
+        throw;
+      }
+      free_buffers.push_back(&snapshot);
+      return;
+    }
+    {
+      const std::lock_guard lock(mutex);
+      queue.push_back(&snapshot);
+    }
+    work_cv.notify_one();
+  }
+
+  void
+  ExportPipeline::flush()
+  {
+    std::unique_lock lock(mutex);
+    free_cv.wait(lock, [this] { return queue.empty(); });
+    rethrow_error();
+  }
+
+  void
+  ExportPipeline::run()
+  {
+    std::unique_lock lock(mutex);
+    while (true)
+    {
+      work_cv.wait(lock, [this] { return stop || !queue.empty(); });
+      if (queue.empty())
+      {
+        return;
+      }
+      // Snapshot stays queued while written so that flush waits for it
+      auto* snapshot = queue.front();
+      lock.unlock();
+      std::exception_ptr raised;
+      try
+      {
+        writer(*snapshot);
+      }
+      catch (...)
+      {
+        raised = std::current_exception();
+      }
+      lock.lock();
+      if (raised && !error)
+      {
+        error = raised;
+      }
+      queue.pop_front();
+      free_buffers.push_back(snapshot);
+      free_cv.notify_all();
+    }
+  }
+
+} // namespace Core
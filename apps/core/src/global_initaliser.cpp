@@ -85,21 +85,6 @@ namespace
     return delta_time;
   }
 
-  // FIXME
-  std::unique_ptr<ILoadBalancer>
-  lb_factory(uint32_t s)
-  {
-    auto bounded = Common::read_env<uint32_t>("BIOMC_LBBOUND");
-    if (bounded)
-    {
-      return std::make_unique<BoundLoadBalancer>(s, *bounded);
-    }
-    else
-    {
-      return std::make_unique<UniformLoadBalancer>(s);
-    }
-  }
-
   size_t
   compute_n_per_flowmap(double t_per_flowmap,
                         size_t n_different_maps,
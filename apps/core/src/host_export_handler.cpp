@@ -1,8 +1,14 @@
 #include "simulation/simulation_getter.hpp"
+#include <biocma_cst_config.hpp>
 #include <cma_utils/alias.hpp>
+#include <export_pipeline.hpp>
 #include <host_export_handler.hpp>
 #include <impl_post_process.hpp>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
 #ifndef NO_MPI
 #  include <mpi_w/wrap_mpi.hpp>
@@ -12,18 +18,105 @@
 #  define SEND_MPI_SIG_DUMP                                                    \
     if constexpr (AutoGenerated::FlagCompileTime::use_mpi)                     \
     {                                                                          \
-      WrapMPI::host_dispatch(exec, WrapMPI::SIGNALS::DUMP);                    \
+      if (commands != nullptr)                                                 \
+      {                                                                        \
+        commands->post(WrapMPI::SIGNALS::DUMP);                                \
+      }                                                                        \
     }
 #else
 #  define SEND_MPI_SIG_DUMP
 #endif
 
+namespace
+{
+  void
+  copy_to(std::vector<double>& dst, std::span<const double> src)
+  {
+    dst.assign(src.begin(), src.end());
+  }
+
+  void
+  copy_optional(std::vector<double>& dst,
+                std::optional<std::span<const double>> src)
+  {
+    if (src.has_value())
+    {
+      copy_to(dst, *src);
+    }
+    else
+    {
+      dst.clear();
+    }
+  }
+
+  std::optional<std::span<const double>>
+  as_optional(const std::vector<double>& values)
+  {
+    if (values.empty())
+    {
+      return std::nullopt;
+    }
+    return values;
+  }
+
+  // Runs on the I/O thread of the export pipeline
+  void
+  write_snapshot(Core::MainExporter& main_exporter,
+                 Core::ExportSnapshot& snapshot)
+  {
+    PROFILE_SECTION("host:write_export")
+    main_exporter.update_fields(snapshot.time,
+                                snapshot.concentration_liquid,
+                                snapshot.volume_liquid,
+                                as_optional(snapshot.concentration_gas),
+                                as_optional(snapshot.volume_gas),
+                                as_optional(snapshot.mtr));
+
+    auto& partial_exporter = *snapshot.partial;
+    // FIXME:
+    // WARNING write_tally must be  BEFORE write_number_particle because
+    // partial_exporter increase iteration counter after write_number_particle
+    if (snapshot.with_tally)
+    {
+      partial_exporter.write_tally(snapshot.tally);
+    }
+    partial_exporter.write_number_particle(snapshot.repartition);
+
+    for (const auto& [name, values] : snapshot.probes)
+    {
+      partial_exporter.write_probe(name, values);
+    }
+
+    if (snapshot.particles.has_value())
+    {
+      constexpr bool compress_data
+          = AutoGenerated::PostProcessing::FlagCompileTime::compress_export;
+      auto& [ds_name, bonce] = *snapshot.particles;
+      partial_exporter.write_particle_data(
+          std::move(bonce), ds_name, compress_data);
+      // Drop host views now rather than at the next export
+      snapshot.particles.reset();
+    }
+  }
+} // namespace
+
+void
+ExportHandler::flush()
+{
+  if (pipeline)
+  {
+    pipeline->flush();
+  }
+}
+
 void
 ExportHandler::pre_post_export(
 
     const Simulation::Getter& getter,
     const CmaUtils::TransitionnerPtrType& transitioner)
 {
+  // Main exporter is written from this thread
+  flush();
 
   const auto current_time = getter.absolute_time();
   // Retrieve the current reactor state from the transitioner
@@ -61,10 +154,16 @@ ExportHandler::pre_post_export(
 ExportHandler::ExportHandler(std::shared_ptr<Core::MainExporter> _main_exporter,
                              ExecInfo _exec,
                              size_t _dump_interval,
-                             size_t _n_iter_simulation)
+                             size_t _n_iter_simulation,
+                             WrapMPI::CommandChannel* _commands)
     : dump_interval(_dump_interval), n_iter_simulation(_n_iter_simulation),
-      exec(_exec), main_exporter(std::move(_main_exporter))
+      exec(_exec), main_exporter(std::move(_main_exporter)),
+      commands(_commands)
 {
+  pipeline = std::make_unique<Core::ExportPipeline>(
+      Core::ExportPipeline::n_buffer_from_env(),
+      [exporter = main_exporter](Core::ExportSnapshot& snapshot)
+      { write_snapshot(*exporter, snapshot); });
 }
 
 bool
@@ -90,11 +189,6 @@ ExportHandler::operator()(size_t loop_counter,
 
   // Send MPI dump signal
   SEND_MPI_SIG_DUMP
-  std::optional<std::span<const double>> volume_gas = std::nullopt;
-  if (state->has_gas())
-  {
-    volume_gas = state->get_gas()->volume();
-  }
 
   // Update progress bar if verbose mode is enabled
   if constexpr (AutoGenerated::FlagCompileTime::verbose)
@@ -102,35 +196,62 @@ ExportHandler::operator()(size_t loop_counter,
     progressbar.show(std::cout, n_iter_simulation, loop_counter);
   }
 
-  // Update main exporter with current simulation data
-  main_exporter->update_fields(current_time,
-                               getter.getCliqData(),
-                               state->get_liquid()->volume(),
-                               getter.getCgasData(),
-                               volume_gas,
-                               getter.getMTRData());
+  // Blocks only if every staging buffer is still waiting to be written
+  auto& snapshot = pipeline->acquire();
+  snapshot.partial = &partial_exporter;
+  snapshot.time = current_time;
+  copy_to(snapshot.concentration_liquid, getter.getCliqData());
+  copy_to(snapshot.volume_liquid, state->get_liquid()->volume());
+  copy_optional(snapshot.concentration_gas, getter.getCgasData());
+  if (state->has_gas())
+  {
+    copy_to(snapshot.volume_gas, state->get_gas()->volume());
+  }
+  else
+  {
+    snapshot.volume_gas.clear();
+  }
+  copy_optional(snapshot.mtr, getter.getMTRData());
 
-  // FIXME:
-  // WARNING write_tally must be  BEFORE write_number_particle because
-  // partial_exporter increase iteration counter after write_number_particle
+  const auto instrumentation = exec.kernel_options.instrumentation;
 
   // Clear event counter if enabled
-  if constexpr (AutoGenerated::FlagCompileTime::enable_event_counter)
+  snapshot.with_tally = instrumentation.event_counter();
+  if (snapshot.with_tally)
   {
-    partial_exporter.write_tally(mc_unit->events.get_span());
+    const auto tally = mc_unit->events.get_span();
+    snapshot.tally.assign(tally.begin(), tally.end());
     mc_unit->events.clear();
   }
 
-  // Write particle repartition
-  partial_exporter.write_number_particle(mc_unit->getRepartition());
+  snapshot.repartition = mc_unit->getRepartition();
 
-  // Save probes and particle state if enabled
-  if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+  // Probes are cleared and particle properties are copied to host now, the
+  // simulation can go on while they are written
+  if (instrumentation.probe())
   {
-    PostProcessing::save_probes(getter, partial_exporter);
+    PostProcessing::snapshot_probes(getter, snapshot.probes);
   }
-  if constexpr (AutoGenerated::FlagCompileTime::dump_particle_state)
+  else
+  {
+    snapshot.probes.clear();
+  }
+  // Streamed dumps are not copied to host at once, they are written from
+  // this thread
+  const bool dump_particles = instrumentation.dump_particle_state();
+  const bool stream_particles
+      = dump_particles && PostProcessing::dump_memory_bound() != 0;
+  if (dump_particles && !stream_particles)
+  {
+    snapshot.particles = PostProcessing::snapshot_particle_state(getter);
+  }
+
+  pipeline->submit(snapshot);
+
+  if (stream_particles)
   {
+    // Partial exporter is written from this thread
+    flush();
     PostProcessing::save_particle_state(getter, partial_exporter);
   }
 
@@ -3,17 +3,22 @@
 #include <biocma_cst_config.hpp>
 #include <cma_utils/alias.hpp>
 #include <common/common.hpp>
+#include <common/env_var.hpp>
 #include <common/execinfo.hpp>
 #include <common/logger.hpp>
 #include <core/simulation_parameters.hpp>
 #include <cstddef>
 #include <dataexporter/main_exporter.hpp>
+#include <chrono>
 #include <dataexporter/partial_exporter.hpp>
 #include <host_export_handler.hpp>
 #include <host_specific.hpp>
 #include <impl_post_process.hpp>
+#include <load_balancing/domain_partition.hpp>
+#include <load_balancing/particle_migration.hpp>
 #include <mc/unit.hpp>
 #include <memory>
+#include <optional>
 #include <progress_bar.hpp>
 #include <signal_handling.hpp>
 #include <simulation/simulation.hpp>
@@ -40,6 +45,7 @@
 #  define MPI_DISPATCH_MAIN                                                    \
     if constexpr (AutoGenerated::FlagCompileTime::use_mpi)                     \
     {                                                                          \
+      commands.post(WrapMPI::SIGNALS::HydroUpdate);                            \
       const auto _ = mpi_payload.sendAll(exec.n_rank);                         \
       (void)_;                                                                 \
     }
@@ -47,18 +53,27 @@
 #  define SEND_MPI_SIG_STOP                                                    \
     if constexpr (AutoGenerated::FlagCompileTime::use_mpi)                     \
     {                                                                          \
-      WrapMPI::host_dispatch(exec, WrapMPI::SIGNALS::STOP);                    \
+      commands.post(WrapMPI::SIGNALS::STOP);                                   \
+      commands.release();                                                      \
     }
 
 #  define SEND_MPI_SIG_RUN                                                     \
     if constexpr (AutoGenerated::FlagCompileTime::use_mpi)                     \
     {                                                                          \
-      WrapMPI::host_dispatch(exec, WrapMPI::SIGNALS::RUN);                     \
+      commands.post(WrapMPI::SIGNALS::RUN);                                    \
     }
-#  define INIT_PAYLOAD WrapMPI::HostIterationPayload mpi_payload;
+
+#  define SEND_MPI_SIG_MIGRATE                                                 \
+    if constexpr (AutoGenerated::FlagCompileTime::use_mpi)                     \
+    {                                                                          \
+      commands.post(WrapMPI::SIGNALS::Migrate);                                \
+    }
+#  define INIT_PAYLOAD                                                         \
+    WrapMPI::HostIterationPayload mpi_payload(                                 \
+        flowmap_cache_capacity(d_transionner));
 
 #  define WAIT_PAYLOAD mpi_payload.wait();
-#  define WAIT_REQ WrapMPI::Async::wait(req);
+#  define WAIT_REQ sync_wait_next(exec, simulation, &req, sync_exchange);
 
 #else
 // Without MPI do nothing
@@ -68,6 +83,7 @@
 #  define SEND_MPI_SIG_STOP
 #  define INIT_PAYLOAD
 #  define SEND_MPI_SIG_RUN
+#  define SEND_MPI_SIG_MIGRATE
 #  define WAIT_PAYLOAD
 #  define WAIT_REQ
 #endif
@@ -124,11 +140,23 @@ namespace
     return std::make_tuple(n_iter_simulation, dump_number, dump_interval);
   }
 
+  /**
+   * @brief Number of flowmaps kept by workers (BIOMC_FLOWMAP_CACHE), every
+   * flowmap of the case by default so that each one is sent once
+   */
+  [[maybe_unused]] std::size_t
+  flowmap_cache_capacity(const CmaUtils::TransitionnerPtrType& transitioner)
+  {
+    return Common::read_env_or("BIOMC_FLOWMAP_CACHE",
+                               static_cast<std::size_t>(transitioner->size()));
+  }
+
   void
   final_export(const CmaUtils::TransitionnerPtrType& d_transitionner,
                const Simulation::SimulationUnit& simulation,
                Core::PartialExporter& partial_exporter,
-               ExportHandler& exporter_handler)
+               ExportHandler& exporter_handler,
+               const Common::InstrumentationMask instrumentation)
   {
     const auto accesor = simulation.getter();
     const auto& mc_unit = accesor.mc_unit();
@@ -136,7 +164,7 @@ namespace
     // FIXME:
     // WARNING write_tally must be  BEFORE write_number_particle because
     // partial_exporter increase iteration counter after write_number_particle
-    if constexpr (AutoGenerated::FlagCompileTime::enable_event_counter)
+    if (instrumentation.event_counter())
     {
       partial_exporter.write_tally(mc_unit->events.get_span());
       mc_unit->events.clear();
@@ -182,8 +210,6 @@ host_process(std::shared_ptr<IO::Logger> logger,
 
   PostProcessing::show_sumup_state(logger, getter);
 
-  SEND_MPI_SIG_STOP;
-
   PostProcessing::save_particle_state(getter, partial_exporter);
   last_sync(exec, simulation);
   PostProcessing::final_post_processing(
@@ -200,14 +226,16 @@ namespace
                  const ExecInfo& exec,
                  auto n_iter_simulation,
                  auto dump_interval,
-                 std::shared_ptr<Core::MainExporter> main_exporter)
+                 std::shared_ptr<Core::MainExporter> main_exporter,
+                 WrapMPI::CommandChannel* commands)
   {
 
     // use ternary because ExportHandler doesnt provie assigment operator
     return do_export ? ExportHandler(std::move(main_exporter),
                                      exec,
                                      dump_interval,
-                                     n_iter_simulation)
+                                     n_iter_simulation,
+                                     commands)
                      : ExportHandler();
   }
 
@@ -230,8 +258,15 @@ namespace
     const auto getter = simulation.getter();
     const auto [n_iter, dump_number, dump_interval] = get_n_interval(params);
     const double d_t = params.d_t;
-    auto exporter_handler
-        = export_factory(do_export, exec, n_iter, dump_interval, main_exporter);
+#ifndef NO_MPI
+    // Collective, created first on host and workers
+    WrapMPI::CommandChannel commands;
+    WrapMPI::CommandChannel* const command_channel = &commands;
+#else
+    WrapMPI::CommandChannel* const command_channel = nullptr;
+#endif
+    auto exporter_handler = export_factory(
+        do_export, exec, n_iter, dump_interval, main_exporter, command_channel);
     const auto n_iter_simulation = n_iter;
 
     INIT_PAYLOAD
@@ -240,19 +275,58 @@ namespace
     {
       exporter_handler.pre_post_export(getter, d_transionner);
     }
-    simulation.update_feed(d_t);
 
 #ifndef NO_MPI
     MPI_Request req{};
+    MPI_Request reduce_req = MPI_REQUEST_NULL;
+    const auto compression = make_sync_compression(simulation);
+    const auto shared = make_sync_shared(simulation);
+    const auto tables = make_sync_tables();
+    std::unique_ptr<WrapMPI::PartitionedExchange> partitioned;
+    SyncExchange sync_exchange{ .compression = compression.get(),
+                                .shared = shared.get(),
+                                .tables = tables.get() };
+#else
+    MPI_Request reduce_req{};
+    SyncExchange sync_exchange{};
 #endif
+    // Particles stay in the compartments of their rank, migration would
+    // break ownership
+    const bool decomposition = DomainPartition::enabled_from_env();
+    std::optional<DomainPartition> partition;
+    auto migration_params = decomposition
+                                ? ParticleMigration::Parameters{}
+                                : ParticleMigration::parameters_from_env();
+    if (do_export)
+    {
+      migration_params.export_interval = dump_interval;
+    }
+    ParticleMigration migration(migration_params);
     auto loop_functor = [&](auto&& local_container)
     {
       Core::SignalHandler sig;
 
+      local_container.set_kernel_team(exec.kernel_options.m_p_p_team_model);
       auto functors = simulation.init_functors<ComputeSpace>(
           local_container, exec.kernel_options);
 
       UPDATE_HYDRO_STEP(getter.absolute_time(), d_t)
+      // Feed positions use numbering selected at first hydro update
+      simulation.update_feed(d_t);
+      if (decomposition)
+      {
+        // Workers build the same partition at their first cycle
+        partition.emplace(make_domain_partition(exec, simulation));
+        // Scalars of every compartment are integrated on host
+        simulation.restrict_compartments(partition->begin(exec.current_rank),
+                                         partition->end(exec.current_rank),
+                                         false);
+#ifndef NO_MPI
+        partitioned = std::make_unique<WrapMPI::PartitionedExchange>(
+            partition->offsets());
+        sync_exchange.partition = partitioned.get();
+#endif
+      }
       auto current_time = getter.absolute_time();
       for (size_t __loop_counter = 0; __loop_counter < n_iter_simulation;
            ++__loop_counter)
@@ -260,13 +334,28 @@ namespace
 
         DEBUG_INSTRUCTION
 
+        // Between cycles, workers wait for a signal
+        if (migration.due())
+        {
+          SEND_MPI_SIG_MIGRATE
+          const auto moved = migration.rebalance(exec, simulation);
+          if (logger && moved != 0)
+          {
+            logger->print("Host",
+                          "Migrated " + std::to_string(moved) + " particles");
+          }
+        }
+
         if (d_transionner->need_advance(current_time, d_t))
         {
           UPDATE_HYDRO_STEP(current_time, d_t)
+          migration.recalibrate();
         }
 
         SEND_MPI_SIG_RUN
 
+        // Host work is measured without waits on workers
+        const auto export_start = std::chrono::steady_clock::now();
         if (do_export)
         {
 
@@ -274,21 +363,38 @@ namespace
               __loop_counter, getter, partial_exporter, d_transionner);
           (void)_;
         }
+        std::chrono::duration<double> host_work
+            = std::chrono::steady_clock::now() - export_start;
 
         WAIT_PAYLOAD
 
-        sync_step(exec, simulation);
+        // Contributions of previous step are reduced during hydro update and
+        // export
+        sync_step(exec, simulation, &reduce_req, sync_exchange);
         {
           PROFILE_SECTION("host:sync_update")
+          const auto update_start = std::chrono::steady_clock::now();
           simulation.update_feed(d_t);
           simulation.ode_step(d_t);
           current_time = simulation.advance(d_t);
           // From here, contributions can be overwritten
+          host_work += std::chrono::steady_clock::now() - update_start;
         }
+        migration.record_host_work(host_work.count());
 #ifndef NO_MPI
-        sync_prepare_next(exec, simulation, &req);
+        sync_prepare_next(exec, simulation, &req, sync_exchange);
 #endif
+        if (partition)
+        {
+          exchange_particles(exec, simulation, *partition);
+        }
+        const auto cycle_start = std::chrono::steady_clock::now();
         simulation.cycleProcess(local_container, d_t, functors);
+        const std::chrono::duration<double> cycle_duration
+            = std::chrono::steady_clock::now() - cycle_start;
+        migration.record_cycle(cycle_duration.count());
+        sync_contributions_start(
+            exec, simulation, &reduce_req, sync_exchange);
 
         if (Core::SignalHandler::is_usr1_raised()) [[unlikely]]
         {
@@ -296,6 +402,8 @@ namespace
           {
             logger->print("Host", "Save triggered");
           }
+          // Partial exporter may still be written by the export pipeline
+          exporter_handler.flush();
           PostProcessing::save_particle_state(getter, partial_exporter);
         }
 
@@ -318,11 +426,21 @@ namespace
     // End
 
     std::visit(loop_functor, getter.mc_unit()->container);
+    // Contributions of the last cycle are summed on host before any saved
+    // checkpoint, a restart applies them at its first scalar step
+    sync_step(exec, simulation, &reduce_req, sync_exchange);
+    // Workers release node resources of sync_exchange when they stop, before
+    // any other collective
+    SEND_MPI_SIG_STOP;
+    sync_release(simulation, &reduce_req, sync_exchange);
 
     if (do_export)
     {
-      final_export(
-          d_transionner, simulation, partial_exporter, exporter_handler);
+      final_export(d_transionner,
+                   simulation,
+                   partial_exporter,
+                   exporter_handler,
+                   exec.kernel_options.instrumentation);
     }
 
     // simulation.getter().get_end_time_mut() = current_time;
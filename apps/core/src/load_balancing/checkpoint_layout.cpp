@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <load_balancing/checkpoint_layout.hpp>
+#include <load_balancing/iload_balancer.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+
+CheckpointLayout::CheckpointLayout(std::span<const uint64_t> counts)
+    : m_offsets(counts.size() + 1, 0)
+{
+  for (std::size_t i = 0; i < counts.size(); ++i)
+  {
+    m_offsets[i + 1] = m_offsets[i] + counts[i];
+  }
+}
+
+std::pair<uint64_t, uint64_t>
+CheckpointLayout::rank_range(ILoadBalancer& balancer,
+                             uint32_t rank,
+                             uint32_t n_rank,
+                             uint64_t total)
+{
+  // Rank 0 gets the remainder of the split, its share is computed as the
+  // other ones
+  uint64_t begin = 0;
+  for (uint32_t i = 0; i < rank && i < n_rank; ++i)
+  {
+    begin += balancer.balance(i, total);
+  }
+  return { begin, begin + balancer.balance(rank, total) };
+}
+
+std::vector<ShardSlice>
+CheckpointLayout::slices(uint64_t begin, uint64_t end) const
+{
+  std::vector<ShardSlice> result;
+  for (uint64_t shard = 0; shard < n_shard(); ++shard)
+  {
+    const uint64_t first = std::max(begin, m_offsets[shard]);
+    const uint64_t last = std::min(end, m_offsets[shard + 1]);
+    if (first < last)
+    {
+      result.push_back({ .shard = shard,
+                         .first = first - m_offsets[shard],
+                         .last = last - m_offsets[shard] });
+    }
+  }
+  return result;
+}
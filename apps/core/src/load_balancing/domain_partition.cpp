@@ -0,0 +1,235 @@
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <common/common.hpp>
+#include <common/env_var.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <load_balancing/domain_partition.hpp>
+#include <mc/traits.hpp>
+#include <mc/unit.hpp>
+#include <numeric>
+#include <simulation/simulation.hpp>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#ifndef NO_MPI
+#  include <mpi_w/wrap_mpi.hpp>
+#endif
+
+namespace
+{
+#ifndef NO_MPI
+  // Distinct from iteration payload, signal, contribution and migration tags
+  constexpr std::size_t exchange_tag = 48;
+
+  template <typename F>
+  void
+  append(MC::ParticleBatch<F>& dst,
+         const MC::ParticleBatch<F>& src,
+         std::size_t i,
+         std::size_t n_var)
+  {
+    const auto row = src.model.begin() + static_cast<std::ptrdiff_t>(i * n_var);
+    dst.model.insert(
+        dst.model.end(), row, row + static_cast<std::ptrdiff_t>(n_var));
+    dst.position.push_back(src.position[i]);
+    dst.ages.push_back(src.ages[i * 2]);
+    dst.ages.push_back(src.ages[i * 2 + 1]);
+    if (!src.weights.empty())
+    {
+      dst.weights.push_back(src.weights[i]);
+    }
+  }
+
+  template <typename Container>
+  uint64_t
+  exchange(const ExecInfo& exec,
+           Container& container,
+           const DomainPartition& partition)
+  {
+    using Model = typename Container::UsedModel;
+    using F = typename Model::FloatType;
+    constexpr std::size_t n_var = Model::n_var;
+    constexpr bool weighted = !ConstWeightModelType<Model>;
+    const std::size_t rank = exec.current_rank;
+    const std::size_t n_rank = exec.n_rank;
+
+    const auto outside
+        = container.extract_outside(partition.begin(rank), partition.end(rank));
+
+    std::vector<MC::ParticleBatch<F>> outgoing(n_rank);
+    for (std::size_t i = 0; i < outside.size(); ++i)
+    {
+      append(outgoing[partition.owner(outside.position[i])], outside, i, n_var);
+    }
+
+    std::vector<uint64_t> send_counts(n_rank);
+    for (std::size_t i = 0; i < n_rank; ++i)
+    {
+      send_counts[i] = outgoing[i].size();
+    }
+    const auto recv_counts
+        = WrapMPI::all_to_all<uint64_t>(send_counts, n_rank);
+
+    std::vector<MC::ParticleBatch<F>> incoming(n_rank);
+    std::vector<MPI_Request> requests;
+    requests.reserve(8 * n_rank);
+    const auto post_recv = [&requests](auto& buffer, std::size_t src, int tag)
+    {
+      requests.emplace_back();
+      WrapMPI::Async::recv_span(
+          requests.back(), std::span(buffer), src, exchange_tag + tag);
+    };
+    const auto post_send
+        = [&requests](const auto& buffer, std::size_t dest, int tag)
+    {
+      using T = typename std::decay_t<decltype(buffer)>::value_type;
+      requests.emplace_back();
+      WrapMPI::Async::send_v<T>(requests.back(),
+                                std::span<const T>(buffer),
+                                dest,
+                                exchange_tag + tag,
+                                false);
+    };
+
+    for (std::size_t src = 0; src < n_rank; ++src)
+    {
+      const auto n = recv_counts[src];
+      if (src == rank || n == 0)
+      {
+        continue;
+      }
+      auto& batch = incoming[src];
+      batch.model.resize(n * n_var);
+      batch.position.resize(n);
+      batch.ages.resize(n * 2);
+      post_recv(batch.model, src, 0);
+      post_recv(batch.position, src, 1);
+      post_recv(batch.ages, src, 2);
+      if constexpr (weighted)
+      {
+        batch.weights.resize(n);
+        post_recv(batch.weights, src, 3);
+      }
+    }
+
+    for (std::size_t dest = 0; dest < n_rank; ++dest)
+    {
+      const auto& batch = outgoing[dest];
+      if (dest == rank || batch.size() == 0)
+      {
+        continue;
+      }
+      post_send(batch.model, dest, 0);
+      post_send(batch.position, dest, 1);
+      post_send(batch.ages, dest, 2);
+      if constexpr (weighted)
+      {
+        post_send(batch.weights, dest, 3);
+      }
+    }
+
+    MPI_Waitall(static_cast<int>(requests.size()),
+                requests.data(),
+                MPI_STATUSES_IGNORE);
+
+    for (const auto& batch : incoming)
+    {
+      container.insert(batch);
+    }
+    return outside.size();
+  }
+#endif
+} // namespace
+
+DomainPartition::DomainPartition(std::vector<uint64_t> offsets)
+    : m_offsets(std::move(offsets))
+{
+  if (m_offsets.size() < 2 || m_offsets.front() != 0
+      || !std::ranges::is_sorted(m_offsets))
+  {
+    throw std::invalid_argument("Partition offsets are not increasing");
+  }
+}
+
+DomainPartition
+DomainPartition::balanced(std::span<const double> weights, std::size_t n_rank)
+{
+  const std::size_t n_compartments = weights.size();
+  if (n_rank == 0 || n_compartments < n_rank)
+  {
+    throw std::invalid_argument(
+        "Domain decomposition needs at least one compartment per rank");
+  }
+
+  const double total = std::accumulate(weights.begin(), weights.end(), 0.);
+  std::vector<uint64_t> offsets(n_rank + 1, 0);
+  offsets[n_rank] = n_compartments;
+
+  // Cut k is placed where the cumulative weight reaches k / n_rank of the
+  // total, leaving at least one compartment to each rank on both sides
+  double cumulative = 0.;
+  std::size_t c = 0;
+  for (std::size_t k = 1; k < n_rank; ++k)
+  {
+    const double target
+        = total * static_cast<double>(k) / static_cast<double>(n_rank);
+    const std::size_t first = offsets[k - 1] + 1;
+    const std::size_t last = n_compartments - (n_rank - k);
+    while (c < first || (c < last && cumulative + weights[c] / 2 < target))
+    {
+      cumulative += weights[c];
+      ++c;
+    }
+    offsets[k] = c;
+  }
+  return DomainPartition(std::move(offsets));
+}
+
+bool
+DomainPartition::enabled_from_env()
+{
+  return Common::read_env_or("BIOMC_DOMAIN_DECOMPOSITION", false);
+}
+
+uint32_t
+DomainPartition::owner(uint64_t compartment) const noexcept
+{
+  const auto it
+      = std::upper_bound(m_offsets.begin() + 1, m_offsets.end(), compartment);
+  return static_cast<uint32_t>(std::distance(m_offsets.begin() + 1, it));
+}
+
+DomainPartition
+make_domain_partition(const ExecInfo& exec,
+                      Simulation::SimulationUnit& simulation)
+{
+  auto& domain = simulation.getter().mc_unit()->domain;
+  const auto volumes = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace(), domain.get_const_inner().liquid_volume);
+  return DomainPartition::balanced(
+      std::span<const double>(volumes.data(), volumes.extent(0)),
+      exec.n_rank);
+}
+
+uint64_t
+exchange_particles([[maybe_unused]] const ExecInfo& exec,
+                   [[maybe_unused]] Simulation::SimulationUnit& simulation,
+                   [[maybe_unused]] const DomainPartition& partition)
+{
+  PROFILE_SECTION("exchange_particles")
+  uint64_t sent = 0;
+#ifndef NO_MPI
+  if (exec.n_rank < 2)
+  {
+    return 0;
+  }
+  sent = std::visit([&](auto& container)
+                    { return exchange(exec, container, partition); },
+                    simulation.getter().mc_unit()->container);
+#endif
+  return sent;
+}
@@ -1,4 +1,6 @@
+#include <common/env_var.hpp>
 #include <load_balancing/impl_lb.hpp>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 
@@ -72,3 +74,14 @@ BoundLoadBalancer::getRatio(uint64_t n, uint32_t rank) const noexcept
 
   return (rank == 0) ? beta : alpha;
 }
+
+std::unique_ptr<ILoadBalancer>
+lb_factory(uint32_t s)
+{
+  auto bounded = Common::read_env<uint32_t>("BIOMC_LBBOUND");
+  if (bounded)
+  {
+    return std::make_unique<BoundLoadBalancer>(s, *bounded);
+  }
+  return std::make_unique<UniformLoadBalancer>(s);
+}
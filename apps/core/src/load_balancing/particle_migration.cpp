@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <common/common.hpp>
+#include <common/env_var.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <load_balancing/particle_migration.hpp>
+#include <mc/unit.hpp>
+#include <numeric>
+#include <simulation/simulation.hpp>
+#include <span>
+#include <variant>
+#include <vector>
+
+#ifndef NO_MPI
+#  include <mpi_w/wrap_mpi.hpp>
+#endif
+
+namespace
+{
+#ifndef NO_MPI
+  // Distinct from iteration payload, signal and contribution tags
+  constexpr std::size_t migration_tag = 32;
+
+  template <typename Container>
+  uint64_t
+  apply_plan(const ExecInfo& exec,
+             Container& container,
+             std::span<const MigrationTransfer> transfers)
+  {
+    using F = typename Container::UsedModel::FloatType;
+    const auto rank = static_cast<uint32_t>(exec.current_rank);
+    uint64_t moved = 0;
+    // Transfers are processed in plan order on every rank. As senders never
+    // receive and receivers never send, the first pending transfer of the
+    // plan can always complete with blocking calls
+    for (const auto& t : transfers)
+    {
+      if (t.from == rank)
+      {
+        const auto batch = container.extract(t.n);
+        WrapMPI::send_v<F>(batch.model, t.to, migration_tag);
+        WrapMPI::send_v<uint64_t>(batch.position, t.to, migration_tag + 1);
+        WrapMPI::send_v<float>(batch.ages, t.to, migration_tag + 2);
+        WrapMPI::send_v<F>(batch.weights, t.to, migration_tag + 3);
+        moved += batch.size();
+      }
+      else if (t.to == rank)
+      {
+        MPI_Status status;
+        MC::ParticleBatch<F> batch;
+        batch.model = WrapMPI::try_recv_v<F>(t.from, &status, migration_tag);
+        batch.position = WrapMPI::try_recv_v<uint64_t>(
+            t.from, &status, migration_tag + 1);
+        batch.ages
+            = WrapMPI::try_recv_v<float>(t.from, &status, migration_tag + 2);
+        batch.weights
+            = WrapMPI::try_recv_v<F>(t.from, &status, migration_tag + 3);
+        container.insert(batch);
+        moved += batch.size();
+      }
+    }
+    return moved;
+  }
+#endif
+} // namespace
+
+ParticleMigration::ParticleMigration(Parameters _params) noexcept
+    : params(_params), calibrating(_params.calibration != 0)
+{
+}
+
+ParticleMigration::Parameters
+ParticleMigration::parameters_from_env()
+{
+  return {
+      .interval = Common::read_env_or("BIOMC_MIGRATION_INTERVAL", 0UL),
+      .trigger = Common::read_env_or("BIOMC_MIGRATION_TRIGGER", 0.1),
+      .tolerance = Common::read_env_or("BIOMC_MIGRATION_TOLERANCE", 0.02),
+      .calibration = Common::read_env_or("BIOMC_LB_CALIBRATION", 0UL),
+      .export_interval = 0,
+  };
+}
+
+void
+ParticleMigration::record_cycle(double seconds) noexcept
+{
+  cycle_time += seconds;
+  n_cycle++;
+}
+
+void
+ParticleMigration::record_host_work(double seconds) noexcept
+{
+  host_work += seconds;
+}
+
+void
+ParticleMigration::recalibrate() noexcept
+{
+  if (params.calibration == 0 || calibrating)
+  {
+    return;
+  }
+  // Steps measured before the change do not represent the new cost
+  calibrating = true;
+  cycle_time = 0.;
+  host_work = 0.;
+  n_cycle = 0;
+}
+
+uint64_t
+ParticleMigration::calibration_window() const noexcept
+{
+  return std::max(params.calibration, params.export_interval);
+}
+
+bool
+ParticleMigration::due() const noexcept
+{
+  return (params.interval != 0 && n_cycle >= params.interval)
+         || (calibrating && n_cycle >= calibration_window());
+}
+
+std::vector<MigrationTransfer>
+ParticleMigration::plan(std::span<const uint64_t> counts,
+                        std::span<const double> times,
+                        double trigger,
+                        double tolerance,
+                        std::span<const double> overheads)
+{
+  const std::size_t n_rank = counts.size();
+  const uint64_t total = std::accumulate(counts.begin(), counts.end(), 0UL);
+  if (n_rank < 2 || times.size() != n_rank || total == 0
+      || (!overheads.empty() && overheads.size() != n_rank))
+  {
+    return {};
+  }
+  const auto overhead = [overheads](std::size_t i)
+  { return overheads.empty() ? 0. : std::max(overheads[i], 0.); };
+
+  // Cost of one particle per rank, ranks without measure get the mean cost
+  std::vector<double> cost(n_rank, 0.);
+  double known_cost = 0.;
+  std::size_t n_known = 0;
+  for (std::size_t i = 0; i < n_rank; ++i)
+  {
+    if (times[i] > 0. && counts[i] != 0)
+    {
+      cost[i] = times[i] / static_cast<double>(counts[i]);
+      known_cost += cost[i];
+      n_known++;
+    }
+  }
+  const double default_cost
+      = (n_known != 0) ? known_cost / static_cast<double>(n_known) : 1.;
+
+  double max_time = 0.;
+  double sum_time = 0.;
+  for (std::size_t i = 0; i < n_rank; ++i)
+  {
+    if (cost[i] <= 0.)
+    {
+      cost[i] = default_cost;
+    }
+    const double predicted
+        = static_cast<double>(counts[i]) * cost[i] + overhead(i);
+    max_time = std::max(max_time, predicted);
+    sum_time += predicted;
+  }
+
+  const double mean_time = sum_time / static_cast<double>(n_rank);
+  if (max_time <= mean_time * (1. + trigger))
+  {
+    return {};
+  }
+
+  // Common step time T such that sum((T - overhead) / cost) = total, ranks
+  // whose overhead alone exceeds T get no particle and T is solved again
+  std::vector<bool> active(n_rank, true);
+  double step_time = 0.;
+  bool changed = true;
+  while (changed)
+  {
+    double sum_speed = 0.;
+    double sum_offset = 0.;
+    for (std::size_t i = 0; i < n_rank; ++i)
+    {
+      if (active[i])
+      {
+        sum_speed += 1. / cost[i];
+        sum_offset += overhead(i) / cost[i];
+      }
+    }
+    step_time = (static_cast<double>(total) + sum_offset) / sum_speed;
+    changed = false;
+    for (std::size_t i = 0; i < n_rank; ++i)
+    {
+      if (active[i] && overhead(i) >= step_time)
+      {
+        active[i] = false;
+        changed = true;
+      }
+    }
+  }
+
+  // Rounding remainder given in rank order
+  std::vector<uint64_t> target(n_rank, 0);
+  uint64_t allocated = 0;
+  for (std::size_t i = 0; i < n_rank; ++i)
+  {
+    if (active[i])
+    {
+      target[i] = std::min(
+          total - allocated,
+          static_cast<uint64_t>((step_time - overhead(i)) / cost[i]));
+      allocated += target[i];
+    }
+  }
+  for (std::size_t i = 0; allocated < total; i = (i + 1) % n_rank)
+  {
+    if (active[i])
+    {
+      target[i]++;
+      allocated++;
+    }
+  }
+
+  std::vector<uint64_t> surplus(n_rank, 0);
+  std::vector<uint64_t> deficit(n_rank, 0);
+  for (std::size_t i = 0; i < n_rank; ++i)
+  {
+    const auto band = static_cast<uint64_t>(tolerance
+                                            * static_cast<double>(target[i]));
+    if (counts[i] > target[i] + band)
+    {
+      surplus[i] = counts[i] - target[i];
+    }
+    else if (counts[i] + band < target[i])
+    {
+      deficit[i] = target[i] - counts[i];
+    }
+  }
+
+  std::vector<MigrationTransfer> transfers;
+  std::size_t j = 0;
+  for (std::size_t i = 0; i < n_rank; ++i)
+  {
+    while (surplus[i] != 0)
+    {
+      while (j < n_rank && deficit[j] == 0)
+      {
+        ++j;
+      }
+      if (j == n_rank)
+      {
+        return transfers;
+      }
+      const uint64_t n = std::min(surplus[i], deficit[j]);
+      transfers.push_back(
+          { static_cast<uint32_t>(i), static_cast<uint32_t>(j), n });
+      surplus[i] -= n;
+      deficit[j] -= n;
+    }
+  }
+  return transfers;
+}
+
+uint64_t
+ParticleMigration::rebalance(
+    [[maybe_unused]] const ExecInfo& exec,
+    [[maybe_unused]] Simulation::SimulationUnit& simulation)
+{
+  PROFILE_SECTION("particle_migration")
+  const double steps = static_cast<double>(std::max<uint64_t>(n_cycle, 1));
+  [[maybe_unused]] const double mean_cycle = cycle_time / steps;
+  [[maybe_unused]] const double mean_host_work = host_work / steps;
+  cycle_time = 0.;
+  host_work = 0.;
+  n_cycle = 0;
+  calibrating = false;
+
+  uint64_t moved = 0;
+#ifndef NO_MPI
+  if (exec.n_rank < 2)
+  {
+    return 0;
+  }
+  const auto& mc_unit = simulation.getter().mc_unit();
+  const auto counts = WrapMPI::all_gather<uint64_t>(
+      static_cast<uint64_t>(mc_unit->n_particle()), exec.n_rank);
+  const auto times = WrapMPI::all_gather<double>(mean_cycle, exec.n_rank);
+  const auto overheads
+      = WrapMPI::all_gather<double>(mean_host_work, exec.n_rank);
+  // Same inputs on every rank, hence the same plan
+  const auto transfers = plan(
+      counts, times, params.trigger, params.tolerance, overheads);
+  if (!transfers.empty())
+  {
+    moved = std::visit([&](auto& container)
+                       { return apply_plan(exec, container, transfers); },
+                       mc_unit->container);
+  }
+#endif
+  return moved;
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <common/env_var.hpp>
+#include <core/particle_statistics.hpp>
+#include <cstddef>
+#include <limits>
+
+namespace PostProcessing
+{
+
+  const StatisticsParameters&
+  StatisticsParameters::from_env()
+  {
+    static const StatisticsParameters parameters = []
+    {
+      StatisticsParameters res;
+      res.enabled = Common::read_env_or("BIOMC_DUMP_STATS", res.enabled);
+      res.n_bins = Common::read_env_or("BIOMC_DUMP_STATS_BINS", res.n_bins);
+      return res;
+    }();
+    return parameters;
+  }
+
+  void
+  prepare_histograms(ParticleStatistics& statistics)
+  {
+    const std::size_t n_var = statistics.n_var();
+    const std::size_t n_compartment = statistics.n_compartment;
+    const std::size_t n_bins = statistics.n_bins;
+    statistics.bin_edges
+        = StatisticsViewType<HostSpace>("bin_edges", n_var, n_bins + 1);
+
+    for (std::size_t k_var = 0; k_var < n_var; ++k_var)
+    {
+      double lower = std::numeric_limits<double>::max();
+      double upper = std::numeric_limits<double>::lowest();
+      for (std::size_t i_compartment = 0; i_compartment < n_compartment;
+           ++i_compartment)
+      {
+        const double count = statistics.count(0, i_compartment);
+        if (count == 0)
+        {
+          continue;
+        }
+        statistics.mean(k_var, i_compartment) /= count;
+        lower = std::min(lower, statistics.min(k_var, i_compartment));
+        upper = std::max(upper, statistics.max(k_var, i_compartment));
+      }
+      if (lower > upper)
+      {
+        // No particle on this rank
+        lower = 0.;
+        upper = 0.;
+      }
+      const double width
+          = (n_bins == 0) ? 0. : (upper - lower) / static_cast<double>(n_bins);
+      for (std::size_t i_bin = 0; i_bin <= n_bins; ++i_bin)
+      {
+        statistics.bin_edges(k_var, i_bin)
+            = lower + width * static_cast<double>(i_bin);
+      }
+    }
+  }
+
+  void
+  finalize_statistics(ParticleStatistics& statistics)
+  {
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    const auto& levels = ParticleStatistics::quantile_levels;
+    const std::size_t n_var = statistics.n_var();
+    const std::size_t n_compartment = statistics.n_compartment;
+    const std::size_t n_bins = statistics.n_bins;
+    const std::size_t n_quantile = (n_bins == 0) ? 0 : levels.size();
+    statistics.quantiles = StatisticsViewType<HostSpace>(
+        "quantiles", n_var, n_compartment * n_quantile);
+
+    for (std::size_t k_var = 0; k_var < n_var; ++k_var)
+    {
+      for (std::size_t i_compartment = 0; i_compartment < n_compartment;
+           ++i_compartment)
+      {
+        const double count = statistics.count(0, i_compartment);
+        // Row major, pointers stay valid without bins
+        double* quantiles = statistics.quantiles.data()
+                            + (k_var * n_compartment + i_compartment)
+                                  * n_quantile;
+        if (count == 0)
+        {
+          statistics.mean(k_var, i_compartment) = nan;
+          statistics.variance(k_var, i_compartment) = nan;
+          statistics.min(k_var, i_compartment) = nan;
+          statistics.max(k_var, i_compartment) = nan;
+          std::fill_n(quantiles, n_quantile, nan);
+          continue;
+        }
+        statistics.variance(k_var, i_compartment) /= count;
+
+        // Levels are increasing, bins are scanned once
+        const double* histogram
+            = statistics.histogram.data()
+              + (k_var * n_compartment + i_compartment) * n_bins;
+        double cumulative = 0.;
+        std::size_t i_bin = 0;
+        for (std::size_t i_q = 0; i_q < n_quantile; ++i_q)
+        {
+          const double target = levels[i_q] * count;
+          while (i_bin + 1 < n_bins && cumulative + histogram[i_bin] < target)
+          {
+            cumulative += histogram[i_bin];
+            ++i_bin;
+          }
+          const double in_bin = histogram[i_bin];
+          const double fraction
+              = (in_bin > 0) ? (target - cumulative) / in_bin : 0.;
+          const double lower = statistics.bin_edges(k_var, i_bin);
+          const double upper = statistics.bin_edges(k_var, i_bin + 1);
+          quantiles[i_q]
+              = std::clamp(lower + fraction * (upper - lower),
+                           statistics.min(k_var, i_compartment),
+                           statistics.max(k_var, i_compartment));
+        }
+      }
+    }
+  }
+
+} // namespace PostProcessing
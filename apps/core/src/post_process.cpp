@@ -1,9 +1,12 @@
 #include <Kokkos_Core.hpp>
 #include <Kokkos_ScatterView.hpp>
 #include <biocma_cst_config.hpp>
+#include <common/env_var.hpp>
 #include <common/execinfo.hpp>
 #include <common/logger.hpp>
+#include <core/particle_statistics.hpp>
 #include <core/post_process.hpp>
+#include <cstddef>
 #include <dataexporter/data_exporter.hpp>
 #include <impl_post_process.hpp>
 #include <mc/traits.hpp>
@@ -13,14 +16,20 @@
 #include <optional>
 #include <simulation/probe.hpp>
 #include <simulation/simulation_getter.hpp>
+#include <span>
+#include <string>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace
 {
-  void append_properties(int counter,
-                         const std::unique_ptr<MC::MonteCarloUnit>& mc_unit,
-                         Core::PartialExporter& partial_exporter,
-                         bool with_age);
+  std::optional<PostProcessing::BonceBuffer> get_particle_properties_device(
+      const std::unique_ptr<MC::MonteCarloUnit>& mc_unit, bool with_age);
+
+  std::optional<PostProcessing::DeviceBonceBuffer>
+  get_particle_properties_stream(
+      const std::unique_ptr<MC::MonteCarloUnit>& mc_unit, bool with_age);
 } // namespace
 
 namespace PostProcessing
@@ -28,55 +37,128 @@ namespace PostProcessing
 
   template <std::size_t buffer_size>
   void
-  _save_probes(Simulation::ProbeType ptype,
-               const Simulation::Probes<buffer_size>& probes,
-               Core::PartialExporter& pde,
-               bool force)
+  _snapshot_probes(Simulation::ProbeType ptype,
+                   const Simulation::Probes<buffer_size>& probes,
+                   std::vector<ProbeSnapshot>& snapshot,
+                   std::size_t& n_snapshot,
+                   bool force)
   {
     // TODO: Find out if comment is necessary or not
     if (probes.need_export() || force)
     {
-
-      pde.write_probe(
-          Simulation::map_probe_name[static_cast<std::size_t>(ptype)],
-          probes.get()); // probe.get only returns the used chunk of memory id:
-                         // buffer_size if need export else internal counter
+      if (n_snapshot == snapshot.size())
+      {
+        snapshot.emplace_back();
+      }
+      auto& [name, values] = snapshot[n_snapshot++];
+      name = Simulation::map_probe_name[static_cast<std::size_t>(ptype)];
+      // probe.get only returns the used chunk of memory id: buffer_size if
+      // need export else internal counter
+      const auto data = probes.get();
+      values.assign(data.begin(), data.end());
       probes.clear();
     }
   }
 
+  void
+  snapshot_probes(const Simulation::Getter& getter,
+                  std::vector<ProbeSnapshot>& snapshot,
+                  bool force)
+  {
+    std::size_t n_snapshot = 0;
+    // WARN: const everywhere but _snapshot_probes modifies
+    // internal probe state
+    for (const auto& [ptype, probes] : getter.it_probes())
+    {
+      _snapshot_probes(ptype, probes, snapshot, n_snapshot, force);
+    }
+    snapshot.resize(n_snapshot);
+  }
+
   void
   save_probes(const Simulation::Getter& getter,
               Core::PartialExporter& pde,
               bool force)
   {
-
-    // WARN: const everywhere but _save_probes modifies
-    // internal probe state
-    for (const auto& [ptype, probes] : getter.it_probes())
+    std::vector<ProbeSnapshot> snapshot;
+    snapshot_probes(getter, snapshot, force);
+    for (const auto& [name, values] : snapshot)
     {
-      _save_probes(ptype, probes, pde, force);
+      pde.write_probe(name, values);
     }
   }
   static int counter
       = 0; // TODO Remove static and reset to 0 when new simulation. If handle
            // is reused for two simulation as itś static counter is not reset
 
+  std::size_t
+  dump_memory_bound()
+  {
+    static const std::size_t bound = []
+    {
+      constexpr std::size_t mib = 1024 * 1024;
+      // Statistics are small, they are always gathered on host
+      if (StatisticsParameters::from_env().enabled)
+      {
+        return std::size_t{ 0 };
+      }
+      return Common::read_env_or("BIOMC_DUMP_MEMORY_MB", std::size_t{ 0 })
+             * mib;
+    }();
+    return bound;
+  }
+
+  std::optional<std::pair<std::string, BonceBuffer>>
+  snapshot_particle_state(const Simulation::Getter& getter)
+  {
+    auto dump = ::get_particle_properties_device(
+        getter.mc_unit(),
+        AutoGenerated::PostProcessing::FlagCompileTime::export_age);
+    const int current = counter++;
+    if (!dump.has_value())
+    {
+      return std::nullopt;
+    }
+    return std::make_pair(
+        "biological_model/" + std::to_string(current) + "/",
+        std::move(*dump));
+  }
+
   void
   save_particle_state(const Simulation::Getter& getter,
                       Core::PartialExporter& pde)
   {
-    ::append_properties(
-        counter,
-        getter.mc_unit(),
-        pde,
-        AutoGenerated::PostProcessing::FlagCompileTime::export_age);
-    counter++;
+    constexpr bool compress_data
+        = AutoGenerated::PostProcessing::FlagCompileTime::compress_export;
+    const std::size_t memory_bound = dump_memory_bound();
+    if (memory_bound != 0)
+    {
+      auto dump = ::get_particle_properties_stream(
+          getter.mc_unit(),
+          AutoGenerated::PostProcessing::FlagCompileTime::export_age);
+      const int current = counter++;
+      if (dump.has_value())
+      {
+        pde.write_particle_stream(
+            std::move(*dump),
+            "biological_model/" + std::to_string(current) + "/",
+            compress_data,
+            memory_bound);
+      }
+      return;
+    }
+
+    auto dump = snapshot_particle_state(getter);
+    if (dump.has_value())
+    {
+      pde.write_particle_data(
+          std::move(dump->second), dump->first, compress_data);
+    }
   }
 
   void
   final_post_processing(const std::shared_ptr<IO::Logger>& logger,
-                        [[maybe_unused]] const ExecInfo& exec,
+                        const ExecInfo& exec,
                         const Core::SimulationParameters& params,
                         const Simulation::Getter& getter,
                         const std::shared_ptr<Core::MainExporter>& mde)
@@ -89,7 +171,7 @@ namespace PostProcessing
 
     mde->write_final(getter, mc_unit.n_particle());
 
-    if constexpr (AutoGenerated::FlagCompileTime::enable_event_counter)
+    if (exec.kernel_options.instrumentation.event_counter())
     {
       auto removed = mc_unit.events.get<MC::EventType::Death>()
                      + mc_unit.events.get<MC::EventType::Exit>();
@@ -142,35 +224,81 @@ namespace PostProcessing
 namespace
 {
 
-  std::optional<PostProcessing::BonceBuffer> get_particle_properties_device(
-      const std::unique_ptr<MC::MonteCarloUnit>& mc_unit, bool with_age);
+  // Compartments of internal are columns or blocks of block consecutive
+  // columns, returned in flowmap numbering
+  ParticlePropertyViewType<HostSpace>
+  to_flowmap_numbering(const ParticlePropertyViewType<HostSpace>& internal,
+                       std::span<const std::size_t> new_to_old,
+                       std::size_t block = 1)
+  {
+    ParticlePropertyViewType<HostSpace> flowmap(
+        internal.label(), internal.extent(0), internal.extent(1));
+    for (std::size_t i = 0; i < internal.extent(0); ++i)
+    {
+      for (std::size_t j = 0; j < new_to_old.size(); ++j)
+      {
+        for (std::size_t k = 0; k < block; ++k)
+        {
+          flowmap(i, new_to_old[j] * block + k) = internal(i, j * block + k);
+        }
+      }
+    }
+    return flowmap;
+  }
 
-  void
-  append_properties(const int counter,
-                    const std::unique_ptr<MC::MonteCarloUnit>& mc_unit,
-                    Core::PartialExporter& partial_exporter,
-                    const bool with_age)
+  std::optional<PostProcessing::BonceBuffer>
+  get_particle_statistics_device(
+      const std::unique_ptr<MC::MonteCarloUnit>& mc_unit,
+      const std::size_t n_bins,
+      const bool with_age)
   {
-    constexpr bool compress_data
-        = AutoGenerated::PostProcessing::FlagCompileTime::compress_export;
-    auto dump = get_particle_properties_device(mc_unit, with_age);
-    if (dump.has_value())
+    const size_t n_compartment = mc_unit->domain.getNumberCompartments();
+    auto statistics = std::visit(
+        [n_compartment, n_bins, with_age](auto& container)
+        {
+          return PostProcessing::get_statistics(
+              container, n_compartment, n_bins, with_age);
+        },
+        mc_unit->container);
+    if (!statistics)
     {
-      std::string ds_name = "biological_model/" + std::to_string(counter) + "/";
-      partial_exporter.write_particle_data(
-          std::move(*dump), ds_name, compress_data);
+      return std::nullopt;
+    }
+
+    const auto new_to_old = mc_unit->domain.renumbering();
+    if (!new_to_old.empty())
+    {
+      auto& s = *statistics;
+      const std::size_t n_quantile
+          = (n_bins == 0) ? 0 : s.quantile_levels.size();
+      for (auto* view : { &s.count, &s.mean, &s.variance, &s.min, &s.max })
+      {
+        *view = to_flowmap_numbering(*view, new_to_old);
+      }
+      s.histogram = to_flowmap_numbering(s.histogram, new_to_old, n_bins);
+      s.quantiles = to_flowmap_numbering(s.quantiles, new_to_old, n_quantile);
     }
+
+    PostProcessing::BonceBuffer properties;
+    properties.statistics = std::move(statistics);
+    return properties;
   }
 
   std::optional<PostProcessing::BonceBuffer>
   get_particle_properties_device(
       const std::unique_ptr<MC::MonteCarloUnit>& mc_unit, bool with_age)
   {
+    // In situ reduction replaces raw particle values
+    const auto& stats = PostProcessing::StatisticsParameters::from_env();
+    if (stats.enabled)
+    {
+      return get_particle_statistics_device(mc_unit, stats.n_bins, with_age);
+    }
 
     // BonceBuffer properties;
     const size_t n_compartment = mc_unit->domain.getNumberCompartments();
 
-    return std::visit(
+    auto properties = std::visit(
         [n_compartment, with_age](auto& container)
         {
           using CurrentModel = typename std::remove_reference<
@@ -179,6 +307,40 @@ namespace
               container, n_compartment, with_age);
         },
         mc_unit->container);
+
+    // Spatial values are exported in flowmap numbering
+    const auto new_to_old = mc_unit->domain.renumbering();
+    if (properties && properties->spatial_values && !new_to_old.empty())
+    {
+      properties->spatial_values
+          = to_flowmap_numbering(*properties->spatial_values, new_to_old);
+    }
+    return properties;
+  }
+
+  std::optional<PostProcessing::DeviceBonceBuffer>
+  get_particle_properties_stream(
+      const std::unique_ptr<MC::MonteCarloUnit>& mc_unit, bool with_age)
+  {
+    const size_t n_compartment = mc_unit->domain.getNumberCompartments();
+
+    auto properties = std::visit(
+        [n_compartment, with_age](auto& container)
+        {
+          using CurrentModel = typename std::remove_reference<
+              decltype(container)>::type::UsedModel;
+          return PostProcessing::get_stream_properties<CurrentModel>(
+              container, n_compartment, with_age);
+        },
+        mc_unit->container);
+
+    const auto new_to_old = mc_unit->domain.renumbering();
+    if (properties && properties->spatial_values && !new_to_old.empty())
+    {
+      properties->spatial_values
+          = to_flowmap_numbering(*properties->spatial_values, new_to_old);
+    }
+    return properties;
   }
 
 } // namespace
@@ -10,20 +10,35 @@
 #  include <cereal/types/tuple.hpp>
 #  include <cereal/types/variant.hpp> //MC::Unit use variant internally
 #  include <cereal/types/vector.hpp>  //MC::List use vector internally
+#  include <algorithm>
 #  include <common/execinfo.hpp>
 #  include <core/global_initaliser.hpp>
 #  include <cstdint>
+#  include <filesystem>
 #  include <fstream>
 #  include <ios>
+#  include <load_balancing/checkpoint_layout.hpp>
+#  include <load_balancing/iload_balancer.hpp>
 #  include <mc/unit.hpp>
 #  include <memory>
 #  include <optional>
 #  include <serde.hpp>
 #  include <simulation/scalar_initializer.hpp>
 #  include <simulation/simulation.hpp>
+#  include <span>
+#  include <sstream>
 #  include <stdexcept>
+#  include <string>
 #  include <string_view>
+#  include <type_traits>
+#  include <utility>
+#  include <variant>
 #  include <vector>
+
+#  ifndef NO_MPI
+#    include <mpi_w/wrap_mpi.hpp>
+#  endif
+
 static void
 write_to_file(const std::ostringstream& oss, std::string_view filename)
 {
@@ -59,6 +74,247 @@ read_file(std::stringstream& buffer, std::string_view filename)
 using Archive_t = cereal::BinaryOutputArchive;
 using iArchive_t = cereal::BinaryInputArchive;
 
+namespace
+{
+  /**
+   * @brief State shared by every shard of a checkpoint, written by rank 0
+   *
+   * Scalars and contributions are the ones of rank 0 (workers may only hold
+   * a part of the concentrations), particle counts give the global particle
+   * index of the shards.
+   */
+  struct CheckpointManifest
+  {
+    std::string version;
+    ExecInfo exec;
+    std::vector<uint64_t> counts;
+    uint64_t number_particle{};
+    Simulation::Dimensions dims;
+    std::vector<double> c_liq;
+    std::optional<std::vector<double>> c_gas;
+    std::vector<double> contributions;
+    double time{};
+    uint64_t seed{};
+
+    template <class Archive>
+    void
+    serialize(Archive& ar)
+    {
+      ar(version,
+         exec,
+         counts,
+         number_particle,
+         dims,
+         c_liq,
+         c_gas,
+         contributions,
+         time,
+         seed);
+    }
+  };
+
+  std::string
+  shard_name(std::string_view prefix, uint64_t shard)
+  {
+    return std::string(prefix) + std::to_string(shard) + ".raw";
+  }
+
+  std::string
+  manifest_name(std::string_view prefix)
+  {
+    return std::string(prefix) + "manifest.raw";
+  }
+
+  // Distinct streams for every rank of a restart, chained from the seed of
+  // rank 0 when the checkpoint was written (splitmix64 finalizer)
+  uint64_t
+  restart_seed(uint64_t seed, uint64_t rank) noexcept
+  {
+    uint64_t z = seed + (rank + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31U;
+    return z != 0 ? z : 1; // 0 draws a random seed
+  }
+
+  /**
+   * @brief Read MC unit of a shard, scalar header is skipped
+   */
+  std::unique_ptr<MC::MonteCarloUnit>
+  read_shard(const std::string& filename)
+  {
+    std::stringstream buffer;
+    read_file(buffer, filename);
+    iArchive_t ar(buffer);
+
+    std::string version;
+    ExecInfo exec{};
+    uint64_t np = 0;
+    Simulation::Dimensions dims;
+    std::vector<double> c_liq;
+    std::optional<std::vector<double>> c_gas;
+    double time{};
+    ar(version, exec, np, dims, c_liq, c_gas, time);
+
+    std::unique_ptr<MC::MonteCarloUnit> mc_unit;
+    ar(mc_unit);
+    if (mc_unit == nullptr)
+    {
+      throw std::runtime_error("Cannot read checkpoint shard " + filename);
+    }
+    return mc_unit;
+  }
+
+  /**
+   * @brief Particles [first, last) of container, which is left empty
+   */
+  template <typename Container>
+  auto
+  take_slice(Container& container, uint64_t first, uint64_t last)
+  {
+    const auto n = container.n_particles();
+    (void)container.extract(n - last);
+    auto batch = container.extract(last - first);
+    (void)container.extract(first);
+    return batch;
+  }
+
+  void
+  check_count(const MC::MonteCarloUnit& unit,
+              const CheckpointManifest& manifest,
+              uint64_t shard)
+  {
+    if (unit.n_particle() != manifest.counts[shard])
+    {
+      throw std::runtime_error("Checkpoint shard " + std::to_string(shard)
+                               + " does not match manifest");
+    }
+  }
+
+  /**
+   * @brief MC unit holding the particles of the global range of the calling
+   * rank. Domain and events come from the first shard read, particles keep
+   * the global index order.
+   */
+  std::unique_ptr<MC::MonteCarloUnit>
+  gather_particles(const ExecInfo& exec,
+                   const CheckpointManifest& manifest,
+                   std::string_view prefix)
+  {
+    const CheckpointLayout layout(manifest.counts);
+    if (layout.n_shard() == 0)
+    {
+      throw std::runtime_error("Checkpoint manifest has no shard");
+    }
+    const auto balancer = lb_factory(exec.n_rank);
+    const auto [begin, end]
+        = CheckpointLayout::rank_range(*balancer,
+                                       static_cast<uint32_t>(exec.current_rank),
+                                       static_cast<uint32_t>(exec.n_rank),
+                                       layout.total());
+    const auto slices = layout.slices(begin, end);
+
+    const uint64_t base_shard = slices.empty() ? 0 : slices.front().shard;
+    auto mc_unit = read_shard(shard_name(prefix, base_shard));
+    check_count(*mc_unit, manifest, base_shard);
+
+    std::visit(
+        [&](auto& container)
+        {
+          using Container = std::decay_t<decltype(container)>;
+          using Batch = decltype(container.extract(0));
+          std::vector<Batch> batches;
+          batches.reserve(slices.size());
+          for (const auto& slice : slices)
+          {
+            if (slice.shard == base_shard)
+            {
+              batches.emplace_back(
+                  take_slice(container, slice.first, slice.last));
+              continue;
+            }
+            auto other = read_shard(shard_name(prefix, slice.shard));
+            check_count(*other, manifest, slice.shard);
+            auto* other_container = std::get_if<Container>(&other->container);
+            if (other_container == nullptr)
+            {
+              throw std::runtime_error(
+                  "Checkpoint shards use different models");
+            }
+            batches.emplace_back(
+                take_slice(*other_container, slice.first, slice.last));
+          }
+
+          (void)container.extract(container.n_particles());
+          for (const auto& batch : batches)
+          {
+            container.insert(batch);
+          }
+        },
+        mc_unit->container);
+
+    // Tallies are cleared at each export, only one rank keeps the remaining
+    // ones
+    if (exec.current_rank != 0)
+    {
+      mc_unit->events.clear();
+    }
+    mc_unit->rng = MC::KPRNG(restart_seed(manifest.seed, exec.current_rank));
+    return mc_unit;
+  }
+
+  /**
+   * @brief Gather the particle count of every shard and write the manifest
+   * on rank 0. Collective.
+   */
+  void
+  save_manifest(const Core::CaseData& case_data, std::string_view prefix)
+  {
+    const auto& exec = case_data.exec_info;
+    auto accessor = case_data.simulation->getter();
+    const uint64_t count = accessor.mc_unit()->n_particle();
+    std::vector<uint64_t> counts = { count };
+#  ifndef NO_MPI
+    if (exec.n_rank > 1)
+    {
+      counts = WrapMPI::gather<uint64_t>(std::span<const uint64_t>(&count, 1),
+                                         exec.n_rank);
+    }
+#  endif
+    if (exec.current_rank != 0)
+    {
+      return;
+    }
+
+    CheckpointManifest manifest;
+    manifest.version = ExecInfo::get_version();
+    manifest.exec = exec;
+    manifest.counts = std::move(counts);
+    manifest.number_particle = case_data.params.number_particle;
+    manifest.dims = accessor.getDimensions();
+    const auto cliq = accessor.getCliqData();
+    manifest.c_liq.assign(cliq.begin(), cliq.end());
+    const auto cgas = accessor.getCgasData();
+    if (cgas.has_value())
+    {
+      manifest.c_gas = std::vector<double>(cgas->begin(), cgas->end());
+    }
+    // Reduced contributions of the last step, not yet used by the scalar
+    // step
+    const auto contributions = accessor.getContributionData_mut();
+    manifest.contributions.assign(contributions.begin(), contributions.end());
+    manifest.time = accessor.absolute_time();
+    manifest.seed = accessor.mc_unit()->rng.get_seed();
+
+    std::ostringstream buf(std::ios::binary);
+    {
+      Archive_t ar(buf);
+      ar(manifest);
+    }
+    write_to_file(buf, manifest_name(prefix));
+  }
+} // namespace
+
 namespace SerDe
 {
 
@@ -66,9 +322,7 @@ namespace SerDe
   save_simulation(const Core::CaseData& case_data)
   {
 
-    std::stringstream serde_name;
-    serde_name << case_data.params.results_file_name << "_serde_"
-               << case_data.exec_info.current_rank << ".raw";
+    const std::string prefix = case_data.params.results_file_name + "_serde_";
 
     std::ostringstream buf(std::ios::binary);
     {
@@ -100,7 +354,8 @@ namespace SerDe
 
       ar(accessor.mc_unit());
     }
-    write_to_file(buf, serde_name.str());
+    write_to_file(buf, shard_name(prefix, case_data.exec_info.current_rank));
+    save_manifest(case_data, prefix);
   }
 
   std::optional<Simulation::ScalarInitializer>
@@ -144,30 +399,20 @@ namespace SerDe
     return sc;
   }
 
-  bool
-  load_simulation(Core::GlobalInitialiser& gi,
-                  Core::CaseData& case_data,
-                  std::string_view ser_filename)
+  /**
+   * @brief Build simulation from a loaded MC unit and scalar state, common to
+   * per rank and sharded checkpoints
+   */
+  static bool
+  init_loaded_simulation(Core::GlobalInitialiser& gi,
+                         Core::CaseData& case_data,
+                         std::unique_ptr<MC::MonteCarloUnit>&& mc_unit,
+                         const Simulation::Dimensions& dims,
+                         std::vector<double>&& read_c_liq,
+                         std::optional<std::vector<double>>&& read_c_gas,
+                         double start_time,
+                         uint64_t np)
   {
-
-    std::stringstream buffer;
-    read_file(buffer, ser_filename);
-
-    iArchive_t ar(buffer);
-
-    std::string version;
-    ExecInfo serde_exec{};
-    ar(version, serde_exec);
-
-    case_data.exec_info.run_id = serde_exec.run_id;
-
-    uint64_t np = 0;
-    Simulation::Dimensions dims;
-    std::vector<double> read_c_liq;
-    std::optional<std::vector<double>> read_c_gas;
-    double start_time{};
-    ar(np, dims, read_c_liq, read_c_gas, start_time);
-
     auto sc = build_scalar_init(
         gi, dims, std::move(read_c_liq), std::move(read_c_gas));
 
@@ -177,10 +422,6 @@ namespace SerDe
       return false;
     }
 
-    std::unique_ptr<MC::MonteCarloUnit> mc_unit;
-    ar(mc_unit);
-    assert(mc_unit != nullptr);
-
 #  warning message("MTR model is not loaded")
     auto simulation = gi.init_simulation(std::move(mc_unit), std::move(*sc));
 
@@ -219,6 +460,93 @@ namespace SerDe
     return true;
   }
 
+  bool
+  load_simulation(Core::GlobalInitialiser& gi,
+                  Core::CaseData& case_data,
+                  std::string_view ser_filename)
+  {
+
+    std::stringstream buffer;
+    read_file(buffer, ser_filename);
+
+    iArchive_t ar(buffer);
+
+    std::string version;
+    ExecInfo serde_exec{};
+    ar(version, serde_exec);
+
+    case_data.exec_info.run_id = serde_exec.run_id;
+
+    uint64_t np = 0;
+    Simulation::Dimensions dims;
+    std::vector<double> read_c_liq;
+    std::optional<std::vector<double>> read_c_gas;
+    double start_time{};
+    ar(np, dims, read_c_liq, read_c_gas, start_time);
+
+    std::unique_ptr<MC::MonteCarloUnit> mc_unit;
+    ar(mc_unit);
+    assert(mc_unit != nullptr);
+
+    return init_loaded_simulation(gi,
+                                  case_data,
+                                  std::move(mc_unit),
+                                  dims,
+                                  std::move(read_c_liq),
+                                  std::move(read_c_gas),
+                                  start_time,
+                                  np);
+  }
+
+  bool
+  load_checkpoint(Core::GlobalInitialiser& gi,
+                  Core::CaseData& case_data,
+                  std::string_view prefix)
+  {
+    const auto& exec = case_data.exec_info;
+    const auto manifest_file = manifest_name(prefix);
+    if (!std::filesystem::exists(manifest_file))
+    {
+      // Checkpoint written before manifests, same rank count only
+      return load_simulation(
+          gi, case_data, shard_name(prefix, exec.current_rank));
+    }
+
+    CheckpointManifest manifest;
+    {
+      std::stringstream buffer;
+      read_file(buffer, manifest_file);
+      iArchive_t ar(buffer);
+      ar(manifest);
+    }
+    case_data.exec_info.run_id = manifest.exec.run_id;
+
+    auto mc_unit = gather_particles(exec, manifest, prefix);
+    const bool ok = init_loaded_simulation(gi,
+                                           case_data,
+                                           std::move(mc_unit),
+                                           manifest.dims,
+                                           std::move(manifest.c_liq),
+                                           std::move(manifest.c_gas),
+                                           manifest.time,
+                                           manifest.number_particle);
+    if (!ok)
+    {
+      return false;
+    }
+
+    // Host applies the contributions of the last saved step at its first
+    // scalar step, workers clear theirs before their first cycle
+    auto contributions
+        = case_data.simulation->getter().getContributionData_mut();
+    if (exec.current_rank == 0
+        && contributions.size() == manifest.contributions.size())
+    {
+      std::ranges::copy(manifest.contributions, contributions.begin());
+    }
+    return true;
+  }
+
 } // namespace SerDe
 
 #endif // USE_CEAREAL
@@ -57,6 +57,7 @@ namespace Core
       .results_file_name = "",
       .cma_case_path = "",
       .serde_file = std::nullopt,
+      .instrumentation = std::nullopt,
     };
   }
 
@@ -83,6 +84,11 @@ namespace Core
            << "  Serde File: "
            << (params.serde_file.has_value() ? params.serde_file.value()
                                              : "nullopt")
+           << "\n"
+           << "  Instrumentation: "
+           << (params.instrumentation.has_value()
+                   ? params.instrumentation.value()
+                   : "nullopt")
            << "\n";
     return stream;
   }
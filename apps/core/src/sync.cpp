@@ -1,5 +1,8 @@
 #include <biocma_cst_config.hpp>
+#include <common/env_var.hpp>
 #include <cstddef>
+#include <load_balancing/domain_partition.hpp>
+#include <memory>
 #include <mc/domain.hpp>
 #include <mc/events.hpp>
 #include <simulation/simulation.hpp>
@@ -35,52 +38,186 @@ namespace WrapMPI
 // NOLINTEND
 #endif
 
+#ifndef NO_MPI
+std::unique_ptr<WrapMPI::CompressedExchange>
+make_sync_compression(Simulation::SimulationUnit& simulation)
+{
+  const auto level = Common::read_env_or("BIOMC_MPI_COMPRESSION", 0);
+  if (level <= 0)
+  {
+    return nullptr;
+  }
+  const WrapMPI::CompressionPolicy policy{ .allow_float32 = level >= 2 };
+  return std::make_unique<WrapMPI::CompressedExchange>(
+      policy, simulation.getter().getCliqData_mut().size());
+}
+
+std::unique_ptr<WrapMPI::SharedBroadcast>
+make_sync_shared(Simulation::SimulationUnit& simulation)
+{
+  // Ranks of a decomposed domain only hold their own concentrations
+  if (!Common::read_env_or("BIOMC_MPI_SHARED_MEMORY", false)
+      || DomainPartition::enabled_from_env())
+  {
+    return nullptr;
+  }
+  constexpr bool in_place = Simulation::SimulationUnit::host_aliases_device;
+  auto shared = std::make_unique<WrapMPI::SharedBroadcast>(
+      simulation.getter().getCliqData_mut().size(), 0, in_place);
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (in_place && rank != 0)
+  {
+    // Host keeps its concentrations, it integrates them
+    simulation.alias_concentration(shared->node_values());
+  }
+  return shared;
+}
+
+std::unique_ptr<WrapMPI::NodeSharedMemory>
+make_sync_tables()
+{
+  if (!Simulation::SimulationUnit::host_aliases_device
+      || !Common::read_env_or("BIOMC_MPI_SHARED_MEMORY", false)
+      || DomainPartition::enabled_from_env())
+  {
+    return nullptr;
+  }
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  return std::make_unique<WrapMPI::NodeSharedMemory>(rank != 0);
+}
+
 void
-sync_step(const ExecInfo& exec, Simulation::SimulationUnit& simulation)
+sync_update_hydro(Simulation::SimulationUnit& simulation,
+                  WrapMPI::IterationPayload& payload,
+                  const SyncExchange& exchange)
 {
+  auto* const tables = exchange.tables;
+  if (tables != nullptr)
+  {
+    if (!tables->is_allocated())
+    {
+      // Size is known from the first flowmap, the number of neighbors is
+      // the same for the next ones
+      const auto n_compartments = payload.liquid_volumes.size();
+      const auto n_neighbors
+          = payload.liquid_neighbors_flat.size() / n_compartments;
+      const auto memory = tables->allocate(
+          MC::ReactorDomain::shared_tables_size(n_compartments, n_neighbors));
+      simulation.share_domain_tables(
+          memory, n_neighbors, tables->is_writer());
+    }
+    // Workers of the node are done with the previous tables
+    tables->barrier();
+  }
+  simulation.updateMCHydro(payload.liquid_volumes,
+                           payload.liquid_neighbors_flat,
+                           payload.proba_leaving_flat,
+                           payload.liquid_out_flows);
+  if (tables != nullptr)
+  {
+    // Tables are written before any worker of the node runs its next cycle
+    tables->barrier();
+  }
+}
+#endif
 
-  // Sync is not needed in shared mode because only one unit is used in this
-  // case, furthermore, barrier is already handled by kokkos at the end of
-  // cycling process
+void
+sync_contributions_start([[maybe_unused]] const ExecInfo& exec,
+                         Simulation::SimulationUnit& simulation,
+                         [[maybe_unused]] MPI_Request* request,
+                         [[maybe_unused]] const SyncExchange& exchange)
+{
+  // Nothing to reduce in shared mode because only one unit is used in this
+  // case
   if constexpr (AutoGenerated::FlagCompileTime::use_mpi)
   {
-    PROFILE_SECTION("sync_step")
+    PROFILE_SECTION("sync_contributions_start")
 #ifndef NO_MPI
-    WrapMPI::barrier();
-    if (exec.current_rank == 0)
+    // Host reduces in place, workers send their local contributions. The
+    // buffer must not be modified until sync_step completes the request
+    auto contributions = simulation.getter().getContributionData_mut();
+    if (exchange.partition != nullptr)
     {
-
-      auto liquid_buffer
-          = simulation.getter()
-                .getContributionData_mut(); // Get the span of array on
-                                            // which reduction happend
-      MPI_Reduce(MPI_IN_PLACE,
-                 liquid_buffer.data(),
-                 liquid_buffer.size(),
-                 MPI_DOUBLE,
-                 MPI_SUM,
-                 0,
-                 MPI_COMM_WORLD);
+      // Ranks only contribute to the compartments they own
+      // Contributions are species major (LayoutRight)
+      exchange.partition->gather(
+          contributions,
+          WrapMPI::PartitionedExchange::Layout::SpeciesMajor,
+          0,
+          exec.current_rank,
+          *request);
+    }
+    else if (exchange.compression == nullptr)
+    {
+      WrapMPI::Async::reduce_sum_span(
+          contributions, 0, exec.current_rank == 0, *request);
+    }
+    else if (exec.current_rank == 0)
+    {
+      exchange.compression->recv_contributions(
+          contributions.size(), 0, exec.n_rank);
     }
     else
     {
-
-      const auto local_contribution
-          = simulation.getter()
-                .getContributionData(); // Get the span of array
-                                        // that are add to reduction
-      MPI_Reduce(local_contribution.data(),
-                 nullptr,
-                 local_contribution.size(),
-                 MPI_DOUBLE,
-                 MPI_SUM,
-                 0,
-                 MPI_COMM_WORLD);
+      exchange.compression->send_contributions(contributions, 0, *request);
     }
-    WrapMPI::barrier();
 #else
     (void)simulation;
-    (void)exec;
+#endif
+  }
+}
+
+void
+sync_step([[maybe_unused]] const ExecInfo& exec,
+          [[maybe_unused]] Simulation::SimulationUnit& simulation,
+          [[maybe_unused]] MPI_Request* request,
+          [[maybe_unused]] const SyncExchange& exchange)
+{
+  // No barrier: the reduction is ordered with the other collectives and
+  // completing it is enough for the host to read summed contributions
+  if constexpr (AutoGenerated::FlagCompileTime::use_mpi)
+  {
+    PROFILE_SECTION("sync_step")
+#ifndef NO_MPI
+    WrapMPI::Async::wait(*request);
+    if (exchange.partition == nullptr && exchange.compression != nullptr
+        && exec.current_rank == 0)
+    {
+      exchange.compression->wait_add_contributions(
+          simulation.getter().getContributionData_mut());
+    }
+#endif
+  }
+}
+
+void
+sync_release([[maybe_unused]] Simulation::SimulationUnit& simulation,
+             [[maybe_unused]] MPI_Request* request,
+             [[maybe_unused]] const SyncExchange& exchange)
+{
+  if constexpr (AutoGenerated::FlagCompileTime::use_mpi)
+  {
+#ifndef NO_MPI
+    WrapMPI::Async::free(*request);
+    if (exchange.compression != nullptr)
+    {
+      exchange.compression->wait_pending();
+    }
+    if (exchange.shared != nullptr || exchange.tables != nullptr)
+    {
+      // Views of the simulation must not outlive the node windows
+      simulation.own_shared_memory();
+    }
+    if (exchange.shared != nullptr)
+    {
+      exchange.shared->release();
+    }
+    if (exchange.tables != nullptr)
+    {
+      exchange.tables->release();
+    }
 #endif
   }
 }
@@ -88,7 +225,8 @@ sync_step(const ExecInfo& exec, Simulation::SimulationUnit& simulation)
 void
 sync_prepare_next([[maybe_unused]] const ExecInfo& exec,
                   Simulation::SimulationUnit& simulation,
-                  [[maybe_unused]] MPI_Request* request)
+                  [[maybe_unused]] MPI_Request* request,
+                  [[maybe_unused]] const SyncExchange& exchange)
 {
   PROFILE_SECTION("sync_prepare_next")
   simulation.clearContribution();
@@ -109,8 +247,57 @@ sync_prepare_next([[maybe_unused]] const ExecInfo& exec,
         = simulation.getter()
               .getCliqData_mut(); // Get concentration ptr wrapped into span
 
-    WrapMPI::barrier();
-    WrapMPI::Async::broadcast_span(data, 0, *request);
+    if (exchange.partition != nullptr)
+    {
+      // Concentrations are compartment major (LayoutLeft)
+      exchange.partition->scatter(
+          data,
+          WrapMPI::PartitionedExchange::Layout::CompartmentMajor,
+          0,
+          exec.current_rank,
+          *request);
+    }
+    else if (exchange.shared != nullptr)
+    {
+      // Only node leaders take part in the inter-node broadcast
+      exchange.shared->start(data, *request);
+    }
+    else if (exchange.compression == nullptr)
+    {
+      WrapMPI::Async::broadcast_span(data, 0, *request);
+    }
+    else
+    {
+      exchange.compression->broadcast_concentration(
+          data, 0, exec.current_rank == 0, *request);
+    }
+#endif
+  }
+}
+
+void
+sync_wait_next([[maybe_unused]] const ExecInfo& exec,
+               [[maybe_unused]] Simulation::SimulationUnit& simulation,
+               [[maybe_unused]] MPI_Request* request,
+               [[maybe_unused]] const SyncExchange& exchange)
+{
+  if constexpr (AutoGenerated::FlagCompileTime::use_mpi)
+  {
+#ifndef NO_MPI
+    WrapMPI::Async::wait(*request);
+    if (exchange.partition != nullptr)
+    {
+      return;
+    }
+    if (exchange.shared != nullptr)
+    {
+      exchange.shared->finish(simulation.getter().getCliqData_mut());
+    }
+    else if (exchange.compression != nullptr && exec.current_rank != 0)
+    {
+      exchange.compression->finish_concentration(
+          simulation.getter().getCliqData_mut());
+    }
 #endif
   }
 }
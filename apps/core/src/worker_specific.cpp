@@ -2,10 +2,16 @@
 
 #ifndef NO_MPI
 #  include "biocma_cst_config.hpp"
+#  include <chrono>
+#  include <common/env_var.hpp>
 #  include <csignal>
 #  include <impl_post_process.hpp>
+#  include <load_balancing/domain_partition.hpp>
+#  include <load_balancing/particle_migration.hpp>
+#  include <memory>
 #  include <mpi_w/iteration_payload.hpp>
 #  include <mpi_w/wrap_mpi.hpp>
+#  include <optional>
 #  include <simulation/simulation.hpp>
 #  include <sync.hpp>
 #  include <worker_specific.hpp>
@@ -15,13 +21,11 @@ namespace
   inline void
   update_callback(WrapMPI::IterationPayload& payload,
                   MPI_Status& status,
-                  Simulation::SimulationUnit& simulation)
+                  Simulation::SimulationUnit& simulation,
+                  const SyncExchange& sync_exchange)
   {
     payload.recv(0, &status);
-    simulation.updateMCHydro(payload.liquid_volumes,
-                             payload.liquid_neighbors_flat,
-                             payload.proba_leaving_flat,
-                             payload.liquid_out_flows);
+    sync_update_hydro(simulation, payload, sync_exchange);
   }
 }
 
@@ -37,18 +41,40 @@ workers_process([[maybe_unused]] std::shared_ptr<IO::Logger> logger,
   size_t n_compartments = getter.mc_unit()->domain.getNumberCompartments();
   MPI_Status status;
   MPI_Request req;
+  MPI_Request reduce_req = MPI_REQUEST_NULL;
+  // Collective, created first on host and workers
+  WrapMPI::CommandChannel commands(
+      0,
+      std::chrono::microseconds(
+          Common::read_env_or("BIOMC_WORKER_BACKOFF_US", 100L)));
+  const auto compression = make_sync_compression(simulation);
+  const auto shared = make_sync_shared(simulation);
+  const auto tables = make_sync_tables();
+  SyncExchange sync_exchange{ .compression = compression.get(),
+                              .shared = shared.get(),
+                              .tables = tables.get() };
+  // Particles stay in the compartments of their rank, migration would break
+  // ownership
+  const bool decomposition = DomainPartition::enabled_from_env();
+  std::optional<DomainPartition> partition;
+  std::unique_ptr<WrapMPI::PartitionedExchange> partitioned;
+  ParticleMigration migration(
+      decomposition ? ParticleMigration::Parameters{}
+                    : ParticleMigration::parameters_from_env());
   const bool do_export = true; // TODO
 
   WrapMPI::IterationPayload payload(n_compartments);
+  const auto instrumentation = exec.kernel_options.instrumentation;
 
   const auto export_callback
-      = [&partial_exporter, &getter]([[maybe_unused]] const auto& container)
+      = [&partial_exporter, &getter, instrumentation](
+            [[maybe_unused]] const auto& container)
   {
     PROFILE_SECTION("worker:dump")
     // FIXME:
     // WARNING write_tally must be  BEFORE write_number_particle because
     // partial_exporter increase iteration counter after write_number_particle
-    if constexpr (AutoGenerated::FlagCompileTime::enable_event_counter)
+    if (instrumentation.event_counter())
     {
       partial_exporter.write_tally(getter.mc_unit()->events.get_span());
       getter.mc_unit()->events.clear();
@@ -56,12 +82,12 @@ workers_process([[maybe_unused]] std::shared_ptr<IO::Logger> logger,
 
     partial_exporter.write_number_particle(getter.mc_unit()->getRepartition());
 
-    if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+    if (instrumentation.probe())
     {
       PostProcessing::save_probes(getter, partial_exporter, false);
     }
 
-    if constexpr (AutoGenerated::FlagCompileTime::dump_particle_state)
+    if (instrumentation.dump_particle_state())
     {
       PostProcessing::save_particle_state(getter, partial_exporter);
     }
@@ -72,14 +98,19 @@ workers_process([[maybe_unused]] std::shared_ptr<IO::Logger> logger,
          &simulation,
          &partial_exporter,
          &getter,
-         &do_export = std::as_const(do_export)](auto& container)
+         &do_export = std::as_const(do_export),
+         &reduce_req,
+         &sync_exchange = std::as_const(sync_exchange),
+         instrumentation](auto& container)
   {
+    sync_release(simulation, &reduce_req, sync_exchange);
+
     if (do_export)
     {
       // FIXME:
       // WARNING write_tally must be  BEFORE write_number_particle because
       // partial_exporter increase iteration counter after write_number_particle
-      if constexpr (AutoGenerated::FlagCompileTime::enable_event_counter)
+      if (instrumentation.event_counter())
       {
         partial_exporter.write_tally(getter.mc_unit()->events.get_span());
         getter.mc_unit()->events.clear();
@@ -87,7 +118,7 @@ workers_process([[maybe_unused]] std::shared_ptr<IO::Logger> logger,
 
       partial_exporter.write_number_particle(
           getter.mc_unit()->getRepartition());
-      if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+      if (instrumentation.probe())
       {
         PostProcessing::save_probes(getter, partial_exporter);
       }
@@ -106,18 +137,49 @@ workers_process([[maybe_unused]] std::shared_ptr<IO::Logger> logger,
   };
 
   const auto cycle_callback
-      = [&exec = std::as_const(exec), &simulation, &req, d_t](
-            double& current_time, auto& container, auto& functors)
+      = [&exec = std::as_const(exec),
+         &simulation,
+         &req,
+         &reduce_req,
+         &migration,
+         &sync_exchange,
+         &partition,
+         &partitioned,
+         decomposition,
+         d_t](double& current_time, auto& container, auto& functors)
   {
-    sync_step(exec, simulation);
-    sync_prepare_next(exec, simulation, &req);
+    if (decomposition && !partition)
+    {
+      // First hydro update is received before the first cycle, the domain
+      // and its numbering are the same as on host
+      partition.emplace(make_domain_partition(exec, simulation));
+      simulation.restrict_compartments(partition->begin(exec.current_rank),
+                                       partition->end(exec.current_rank),
+                                       true);
+      partitioned = std::make_unique<WrapMPI::PartitionedExchange>(
+          partition->offsets());
+      sync_exchange.partition = partitioned.get();
+    }
+    sync_step(exec, simulation, &reduce_req, sync_exchange);
+    sync_prepare_next(exec, simulation, &req, sync_exchange);
     simulation.update_feed(d_t, false);
-    WrapMPI::Async::wait(req);
+    sync_wait_next(exec, simulation, &req, sync_exchange);
+    if (partition)
+    {
+      exchange_particles(exec, simulation, *partition);
+    }
+    const auto cycle_start = std::chrono::steady_clock::now();
     simulation.cycleProcess(container, d_t, functors);
+    const std::chrono::duration<double> cycle_duration
+        = std::chrono::steady_clock::now() - cycle_start;
+    migration.record_cycle(cycle_duration.count());
+    // Reduction goes on while waiting for the next signal
+    sync_contributions_start(exec, simulation, &reduce_req, sync_exchange);
     current_time = simulation.advance(d_t);
   };
   const auto loop_functor = [&](auto&& container)
   {
+    container.set_kernel_team(exec.kernel_options.m_p_p_team_model);
     auto functors = simulation.init_functors<ComputeSpace>(container,
                                                            exec.kernel_options);
     // bool stop = false;
@@ -127,9 +189,10 @@ workers_process([[maybe_unused]] std::shared_ptr<IO::Logger> logger,
     while (true)
     {
 
-      signal = WrapMPI::try_recv<WrapMPI::SIGNALS>(0, &status);
+      signal = commands.wait();
       if (signal == WrapMPI::SIGNALS::STOP)
       {
+        commands.release();
         stop_callback(container);
         break;
       }
@@ -142,7 +205,15 @@ workers_process([[maybe_unused]] std::shared_ptr<IO::Logger> logger,
 
       if (signal == WrapMPI::SIGNALS::HydroUpdate)
       {
-        update_callback(payload, status, simulation);
+        update_callback(payload, status, simulation, sync_exchange);
+        // Host restarts its calibration window at the same step
+        migration.recalibrate();
+        continue;
+      }
+
+      if (signal == WrapMPI::SIGNALS::Migrate)
+      {
+        migration.rebalance(exec, simulation);
         continue;
       }
 
@@ -0,0 +1,72 @@
+#include <cassert>
+#include <cstddef>
+#include <dataexporter/chunk_stream.hpp>
+#include <string>
+#include <vector>
+
+using Core::ChunkRange;
+
+namespace
+{
+  // Records calls as "s<k>", "w" (wait) and "<k>" (write)
+  std::vector<std::string>
+  run(std::size_t n_element, std::size_t chunk, std::size_t& n_written)
+  {
+    std::vector<std::string> calls;
+    std::size_t next_begin = 0;
+    n_written = 0;
+    Core::stream_chunks(
+        n_element,
+        chunk,
+        [&](const ChunkRange& range)
+        {
+          assert(range.begin == range.index * chunk);
+          calls.push_back("s" + std::to_string(range.index));
+        },
+        [&] { calls.emplace_back("w"); },
+        [&](const ChunkRange& range)
+        {
+          assert(range.begin == next_begin && "Chunks written in order");
+          assert(range.size() != 0 && range.size() <= chunk);
+          next_begin = range.end;
+          n_written += range.size();
+          calls.push_back(std::to_string(range.index));
+        });
+    return calls;
+  }
+
+  void
+  check_overlap()
+  {
+    std::size_t n_written = 0;
+    const auto calls = run(10, 4, n_written);
+    const std::vector<std::string> expected
+        = { "s0", "w", "s1", "0", "w", "s2", "1", "w", "2" };
+    assert(calls == expected
+           && "Chunk k has to be staged before chunk k-1 is written");
+    assert(n_written == 10);
+
+    assert(run(4, 4, n_written).size() == 3 && n_written == 4);
+    assert(run(0, 4, n_written).empty() && n_written == 0);
+  }
+
+  void
+  check_chunk_size()
+  {
+    constexpr std::size_t mib = 1024 * 1024;
+    // 2 buffers of 4 rows of doubles
+    static_assert(Core::stream_chunk_size(64 * 4 * 2 * 8, 4, 1000) == 64);
+    static_assert(Core::stream_chunk_size(mib, 4, 10) == 10);
+    static_assert(Core::stream_chunk_size(1, 4, 1000) == 1);
+    static_assert(Core::stream_chunk_size(mib, 0, 0) == 1);
+    // Extraction buffer on top of the two staging buffers
+    static_assert(Core::stream_chunk_size(64 * 4 * 3 * 8, 4, 1000, 3) == 64);
+  }
+} // namespace
+
+int
+main()
+{
+  check_overlap();
+  check_chunk_size();
+}
@@ -0,0 +1,89 @@
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <dataexporter/compression_policy.hpp>
+#include <limits>
+#include <vector>
+
+using Core::CompressionPolicy;
+using Core::CompressionSettings;
+using Core::DatasetClass;
+
+void
+check_parse()
+{
+  const auto empty = CompressionSettings::parse("");
+  assert(empty.has_value() && empty->level == CompressionSettings::max_level
+         && !empty->filter_id && empty->shuffle && !empty->keep_bits
+         && "Empty list should keep default settings");
+
+  const auto settings = CompressionSettings::parse("zstd:3, noshuffle,bits:12");
+  assert(settings.has_value());
+  assert(settings->filter_id == CompressionSettings::zstd_filter);
+  assert(settings->filter_values == std::vector<unsigned>{ 3 });
+  assert(!settings->shuffle && settings->keep_bits == 12U);
+
+  const auto copy = CompressionSettings::parse(settings->to_string());
+  assert(copy.has_value() && copy->to_string() == settings->to_string()
+         && "to_string should be parsed back to the same settings");
+
+  assert(CompressionSettings::parse("4")->level == 4);
+  assert(CompressionSettings::parse("deflate:1")->level == 1);
+  assert(CompressionSettings::parse("none")->to_string() == "none");
+  assert(CompressionSettings::parse("filter:307:1:2")->filter_values.size()
+         == 2);
+
+  assert(!CompressionSettings::parse("deflate:10"));
+  assert(!CompressionSettings::parse("4:2"));
+  assert(!CompressionSettings::parse("none:1"));
+  assert(!CompressionSettings::parse("filter"));
+  assert(!CompressionSettings::parse("bits:53"));
+  assert(!CompressionSettings::parse("gzip"));
+}
+
+void
+check_round()
+{
+  // Ties are rounded to even
+  std::vector<double> values = { 1.5, 1.25, 1.75, -2.718281828 };
+  Core::round_mantissa({ values.data(), 2 }, 0);
+  assert(values[0] == 2. && values[1] == 1.);
+  Core::round_mantissa({ values.data() + 2, 2 }, 1);
+  assert(values[2] == 2. && values[3] == -3.);
+
+  std::vector<double> pi = { 3.14159265358979 };
+  Core::round_mantissa(pi, 10);
+  assert(std::abs(pi[0] - 3.14159265358979) <= 3.14159265358979 / 2048.);
+
+  std::vector<double> special
+      = { 0., std::numeric_limits<double>::infinity(), 1. };
+  Core::round_mantissa(special, 52);
+  Core::round_mantissa(special, 4);
+  assert(special[0] == 0. && std::isinf(special[1]) && special[2] == 1.);
+}
+
+void
+check_from_env()
+{
+  setenv("BIOMC_COMPRESSION_FIELDS", "zstd,bits:8", 1);
+  setenv("BIOMC_COMPRESSION_PARTICLES", "zstd,bits:8", 1);
+  setenv("BIOMC_COMPRESSION_PROBES", "2", 1);
+  const auto policy = CompressionPolicy::from_env();
+  unsetenv("BIOMC_COMPRESSION_FIELDS");
+  unsetenv("BIOMC_COMPRESSION_PARTICLES");
+  unsetenv("BIOMC_COMPRESSION_PROBES");
+
+  const auto& fields = policy.get(DatasetClass::Fields);
+  assert(!fields.keep_bits && !fields.filter_id
+         && "Lossy settings are invalid for values that are not rounded");
+  assert(policy.get(DatasetClass::Particles).keep_bits == 8U);
+  assert(policy.get(DatasetClass::Probes).level == 2);
+}
+
+int
+main()
+{
+  check_parse();
+  check_round();
+  check_from_env();
+}
@@ -0,0 +1,79 @@
+#include <cassert>
+#include <cstddef>
+#include <export_pipeline.hpp>
+#include <stdexcept>
+#include <vector>
+
+void
+check_order(std::size_t n_buffer)
+{
+  std::vector<double> written;
+  {
+    Core::ExportPipeline pipeline(
+        n_buffer,
+        [&written](Core::ExportSnapshot& snapshot)
+        { written.push_back(snapshot.time); });
+
+    for (int i = 0; i < 20; ++i)
+    {
+      auto& snapshot = pipeline.acquire();
+      snapshot.time = i;
+      pipeline.submit(snapshot);
+    }
+    pipeline.flush();
+    assert(written.size() == 20 && "Flush should wait for every snapshot");
+    for (int i = 0; i < 20; ++i)
+    {
+      assert(written[i] == i && "Snapshots should be written in order");
+    }
+
+    auto& snapshot = pipeline.acquire();
+    snapshot.time = 20;
+    pipeline.submit(snapshot);
+  }
+  assert(written.size() == 21 && "Destructor should write pending snapshot");
+}
+
+void
+check_error(std::size_t n_buffer)
+{
+  Core::ExportPipeline pipeline(n_buffer,
+                                [](Core::ExportSnapshot& snapshot)
+                                {
+                                  if (snapshot.time == 3)
+                                  {
+                                    throw std::runtime_error("write failed");
+                                  }
+                                });
+  bool caught = false;
+  try
+  {
+    for (int i = 0; i < 10; ++i)
+    {
+      auto& snapshot = pipeline.acquire();
+      snapshot.time = i;
+      pipeline.submit(snapshot);
+    }
+    pipeline.flush();
+  }
+  catch (const std::runtime_error&)
+  {
+    caught = true;
+  }
+  assert(caught && "Writer error should reach the simulation thread");
+  // Error is only raised once, buffers are back in the pool
+  pipeline.flush();
+  auto& snapshot = pipeline.acquire();
+  snapshot.time = 10;
+  pipeline.submit(snapshot);
+}
+
+int
+main()
+{
+  for (const std::size_t n_buffer : { 0, 1, 2, 4 })
+  {
+    check_order(n_buffer);
+    check_error(n_buffer);
+  }
+}
@@ -1,7 +1,12 @@
 #include "load_balancing/impl_lb.hpp"
 #include <cassert>
 #include <iostream>
+#include <load_balancing/checkpoint_layout.hpp>
+#include <load_balancing/domain_partition.hpp>
 #include <load_balancing/iload_balancer.hpp>
+#include <load_balancing/particle_migration.hpp>
+#include <stdexcept>
+#include <vector>
 
 void
 test(ILoadBalancer* lb, uint64_t n, uint32_t n_rank)
@@ -19,6 +24,213 @@ test(ILoadBalancer* lb, uint64_t n, uint32_t n_rank)
   assert(cumsum == n);
 }
 
+void
+test_migration_plan()
+{
+  constexpr double trigger = 0.1;
+  constexpr double tolerance = 0.02;
+
+  // Balanced: nothing to move
+  {
+    const std::vector<uint64_t> counts = { 1000, 1000, 1000 };
+    const std::vector<double> times = { 1., 1., 1. };
+    assert(ParticleMigration::plan(counts, times, trigger, tolerance).empty());
+  }
+
+  // Imbalance below trigger: hysteresis keeps particles in place
+  {
+    const std::vector<uint64_t> counts = { 1050, 1000, 950 };
+    const std::vector<double> times = { 1.05, 1., 0.95 };
+    assert(ParticleMigration::plan(counts, times, trigger, tolerance).empty());
+  }
+
+  // Same cost per particle: counts are equalized
+  {
+    const std::vector<uint64_t> counts = { 3000, 1000, 2000 };
+    const std::vector<double> times = { 3., 1., 2. };
+    const auto transfers
+        = ParticleMigration::plan(counts, times, trigger, tolerance);
+    assert(transfers.size() == 1);
+    assert(transfers[0].from == 0 && transfers[0].to == 1);
+    assert(transfers[0].n == 1000);
+  }
+
+  // Rank 1 twice as fast gets twice as many particles
+  {
+    const std::vector<uint64_t> counts = { 3000, 3000 };
+    const std::vector<double> times = { 3., 1.5 };
+    const auto transfers
+        = ParticleMigration::plan(counts, times, trigger, tolerance);
+    assert(transfers.size() == 1);
+    assert(transfers[0].from == 0 && transfers[0].to == 1);
+    assert(transfers[0].n == 1000);
+  }
+
+  // Total is conserved and senders never receive
+  {
+    const std::vector<uint64_t> counts = { 5000, 0, 4000, 10, 1000 };
+    const std::vector<double> times = { 5., 0., 4., 0., 1. };
+    const auto transfers
+        = ParticleMigration::plan(counts, times, trigger, tolerance);
+    std::vector<int64_t> after(counts.begin(), counts.end());
+    for (const auto& t : transfers)
+    {
+      after[t.from] -= static_cast<int64_t>(t.n);
+      after[t.to] += static_cast<int64_t>(t.n);
+      for (const auto& other : transfers)
+      {
+        assert(other.to != t.from);
+      }
+    }
+    int64_t total = 0;
+    for (const auto n : after)
+    {
+      assert(n >= 0);
+      total += n;
+    }
+    assert(total == 10010);
+    assert(after[1] > 0);
+  }
+
+  // Host work is compensated by fewer particles on rank 0
+  {
+    const std::vector<uint64_t> counts = { 2000, 2000, 2000 };
+    const std::vector<double> times = { 2., 2., 2. };
+    const std::vector<double> overheads = { 1.5, 0., 0. };
+    const auto transfers = ParticleMigration::plan(
+        counts, times, trigger, tolerance, overheads);
+    assert(transfers.size() == 2);
+    assert(transfers[0].from == 0 && transfers[0].to == 1);
+    assert(transfers[1].from == 0 && transfers[1].to == 2);
+    assert(transfers[0].n == 500 && transfers[1].n == 500);
+  }
+
+  // Host work longer than a balanced step: no particle left on rank 0
+  {
+    const std::vector<uint64_t> counts = { 2000, 2000, 2000 };
+    const std::vector<double> times = { 2., 2., 2. };
+    const std::vector<double> overheads = { 10., 0., 0. };
+    const auto transfers = ParticleMigration::plan(
+        counts, times, trigger, tolerance, overheads);
+    assert(transfers.size() == 2);
+    assert(transfers[0].n == 1000 && transfers[1].n == 1000);
+  }
+}
+
+void
+test_migration_calibration()
+{
+  ParticleMigration disabled({ .interval = 0,
+                               .trigger = 0.1,
+                               .tolerance = 0.02,
+                               .calibration = 0,
+                               .export_interval = 0 });
+  disabled.record_cycle(1.);
+  disabled.recalibrate();
+  assert(!disabled.due());
+
+  // Window covers at least one export
+  ParticleMigration migration({ .interval = 0,
+                                .trigger = 0.1,
+                                .tolerance = 0.02,
+                                .calibration = 3,
+                                .export_interval = 5 });
+  for (int i = 0; i < 4; ++i)
+  {
+    migration.record_cycle(1.);
+  }
+  assert(!migration.due());
+  migration.record_cycle(1.);
+  assert(migration.due());
+}
+
+void
+test_domain_partition()
+{
+  {
+    // Same volume everywhere: same number of compartments per rank
+    const std::vector<double> volumes(12, 1.);
+    const auto partition = DomainPartition::balanced(volumes, 3);
+    assert((partition.offsets() == std::vector<uint64_t>{ 0, 4, 8, 12 }));
+    assert(partition.owner(0) == 0);
+    assert(partition.owner(3) == 0);
+    assert(partition.owner(4) == 1);
+    assert(partition.owner(11) == 2);
+  }
+
+  {
+    // One large compartment is alone in its range
+    const std::vector<double> volumes = { 10., 1., 1., 1., 1., 1. };
+    const auto partition = DomainPartition::balanced(volumes, 2);
+    assert(partition.begin(1) == 1 && partition.end(1) == 6);
+  }
+
+  {
+    // Every rank gets at least one compartment
+    const std::vector<double> volumes = { 1., 1., 100. };
+    const auto partition = DomainPartition::balanced(volumes, 3);
+    assert((partition.offsets() == std::vector<uint64_t>{ 0, 1, 2, 3 }));
+  }
+
+  bool thrown = false;
+  try
+  {
+    const std::vector<double> volumes(2, 1.);
+    (void)DomainPartition::balanced(volumes, 3);
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+void
+test_checkpoint_layout()
+{
+  // Checkpoint written by 3 ranks, one of them without particles
+  const std::vector<uint64_t> counts = { 40, 0, 60 };
+  const CheckpointLayout layout(counts);
+  assert(layout.total() == 100);
+  assert(layout.n_shard() == 3);
+
+  const auto all = layout.slices(0, layout.total());
+  assert(all.size() == 2);
+  assert(all[0].shard == 0 && all[0].first == 0 && all[0].last == 40);
+  assert(all[1].shard == 2 && all[1].first == 0 && all[1].last == 60);
+
+  const auto middle = layout.slices(30, 50);
+  assert(middle.size() == 2);
+  assert(middle[0].shard == 0 && middle[0].first == 30);
+  assert(middle[0].last == 40);
+  assert(middle[1].shard == 2 && middle[1].first == 0);
+  assert(middle[1].last == 10);
+  assert(layout.slices(50, 50).empty());
+
+  // Restart on other rank counts: contiguous ranges covering every particle
+  // once
+  for (const uint32_t n_rank : { 1U, 2U, 7U, 150U })
+  {
+    UniformLoadBalancer uniform(n_rank);
+    uint64_t expected_begin = 0;
+    uint64_t covered = 0;
+    for (uint32_t rank = 0; rank < n_rank; ++rank)
+    {
+      const auto [begin, end] = CheckpointLayout::rank_range(
+          uniform, rank, n_rank, layout.total());
+      assert(begin == expected_begin && begin <= end);
+      for (const auto& slice : layout.slices(begin, end))
+      {
+        assert(slice.last <= counts[slice.shard]);
+        covered += slice.last - slice.first;
+      }
+      expected_begin = end;
+    }
+    assert(expected_begin == layout.total());
+    assert(covered == layout.total());
+  }
+}
+
 int
 main()
 {
@@ -38,4 +250,9 @@ main()
   test(&host2, n_particle, n_rank);
   test(&bound, n_particle, n_rank);
   test(&bound2, 5e6, 3);
+
+  test_migration_plan();
+  test_migration_calibration();
+  test_domain_partition();
+  test_checkpoint_layout();
 }
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <core/particle_statistics.hpp>
+#include <core/post_process.hpp>
+#include <cstddef>
+#include <mc/m_default.hpp>
+#include <mc/particles_container.hpp>
+#include <mc/unit.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using PostProcessing::ParticleStatistics;
+using PostProcessing::StatisticsViewType;
+
+namespace
+{
+  // Sums of the device passes for one variable in 2 compartments, the second
+  // is empty
+  ParticleStatistics
+  make_statistics(const std::vector<double>& values, std::size_t n_bins)
+  {
+    ParticleStatistics statistics;
+    statistics.names = { "x" };
+    statistics.n_compartment = 2;
+    statistics.n_bins = n_bins;
+    statistics.count = StatisticsViewType<HostSpace>("count", 1, 2);
+    statistics.mean = StatisticsViewType<HostSpace>("mean", 1, 2);
+    statistics.min = StatisticsViewType<HostSpace>("min", 1, 2);
+    statistics.max = StatisticsViewType<HostSpace>("max", 1, 2);
+    statistics.min(0, 1) = 1e300;
+    statistics.max(0, 1) = -1e300;
+    statistics.count(0, 0) = static_cast<double>(values.size());
+    statistics.min(0, 0) = values.front();
+    statistics.max(0, 0) = values.front();
+    for (const auto v : values)
+    {
+      statistics.mean(0, 0) += v;
+      statistics.min(0, 0) = std::min(statistics.min(0, 0), v);
+      statistics.max(0, 0) = std::max(statistics.max(0, 0), v);
+    }
+    PostProcessing::prepare_histograms(statistics);
+
+    statistics.variance = StatisticsViewType<HostSpace>("variance", 1, 2);
+    statistics.histogram
+        = StatisticsViewType<HostSpace>("histogram", 1, 2 * n_bins);
+    const double lower = statistics.bin_edges(0, 0);
+    const double width = (n_bins == 0) ? 0 : statistics.bin_edges(0, 1) - lower;
+    for (const auto v : values)
+    {
+      const double deviation = v - statistics.mean(0, 0);
+      statistics.variance(0, 0) += deviation * deviation;
+      if (n_bins != 0)
+      {
+        const auto bin = std::min(
+            static_cast<std::size_t>((v - lower) / width), n_bins - 1);
+        statistics.histogram(0, bin) += 1;
+      }
+    }
+    PostProcessing::finalize_statistics(statistics);
+    return statistics;
+  }
+
+  void
+  check_moments()
+  {
+    const auto statistics = make_statistics({ 1., 2., 3., 4. }, 0);
+    assert(statistics.mean(0, 0) == 2.5);
+    assert(statistics.variance(0, 0) == 1.25);
+    assert(statistics.quantiles.extent(1) == 0);
+    assert(std::isnan(statistics.mean(0, 1)) && std::isnan(statistics.min(0, 1))
+           && "Empty compartment should have NaN moments");
+  }
+
+  void
+  check_quantiles()
+  {
+    std::vector<double> values(1000);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+      values[i] = static_cast<double>(i);
+    }
+    const std::size_t n_bins = 100;
+    const auto statistics = make_statistics(values, n_bins);
+    assert(statistics.bin_edges(0, 0) == 0.);
+    assert(statistics.bin_edges(0, n_bins) == 999.);
+
+    const auto n_quantile = ParticleStatistics::quantile_levels.size();
+    const double width = 999. / n_bins;
+    for (std::size_t i_q = 0; i_q < n_quantile; ++i_q)
+    {
+      const double expected
+          = ParticleStatistics::quantile_levels[i_q] * 1000.;
+      assert(std::abs(statistics.quantiles(0, i_q) - expected) <= width
+             && "Quantile error should be less than one bin");
+      assert(std::isnan(statistics.quantiles(0, n_quantile + i_q)));
+    }
+  }
+
+  // Exports its property so that model, mass and ages are reduced
+  struct ExportModel : DefaultModel
+  {
+    using Self = ExportModel;
+
+    static constexpr std::array<std::string_view, 1>
+    names()
+    {
+      return { "a" };
+    }
+  };
+
+  // 7 particles in compartments 0 (0, 2, 4, 6) and 1 (1, 3, 5), the third
+  // compartment is empty. Particle 6 is dead. Ages are i and 10i, the
+  // model property is 2i
+  template <typename Model>
+  MC::ParticlesContainer<Model>
+  make_container()
+  {
+    constexpr std::size_t n_particle = 7;
+    MC::ParticlesContainer<Model> container(
+        MC::load_tuning_constant(), n_particle, 0);
+    const auto position = container.position;
+    const auto status = container.status;
+    const auto ages = container.ages;
+    const auto model = container.model;
+    Kokkos::parallel_for(
+        "fill_statistics",
+        Kokkos::RangePolicy<ComputeSpace>(0, n_particle),
+        KOKKOS_LAMBDA(const std::size_t i) {
+          position(i) = i % 2;
+          status(i) = (i == n_particle - 1) ? MC::Status::Dead
+                                            : MC::Status::Idle;
+          ages(i, 0) = static_cast<float>(i);
+          ages(i, 1) = static_cast<float>(10 * i);
+          model(i, 0) = static_cast<float>(2 * i);
+        });
+    Kokkos::fence();
+    return container;
+  }
+
+  // Variable k_var of particle i is scale * i
+  void
+  check_linear(const ParticleStatistics& statistics,
+               std::size_t k_var,
+               double scale)
+  {
+    assert(statistics.mean(k_var, 0) == 2 * scale);
+    assert(statistics.min(k_var, 0) == 0.);
+    assert(statistics.max(k_var, 0) == 4 * scale
+           && "Dead particle should be ignored");
+    assert(std::abs(statistics.variance(k_var, 0) - 8. / 3. * scale * scale)
+           < 1e-9);
+    assert(statistics.mean(k_var, 1) == 3 * scale);
+    assert(statistics.min(k_var, 1) == scale);
+    assert(statistics.max(k_var, 1) == 5 * scale);
+    assert(std::isnan(statistics.mean(k_var, 2)));
+  }
+
+  void
+  check_count(const ParticleStatistics& statistics)
+  {
+    assert(statistics.n_compartment == 3);
+    assert(statistics.count(0, 0) == 3. && "Only idle particles are counted");
+    assert(statistics.count(0, 1) == 3.);
+    assert(statistics.count(0, 2) == 0.);
+  }
+
+  void
+  check_device_ages()
+  {
+    auto container = make_container<DefaultModel>();
+    const auto statistics
+        = PostProcessing::get_statistics(container, 3, 4, true);
+    assert(statistics.has_value());
+    assert((statistics->names
+            == std::vector<std::string>{ "age_hydro", "age" }));
+    check_count(*statistics);
+    check_linear(*statistics, 0, 1.);
+    check_linear(*statistics, 1, 10.);
+
+    auto no_age = make_container<DefaultModel>();
+    assert(!PostProcessing::get_statistics(no_age, 3, 4, false).has_value()
+           && "Nothing to reduce without properties and ages");
+  }
+
+  void
+  check_device_properties()
+  {
+    auto container = make_container<ExportModel>();
+    const auto statistics
+        = PostProcessing::get_statistics(container, 3, 4, true);
+    assert(statistics.has_value());
+    assert((statistics->names
+            == std::vector<std::string>{ "a", "mass", "age_hydro", "age" }));
+    check_count(*statistics);
+    check_linear(*statistics, 0, 2.);
+    assert(statistics->mean(1, 0) == 1. && statistics->mean(1, 1) == 1.);
+    assert(statistics->variance(1, 0) == 0.);
+    check_linear(*statistics, 2, 1.);
+    check_linear(*statistics, 3, 10.);
+  }
+
+  // Chunks written by the stream extraction are the columns of the full
+  // extraction, spatial sums are the same
+  void
+  check_stream_properties()
+  {
+    auto full_container = make_container<ExportModel>();
+    const auto full
+        = PostProcessing::get_properties(full_container, 3, true);
+    auto container = make_container<ExportModel>();
+    const auto stream
+        = PostProcessing::get_stream_properties(container, 3, true);
+    assert(full.has_value() && stream.has_value());
+    assert(stream->n_particles == 6 && "Dead particle is removed");
+    assert(stream->vnames == full->vnames);
+    for (std::size_t k = 0; k < 2; ++k)
+    {
+      for (std::size_t j = 0; j < 3; ++j)
+      {
+        assert((*stream->spatial_values)(k, j)
+               == (*full->spatial_values)(k, j));
+      }
+    }
+
+    // Rows are the ages then the properties, chunks do not divide n_p
+    constexpr std::size_t chunk = 4;
+    const ParticlePropertyViewType<ComputeSpace> extracted(
+        "extracted", 4, chunk);
+    const auto h_extracted = Kokkos::create_mirror_view(extracted);
+    for (std::size_t begin = 0; begin < stream->n_particles; begin += chunk)
+    {
+      const auto end = std::min(begin + chunk, stream->n_particles);
+      stream->fill(ComputeSpace(), begin, end, extracted);
+      Kokkos::deep_copy(h_extracted, extracted);
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        assert(h_extracted(0, i - begin) == (*full->ages)(0, i));
+        assert(h_extracted(1, i - begin) == (*full->ages)(1, i));
+        assert(h_extracted(2, i - begin) == (*full->particle_values)(0, i));
+        assert(h_extracted(3, i - begin) == (*full->particle_values)(1, i));
+      }
+    }
+  }
+} // namespace
+
+int
+main()
+{
+  Kokkos::initialize();
+  {
+    check_moments();
+    check_quantiles();
+    check_device_ages();
+    check_device_properties();
+    check_stream_properties();
+  }
+  Kokkos::finalize();
+}
@@ -3,6 +3,7 @@
 
 #include <biocma_cst_config.hpp>
 #include <common/has_serialize.hpp>
+#include <common/instrumentation.hpp>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -14,6 +15,7 @@ struct KernelDispatchOptions
   std::size_t m_p_p_team_contribs = AutoGenerated::Kernels::particle_per_team_contributions;
   std::size_t m_p_p_team_move     = AutoGenerated::Kernels::particle_per_team_move;
   std::size_t m_p_p_team_leave    = AutoGenerated::Kernels::particle_per_team_leave;
+  Common::InstrumentationMask instrumentation = Common::InstrumentationMask::compile_time_default(); ///< Runtime enabled probes/events/dumps
 };
 // clang-format on
 
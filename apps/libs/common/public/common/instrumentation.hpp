@@ -0,0 +1,149 @@
+#ifndef __BIOMC_COMMON_INSTRUMENTATION_HPP__
+#define __BIOMC_COMMON_INSTRUMENTATION_HPP__
+
+#include <biocma_cst_config.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace Common
+{
+  /**
+   * @brief Optional diagnostics that can be recorded during simulation
+   */
+  enum class InstrumentationFlag : uint8_t
+  {
+    Probe = 1U << 0U,            ///< Leaving and division time probes
+    EventCounter = 1U << 1U,     ///< Tallies (move, exit, division...)
+    DumpParticleState = 1U << 2U ///< Particle properties at each export
+  };
+
+  /**
+   * @brief Runtime set of enabled instrumentation.
+   *
+   * Default value is given by the compile time flags so that existing builds
+   * keep their behaviour. It can be changed without rebuild through
+   * BIOMC_INSTRUMENTATION env variable or -instr CLI option with a comma
+   * separated list: "probe,event,dump", "all" or "none".
+   *
+   * Kernels do not check the mask per particle, use `dispatch_instrumentation`
+   * to select a template instantiated kernel at launch.
+   */
+  class InstrumentationMask
+  {
+  public:
+    static constexpr std::string_view env_name = "BIOMC_INSTRUMENTATION";
+
+    constexpr InstrumentationMask() noexcept = default;
+
+    [[nodiscard]] static constexpr InstrumentationMask
+    none() noexcept
+    {
+      return {};
+    }
+
+    [[nodiscard]] static constexpr InstrumentationMask
+    all() noexcept
+    {
+      return InstrumentationMask()
+          .with(InstrumentationFlag::Probe)
+          .with(InstrumentationFlag::EventCounter)
+          .with(InstrumentationFlag::DumpParticleState);
+    }
+
+    [[nodiscard]] static constexpr InstrumentationMask
+    compile_time_default() noexcept
+    {
+      return InstrumentationMask()
+          .with(InstrumentationFlag::Probe,
+                AutoGenerated::FlagCompileTime::use_probe)
+          .with(InstrumentationFlag::EventCounter,
+                AutoGenerated::FlagCompileTime::enable_event_counter)
+          .with(InstrumentationFlag::DumpParticleState,
+                AutoGenerated::FlagCompileTime::dump_particle_state);
+    }
+
+    /**
+     * @brief Parse comma separated list of instrumentation name
+     * @return nullopt if one of the names is unknown
+     */
+    [[nodiscard]] static std::optional<InstrumentationMask>
+    parse(std::string_view list);
+
+    /**
+     * @brief Read mask from env variable, fallback to compile time default if
+     * not set or invalid
+     */
+    [[nodiscard]] static InstrumentationMask from_env();
+
+    [[nodiscard]] constexpr InstrumentationMask
+    with(InstrumentationFlag flag, bool enabled = true) const noexcept
+    {
+      InstrumentationMask res = *this;
+      const auto f = static_cast<uint8_t>(flag);
+      res.bits = enabled ? (bits | f) : (bits & ~f);
+      return res;
+    }
+
+    [[nodiscard]] constexpr bool
+    has(InstrumentationFlag flag) const noexcept
+    {
+      return (bits & static_cast<uint8_t>(flag)) != 0;
+    }
+
+    [[nodiscard]] constexpr bool
+    probe() const noexcept
+    {
+      return has(InstrumentationFlag::Probe);
+    }
+
+    [[nodiscard]] constexpr bool
+    event_counter() const noexcept
+    {
+      return has(InstrumentationFlag::EventCounter);
+    }
+
+    [[nodiscard]] constexpr bool
+    dump_particle_state() const noexcept
+    {
+      return has(InstrumentationFlag::DumpParticleState);
+    }
+
+    [[nodiscard]] std::string to_string() const;
+
+    constexpr bool operator==(const InstrumentationMask&) const noexcept
+        = default;
+
+  private:
+    uint8_t bits{};
+  };
+
+  /**
+   * @brief Call f with compile time booleans (probe, event_counter) matching
+   * runtime mask.
+   *
+   * This is the only place where the mask is checked, f is instantiated for
+   * each combination so that disabled instrumentation is removed from the
+   * kernel body exactly like with compile time flags.
+   */
+  template <typename F>
+  decltype(auto)
+  dispatch_instrumentation(const InstrumentationMask mask, F&& f)
+  {
+    using yes = std::true_type;
+    using no = std::false_type;
+    if (mask.probe())
+    {
+      return mask.event_counter() ? std::forward<F>(f)(yes{}, yes{})
+                                  : std::forward<F>(f)(yes{}, no{});
+    }
+    return mask.event_counter() ? std::forward<F>(f)(no{}, yes{})
+                                : std::forward<F>(f)(no{}, no{});
+  }
+
+} // namespace Common
+
+#endif
@@ -0,0 +1,111 @@
+#include <array>
+#include <common/env_var.hpp>
+#include <common/instrumentation.hpp>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+  constexpr std::array<std::pair<std::string_view, Common::InstrumentationFlag>,
+                       3>
+      flag_names = { {
+          { "probe", Common::InstrumentationFlag::Probe },
+          { "event", Common::InstrumentationFlag::EventCounter },
+          { "dump", Common::InstrumentationFlag::DumpParticleState },
+      } };
+
+  std::string_view
+  trim(std::string_view s)
+  {
+    const auto first = s.find_first_not_of(" \t");
+    if (first == std::string_view::npos)
+    {
+      return {};
+    }
+    const auto last = s.find_last_not_of(" \t");
+    return s.substr(first, last - first + 1);
+  }
+
+} // namespace
+
+namespace Common
+{
+
+  std::optional<InstrumentationMask>
+  InstrumentationMask::parse(std::string_view list)
+  {
+    list = trim(list);
+    if (list == "all")
+    {
+      return all();
+    }
+    if (list.empty() || list == "none")
+    {
+      return none();
+    }
+
+    InstrumentationMask mask;
+    while (!list.empty())
+    {
+      const auto sep = list.find(',');
+      const auto name = trim(list.substr(0, sep));
+      list = (sep == std::string_view::npos) ? std::string_view{}
+                                             : list.substr(sep + 1);
+      bool found = false;
+      for (const auto& [flag_name, flag] : flag_names)
+      {
+        if (name == flag_name)
+        {
+          mask = mask.with(flag);
+          found = true;
+          break;
+        }
+      }
+      if (!found)
+      {
+        return std::nullopt;
+      }
+    }
+    return mask;
+  }
+
+  InstrumentationMask
+  InstrumentationMask::from_env()
+  {
+    const auto value = read_env<std::string>(env_name);
+    if (!value.has_value())
+    {
+      return compile_time_default();
+    }
+    if (auto mask = parse(*value))
+    {
+      return *mask;
+    }
+    std::printf("[Config] Invalid %s value '%s', use default\r\n",
+                env_name.data(),
+                value->c_str());
+    return compile_time_default();
+  }
+
+  std::string
+  InstrumentationMask::to_string() const
+  {
+    std::string res;
+    for (const auto& [flag_name, flag] : flag_names)
+    {
+      if (has(flag))
+      {
+        if (!res.empty())
+        {
+          res += ',';
+        }
+        res += flag_name;
+      }
+    }
+    return res.empty() ? std::string("none") : res;
+  }
+
+} // namespace Common
@@ -0,0 +1,64 @@
+#include <cassert>
+#include <common/env_var.hpp>
+#include <common/instrumentation.hpp>
+#include <string>
+
+using Common::InstrumentationFlag;
+using Common::InstrumentationMask;
+
+void
+test_parse()
+{
+  assert(InstrumentationMask::parse("none") == InstrumentationMask::none());
+  assert(InstrumentationMask::parse("") == InstrumentationMask::none());
+  assert(InstrumentationMask::parse("all") == InstrumentationMask::all());
+
+  const auto mask = InstrumentationMask::parse("probe, dump");
+  assert(mask.has_value());
+  assert(mask->probe());
+  assert(!mask->event_counter());
+  assert(mask->dump_particle_state());
+  assert(mask->to_string() == "probe,dump");
+
+  assert(!InstrumentationMask::parse("probe,unknown").has_value());
+}
+
+void
+test_env()
+{
+  const std::string name(InstrumentationMask::env_name);
+  assert(Common::set_local_env<std::string>(name, "event"));
+  const auto mask = InstrumentationMask::from_env();
+  assert(mask == InstrumentationMask().with(InstrumentationFlag::EventCounter));
+
+  // Invalid value falls back to build configuration
+  assert(Common::set_local_env<std::string>(name, "foo"));
+  assert(InstrumentationMask::from_env()
+         == InstrumentationMask::compile_time_default());
+#ifndef _WIN32
+  unsetenv(name.data());
+#endif
+}
+
+void
+test_dispatch()
+{
+  const auto mask = InstrumentationMask().with(InstrumentationFlag::Probe);
+  const int res = Common::dispatch_instrumentation(
+      mask,
+      [](auto use_probe, auto use_event)
+      {
+        return static_cast<int>(decltype(use_probe)::value) * 2
+               + static_cast<int>(decltype(use_event)::value);
+      });
+  assert(res == 2);
+}
+
+int
+main()
+{
+  test_parse();
+  test_env();
+  test_dispatch();
+  return 0;
+}
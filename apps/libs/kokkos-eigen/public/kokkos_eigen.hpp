@@ -5,7 +5,11 @@
 #include <Eigen/Sparse>
 #include <Kokkos_Core.hpp>
 #include <Kokkos_DualView.hpp>
+#include <new>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
+#include <utility>
 
 namespace KokkosEigen
 {
@@ -93,6 +97,13 @@ namespace KokkosEigen
     //!< underlying const device view
     using const_device_view_type = view_type::t_dev_const;
 
+    //!< True when execution space works on host memory (Serial, OpenMP...).
+    //!< DualView then holds a single allocation (mirror is an alias) and all
+    //!< modify/sync calls are removed at compile time
+    static constexpr bool host_aliases_device
+        = std::is_same_v<typename view_type::t_dev::memory_space,
+                         typename view_type::t_host::memory_space>;
+
     /// @brief Allocates Object of shape (n x m) on host and device.
     /// @param label Identifier name for the Kokkos View.
     /// @param n     Number of rows.
@@ -161,18 +172,119 @@ namespace KokkosEigen
       return m_view.extent(1);
     }
 
+    /// @brief Use the n_row() x n_col() values at data as storage instead of
+    /// the allocation, data must outlive the object or the next call to
+    /// own. Views and maps taken before keep the previous storage. Only
+    /// when host aliases device, data is host memory
+    void
+    alias(data_type* data)
+    {
+      if constexpr (host_aliases_device)
+      {
+        typename view_type::t_dev external(data, n_row(), n_col());
+        m_view = view_type(external, external);
+        // Eigen maps cannot be reassigned, only constructed again
+        new (&m_eigen_map) eigen_map_type(get_map<eigen_map_type>());
+      }
+      else
+      {
+        (void)data;
+        throw std::logic_error("Device storage cannot alias host memory");
+      }
+    }
+
+    /// @brief Copy values of an aliased storage in a new allocation
+    void
+    own(const std::string& label)
+    {
+      if constexpr (host_aliases_device)
+      {
+        typename view_type::t_dev owned(label, n_row(), n_col());
+        Kokkos::deep_copy(owned, m_view.view_device());
+        m_view = view_type(owned, owned);
+        new (&m_eigen_map) eigen_map_type(get_map<eigen_map_type>());
+      }
+    }
+
+    /// @brief Keep only columns [first, end) in a new allocation, values
+    /// are copied from host data. Views and maps taken before keep the
+    /// previous storage
+    void
+    keep_columns(std::size_t first, std::size_t end, const std::string& label)
+    {
+      sync_host();
+      view_type kept(label, n_row(), end - first);
+      Kokkos::deep_copy(kept.view_host(),
+                        Kokkos::subview(m_view.view_host(),
+                                        Kokkos::ALL,
+                                        std::make_pair(first, end)));
+      m_view = kept;
+      new (&m_eigen_map) eigen_map_type(get_map<eigen_map_type>());
+      host_to_device_sync();
+    }
+
     void
     host_to_device_sync()
     {
-      m_view.template modify<typename view_type::host_mirror_space>();
-      m_view.template sync<typename view_type::execution_space>();
+      if constexpr (!host_aliases_device)
+      {
+        m_view.template modify<typename view_type::host_mirror_space>();
+        m_view.template sync<typename view_type::execution_space>();
+      }
     }
 
     void
     device_to_host_sync()
     {
-      m_view.template modify<typename view_type::execution_space>();
-      m_view.template sync<typename view_type::host_mirror_space>();
+      if constexpr (!host_aliases_device)
+      {
+        m_view.template modify<typename view_type::execution_space>();
+        m_view.template sync<typename view_type::host_mirror_space>();
+      }
+    }
+
+    /// @brief Mark device data as modified without copy, host is synced
+    /// lazily by sync_host
+    void
+    modify_device()
+    {
+      if constexpr (!host_aliases_device)
+      {
+        m_view.template modify<typename view_type::execution_space>();
+      }
+    }
+
+    /// @brief Mark host data as modified without copy
+    void
+    modify_host()
+    {
+      if constexpr (!host_aliases_device)
+      {
+        m_view.template modify<typename view_type::host_mirror_space>();
+      }
+    }
+
+    /// @brief Copy device data to host only if modified on device.
+    /// DualView copies share data and flags, const access is safe
+    void
+    sync_host() const
+    {
+      if constexpr (!host_aliases_device)
+      {
+        auto view = m_view;
+        view.template sync<typename view_type::host_mirror_space>();
+      }
+    }
+
+    /// @brief Copy host data to device only if modified on host
+    void
+    sync_device() const
+    {
+      if constexpr (!host_aliases_device)
+      {
+        auto view = m_view;
+        view.template sync<typename view_type::execution_space>();
+      }
     }
 
     eigen_array_type
@@ -25,6 +25,13 @@ _impl_test()
 
   ke.set_host(2, 3, 5.);
   KOKKOS_ASSERT(eigen.coeff(2, 3) == 5.);
+
+  // Host backends: one buffer shared by Eigen, host and device views
+  if constexpr (KokkosEigen2D<float, layout>::host_aliases_device)
+  {
+    KOKKOS_ASSERT(ke.host_view().data() == ke.device_view().data());
+    KOKKOS_ASSERT(eigen.data() == ke.device_view().data());
+  }
 }
 
 int
@@ -40,6 +40,23 @@ _impl_test()
       "_test_host_device", n_col, KOKKOS_LAMBDA(const int i_col) {
         KOKKOS_ASSERT(dev(0, i_col) == 2 * i_col);
       });
+
+  // Lazy sync: copy only when device is marked as modified
+  Kokkos::parallel_for(
+      "_test_lazy", n_row, KOKKOS_LAMBDA(const int i_row) {
+        dev(i_row, 1) = 3.f * (float)i_row;
+      });
+  Kokkos::fence();
+  ke.modify_device();
+  const auto& cke = ke;
+  cke.sync_host();
+  for (std::size_t i = 0; i < n_row; ++i)
+  {
+    KOKKOS_ASSERT(eigen.coeff(i, 1) == 3.f * (float)i);
+  }
+  // Nothing modified since last sync: no-op
+  cke.sync_device();
+  cke.sync_host();
 }
 
 int
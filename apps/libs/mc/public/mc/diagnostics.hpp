@@ -0,0 +1,131 @@
+#ifndef __MC_DIAGNOSTICS_HPP__
+#define __MC_DIAGNOSTICS_HPP__
+
+#include <Kokkos_Core.hpp>
+#include <array>
+#include <common/common.hpp>
+#include <common/logger.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <mc/alias.hpp>
+#include <string_view>
+#include <vector>
+
+namespace MC
+{
+  /**
+   * @brief Failures that can be reported from a kernel
+   */
+  enum class DiagnosticCode : uint8_t
+  {
+    DivisionOverflow = 0, ///< No slot available to store daughter particle
+    __COUNT__
+  };
+
+  constexpr std::size_t number_diagnostic_code
+      = static_cast<std::size_t>(DiagnosticCode::__COUNT__);
+
+  /**
+   * @brief Human readable name of a diagnostic code
+   */
+  std::string_view diagnostic_name(DiagnosticCode code) noexcept;
+
+  /**
+   * @brief One failure reported by a kernel
+   */
+  struct DiagnosticRecord
+  {
+    DiagnosticCode code;
+    uint64_t particle_id;
+    double value; ///< Meaning depends on code
+  };
+
+  /**
+   * @brief Cheap device-to-host channel to report failures from kernels
+   * instead of Kokkos::printf.
+   *
+   * Each report increments a per-code counter, the first `capacity` reports of
+   * a step are also stored with particle id and value. Once full, next reports
+   * are only counted, so the cost of a failure storm stays bounded (one atomic
+   * per report).
+   * Host drains the channel after each step, record buffer is then reused.
+   */
+  class DiagnosticChannel
+  {
+  public:
+    static constexpr std::size_t default_capacity = 64;
+
+    explicit DiagnosticChannel(std::size_t capacity = default_capacity);
+
+    /**
+     * @brief Record a failure, can be called from any kernel
+     */
+    KOKKOS_INLINE_FUNCTION void
+    report(const DiagnosticCode code,
+           const uint64_t particle_id,
+           const double value) const
+    {
+      Kokkos::atomic_inc(&counters(static_cast<std::size_t>(code)));
+      const auto pos = Kokkos::atomic_fetch_add(&head(), 1);
+      if (pos < records.extent(0))
+      {
+        records(pos) = { code, particle_id, value };
+      }
+    }
+
+    // HOST
+
+    /**
+     * @brief Copy pending reports to host and reset channel
+     * @return Number of reports per code since last drain
+     */
+    std::array<uint64_t, number_diagnostic_code>
+    drain(std::vector<DiagnosticRecord>& host_records);
+
+  private:
+    Kokkos::View<DiagnosticRecord*, ComputeSpace> records;
+    Kokkos::View<uint64_t[number_diagnostic_code], Kokkos::SharedSpace> // NOLINT
+        counters;
+    Kokkos::View<uint64_t, Kokkos::SharedSpace> head;
+  };
+
+  /**
+   * @brief Host side of the diagnostic channel, logs reports through
+   * IO::Logger with rate limiting.
+   *
+   * For each code, at most one summary line (occurrence count and a few
+   * sampled records) is written every `min_step_interval` drains. Occurrences
+   * are accumulated between two summaries so that nothing is silently lost.
+   */
+  class DiagnosticReporter
+  {
+  public:
+    static constexpr std::size_t default_min_step_interval = 100;
+    static constexpr std::size_t default_max_sample = 3;
+
+    explicit DiagnosticReporter(
+        std::size_t min_step_interval = default_min_step_interval,
+        std::size_t max_sample = default_max_sample);
+
+    /**
+     * @brief Drain channel and log if needed
+     * @return Total number of reports drained
+     */
+    uint64_t process(DiagnosticChannel& channel, IO::Logger* logger);
+
+    [[nodiscard]] uint64_t total(DiagnosticCode code) const noexcept;
+
+  private:
+    std::size_t min_step_interval;
+    std::size_t max_sample;
+    std::size_t step{};
+    std::vector<DiagnosticRecord> host_records;
+    std::array<uint64_t, number_diagnostic_code> pending{};
+    std::array<uint64_t, number_diagnostic_code> totals{};
+    std::array<std::size_t, number_diagnostic_code> last_report{};
+    std::array<bool, number_diagnostic_code> has_reported{};
+  };
+
+} // namespace MC
+
+#endif
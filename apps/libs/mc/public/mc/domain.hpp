@@ -9,6 +9,7 @@
 #include <mc/alias.hpp>
 #include <mc/traits.hpp>
 #include <span>
+#include <vector>
 
 namespace MC
 {
@@ -24,6 +25,10 @@ namespace MC
 
   /** @brief Structure to store information about domain needed during MC cycle
     data is likely to change between each iteration
+
+    Tables hold the rows of compartments [first, first + extent(0)) (all of
+    them unless restricted), row of compartment i is i - first. Neighbor
+    indices and leaving flow indices are compartment indices.
   */
   template <typename ExecSpace, bool is_const = true> struct DomainState
   {
@@ -32,6 +37,8 @@ namespace MC
     CumulativeProbabilityView<ExecSpace, is_const> cumulative_probability;
     LeavingFlowView<is_const> leaving_flow;
     VolumeView<ExecSpace, is_const> liquid_volume;
+    std::size_t first = 0;          ///< Compartment of the first row
+    std::size_t n_compartments = 0; ///< Number of compartments of the domain
   };
 
   /**
@@ -98,8 +105,53 @@ namespace MC
 
     void init_inner(std::size_t n_flows);
 
+    /**
+     * @brief Bytes of host memory taken by the neighbors, probabilities,
+     * diagonal transitions and volumes of n_compartments compartments with
+     * n_neighbors neighbors each
+     */
+    [[nodiscard]] static std::size_t
+    shared_tables_size(std::size_t n_compartments,
+                       std::size_t n_neighbors) noexcept;
+
+    /**
+     * @brief Keep tables in memory shared by the ranks of a node (at least
+     * shared_tables_size bytes) instead of own allocations. Only the writer
+     * copies tables at update, other ranks only read them and must not
+     * access them while the writer updates them. Only when ComputeSpace
+     * works on host memory.
+     */
+    void share_tables(std::span<std::byte> memory,
+                      std::size_t n_neighbors,
+                      bool writer);
+
+    /**
+     * @brief Copy shared tables in own allocations, before the shared memory
+     * is released
+     */
+    void own_tables();
+
+    /**
+     * @brief Keep only the rows of compartments [first, end) in tables, at
+     * this call and at next updates. Particles must then only be in these
+     * compartments at the beginning of a cycle (domain decomposition).
+     */
+    void restrict_tables(std::size_t first, std::size_t end);
+
     [[nodiscard]] DomainState<ComputeSpace, true> get_const_inner();
 
+    /**
+     * @brief Set flowmap index of each compartment when compartments are
+     * renumbered (domain data and particle positions use internal indices)
+     */
+    void set_renumbering(std::vector<std::size_t> new_to_old);
+
+    /**
+     * @brief Flowmap index of each compartment, empty if compartments keep
+     * flowmap numbering
+     */
+    [[nodiscard]] std::span<const std::size_t> renumbering() const noexcept;
+
     /**
      * @brief Return the number of compartment in the domain
      */
@@ -118,14 +170,14 @@ namespace MC
     save(Archive& ar) const
     {
 
-      ar(id, size, _total_volume);
+      ar(id, size, _total_volume, new_to_old);
     }
 
     template <class Archive>
     void
     load(Archive& ar)
     {
-      ar(id, size, _total_volume);
+      ar(id, size, _total_volume, new_to_old);
     }
 
   private:
@@ -133,6 +185,11 @@ namespace MC
     size_t id = 0;             ///< Domain ID
     size_t size = 0;           ///< Number of compartment
     DomainState<ComputeSpace, false> inner;
+    std::vector<std::size_t> new_to_old; ///< Empty without renumbering
+    bool tables_shared = false;          ///< Tables in node shared memory
+    bool tables_writer = true; ///< False if tables are only read
+    std::size_t first_row = 0; ///< Compartment of the first row of tables
+    std::size_t kept_rows = 0; ///< Rows of tables, 0 for all compartments
 
     /**
     @brief Set volume of liquid and gas of each compartment
@@ -164,6 +221,12 @@ namespace MC
     return this->_total_volume;
   }
 
+  [[nodiscard]] inline std::span<const std::size_t>
+  ReactorDomain::renumbering() const noexcept
+  {
+    return new_to_old;
+  }
+
   [[nodiscard]] inline DomainState<ComputeSpace, true>
   ReactorDomain::get_const_inner()
   {
@@ -172,7 +235,9 @@ namespace MC
              inner.diag_transition,
              inner.cumulative_probability,
              inner.leaving_flow,
-             inner.liquid_volume };
+             inner.liquid_volume,
+             first_row,
+             size };
   }
 
 } // namespace MC
@@ -224,16 +224,29 @@ namespace MC
       Kokkos::atomic_add(&_events[event_index<event>()], val);
     }
 
-    template <EventType event>
+    /**
+     * @brief Increment specific event counter only if Enable is true
+     *
+     * Used by kernels instantiated according to the runtime instrumentation
+     * mask, when Enable is false the atomic is removed at compile time
+     */
+    template <EventType event, bool Enable>
     KOKKOS_FORCEINLINE_FUNCTION constexpr void
-    wrap_incr() const
+    incr_if() const
     {
-      if constexpr (AutoGenerated::FlagCompileTime::enable_event_counter)
+      if constexpr (Enable)
       {
         incr<event>();
       }
     }
 
+    template <EventType event>
+    KOKKOS_FORCEINLINE_FUNCTION constexpr void
+    wrap_incr() const
+    {
+      incr_if<event, AutoGenerated::FlagCompileTime::enable_event_counter>();
+    }
+
     template <class Archive>
     void
     save(Archive& ar) const
@@ -0,0 +1,202 @@
+#ifndef __MC_FREE_SLOTS_HPP__
+#define __MC_FREE_SLOTS_HPP__
+
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <common/common.hpp>
+#include <cstdint>
+#include <mc/alias.hpp>
+#include <utility>
+
+namespace MC
+{
+  /**
+   * @brief Device-side pool of particle slots released during a Monte-Carlo
+   * cycle (exit or death) that can be reused by division before falling back
+   * to the particle buffer.
+   *
+   * Slots are stored in a flat array split in two regions:
+   *   - [0, limit): slots released during previous steps, available for pop
+   *   - [limit, tail): slots released during the current step, only available
+   *     after the next call to `commit`
+   *
+   * This split allows push and pop to be called from the same kernel without
+   * read/write race on the same entry.
+   * Pop and push are lock-free, they rely on two independent atomic cursors
+   * (head for pop, tail for push).
+   *
+   * @note Recycled slot indices are only valid while the container is not
+   * compacted, `clear` has to be called each time particles are moved.
+   */
+  class FreeSlots
+  {
+  public:
+    using cursor_view_type = Kokkos::View<uint64_t, Kokkos::SharedSpace>;
+
+    FreeSlots() = default;
+
+    explicit FreeSlots(std::size_t capacity)
+        : slots(Kokkos::view_alloc(Kokkos::WithoutInitializing, "free_slots"),
+                capacity),
+          head("free_slots_head"), tail("free_slots_tail"),
+          limit("free_slots_limit")
+    {
+    }
+
+    /**
+     * @brief Record idx as a slot that can be reused.
+     * If the pool is full the slot is not recorded and will be removed later
+     * by the container compaction.
+     */
+    KOKKOS_INLINE_FUNCTION void
+    push(const uint64_t idx) const
+    {
+      const auto pos = Kokkos::atomic_fetch_add(&tail(), 1);
+      if (pos < slots.extent(0)) [[likely]]
+      {
+        slots(pos) = idx;
+      }
+    }
+
+    /**
+     * @brief Try to get a free slot
+     * @return true if a slot has been found and written into idx
+     */
+    KOKKOS_INLINE_FUNCTION bool
+    pop(uint64_t& idx) const
+    {
+      // Cheap early exit to not increment head when pool is already empty
+      if (Kokkos::atomic_load(&head()) >= limit())
+      {
+        return false;
+      }
+      const auto pos = Kokkos::atomic_fetch_add(&head(), 1);
+      if (pos < limit())
+      {
+        idx = slots(pos);
+        return true;
+      }
+      return false;
+    }
+
+    /**
+     * @brief Try to get n contiguous entries of the pool with one atomic
+     * @param first Position of the first entry, use `at` to get slot index
+     * @return Number of entries actually obtained (<=n)
+     */
+    KOKKOS_INLINE_FUNCTION std::size_t
+    take(const std::size_t n, uint64_t& first) const
+    {
+      const auto _limit = limit();
+      if (Kokkos::atomic_load(&head()) >= _limit)
+      {
+        return 0;
+      }
+      first = Kokkos::atomic_fetch_add(&head(), n);
+      return (first >= _limit) ? 0 : Kokkos::min<std::size_t>(n, _limit - first);
+    }
+
+    /**
+     * @brief Slot index stored at a position obtained with `take`
+     */
+    [[nodiscard]] KOKKOS_INLINE_FUNCTION uint64_t
+    at(const std::size_t pos) const
+    {
+      return slots(pos);
+    }
+
+    // HOST
+
+    /**
+     * @brief Number of slots taken since last commit
+     */
+    [[nodiscard]] std::size_t
+    n_recycled() const
+    {
+      return std::min(head(), limit());
+    }
+
+    /**
+     * @brief Subview over slots taken since last commit
+     */
+    [[nodiscard]] auto
+    recycled() const
+    {
+      return Kokkos::subview(slots, std::make_pair(0UL, n_recycled()));
+    }
+
+    /**
+     * @brief Drop taken slots and make slots pushed since last commit
+     * available for next pop
+     */
+    void
+    commit()
+    {
+      Kokkos::fence();
+      const std::size_t taken = n_recycled();
+      const std::size_t end = std::min<std::size_t>(tail(), slots.extent(0));
+      const std::size_t n_remaining = end - taken;
+
+      if (taken != 0 && n_remaining != 0)
+      {
+        // Overlapping ranges, use intermediate copy
+        Kokkos::View<uint64_t*, ComputeSpace> tmp(
+            Kokkos::view_alloc(Kokkos::WithoutInitializing, "free_slots_tmp"),
+            n_remaining);
+        Kokkos::deep_copy(tmp,
+                          Kokkos::subview(slots, std::make_pair(taken, end)));
+        Kokkos::deep_copy(
+            Kokkos::subview(slots, std::make_pair(0UL, n_remaining)), tmp);
+      }
+
+      head() = 0;
+      tail() = n_remaining;
+      limit() = n_remaining;
+    }
+
+    /**
+     * @brief Forget every recorded slot
+     */
+    void
+    clear()
+    {
+      Kokkos::fence();
+      head() = 0;
+      tail() = 0;
+      limit() = 0;
+    }
+
+    /**
+     * @brief Grow storage, keeping already recorded slots
+     */
+    void
+    reserve(std::size_t capacity)
+    {
+      if (slots.extent(0) < capacity)
+      {
+        Kokkos::resize(slots, capacity);
+      }
+    }
+
+    [[nodiscard]] std::size_t
+    capacity() const noexcept
+    {
+      return slots.extent(0);
+    }
+
+    [[nodiscard]] std::size_t
+    size() const
+    {
+      return limit() - n_recycled();
+    }
+
+  private:
+    Kokkos::View<uint64_t*, ComputeSpace> slots;
+    cursor_view_type head;
+    cursor_view_type tail;
+    cursor_view_type limit;
+  };
+
+} // namespace MC
+
+#endif
@@ -3,13 +3,17 @@
 
 #include "Kokkos_Macros.hpp"
 #include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <array>
 #include <biocma_cst_config.hpp>
 #include <cmath>
 #include <common/common.hpp>
 #include <common/env_var.hpp>
 #include <common/has_serialize.hpp>
+#include <common/kokkos_getpolicy.hpp>
 #include <cstdint>
 #include <mc/alias.hpp>
+#include <mc/free_slots.hpp>
 #include <mc/prng/prng.hpp>
 #include <mc/traits.hpp>
 
@@ -19,6 +23,7 @@
 #include <sorting/impl/Kokkos_SortByKeyImpl.hpp>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 namespace MC
 {
 
@@ -29,6 +34,10 @@ namespace MC
     double allocation_factor = {};
     double shrink_ratio{};
     double dead_particle_ratio_threshold{};
+    /// First touch particle views with the teams of the model kernel when
+    /// they grow (BIOMC_NUMA), see ParticlesContainer::set_kernel_team.
+    /// Not serialized, it depends on the binding of the current run.
+    bool first_touch{};
 
     template <class Archive>
     void
@@ -42,6 +51,41 @@ namespace MC
     }
   };
 
+  /**
+   * @brief Block of slots reserved at once for several divisions.
+   *
+   * The first `n_recycled` daughters use slots from the free slot pool, the
+   * next `n_buffer` ones use the division buffer.
+   */
+  struct DivisionReservation
+  {
+    uint64_t first_recycled;
+    uint64_t n_recycled;
+    uint64_t first_buffer;
+    uint64_t n_buffer;
+  };
+
+  /**
+   * @brief Host copy of active particles moved out of a container, used to
+   * migrate particles between units (MPI ranks).
+   *
+   * Particles are Idle by construction, status is not stored. Weights are
+   * empty for constant weight models (weight is the same on every rank).
+   */
+  template <FloatingPointType F> struct ParticleBatch
+  {
+    std::vector<F> model;           ///< n x n_var, row major
+    std::vector<uint64_t> position; ///< n
+    std::vector<float> ages;        ///< n x 2, row major
+    std::vector<F> weights;         ///< n or empty
+
+    [[nodiscard]] std::size_t
+    size() const noexcept
+    {
+      return position.size();
+    }
+  };
+
   /**
    * @brief Main owning object for Monte-Carlo particles.
    *
@@ -86,6 +130,7 @@ namespace MC
     MC::ParticleStatus status;
     ParticleWeigths<typename Model::FloatType> weights;
     ParticleAges ages;
+    FreeSlots free_slots; ///< Slots released by exit/death, reused by division
     // NOLINTEND(cppcoreguidelines-non-private-member-variables-in-classes)
 
     /**
@@ -122,6 +167,12 @@ namespace MC
      * invokes `Model::division`. The operation may fail if conditions for
      * division are not met (e.g., insufficient space or invalid state).
      *
+     * The daughter is first written into a slot released by an exit or a death
+     * (see FreeSlots), the buffer is only used when no such slot is available.
+     * A recycled daughter is flagged as `Status::Division` until the end of
+     * the step so that it is neither updated nor counted in the current step,
+     * which is the same behaviour as buffered daughters.
+     *
      * @param random_pool The random number generator pool for stochastic
      * operations.
      * @param idx1 The index of the particle to undergo division.
@@ -130,6 +181,31 @@ namespace MC
     [[nodiscard]] KOKKOS_INLINE_FUNCTION bool
     handle_division(const MC::pool_type& random_pool, std::size_t idx1) const;
 
+    /**
+     * @brief Reserve slots for n daughters with at most one atomic operation
+     * on the free slot pool and one on the buffer index.
+     *
+     * Used to aggregate reservations when several particles of the same team
+     * divide at once, daughters are then written in contiguous slots.
+     */
+    [[nodiscard]] KOKKOS_INLINE_FUNCTION DivisionReservation
+    reserve_division(std::size_t n) const;
+
+    /**
+     * @brief Perform division of idx1 using the rank-th slot of a reservation
+     * @return `false` if reservation was too small (overflow)
+     */
+    [[nodiscard]] KOKKOS_INLINE_FUNCTION bool
+    handle_division(const MC::pool_type& random_pool,
+                    std::size_t idx1,
+                    const DivisionReservation& reservation,
+                    std::size_t rank) const;
+
+    /**
+     * @brief Flag particle as dead and release its slot
+     */
+    KOKKOS_INLINE_FUNCTION void handle_death(std::size_t idx) const;
+
     /**
      * @brief Return the particle weight
      */
@@ -149,6 +225,33 @@ namespace MC
      */
     void merge_buffer();
 
+    /**
+     * @brief Remove up to n active particles and return them on host
+     *
+     * Inactive particles are removed first so that the last n particles are
+     * active, they are taken from the end of the container. Must be called
+     * between steps (division buffer merged).
+     */
+    ParticleBatch<typename Model::FloatType> extract(std::size_t n);
+
+    /**
+     * @brief Remove active particles whose position is out of [begin, end)
+     * and return them on host
+     *
+     * Used when compartments are split between units, particles that moved
+     * out of the owned range are sent to their owner. Must be called between
+     * steps (division buffer merged).
+     */
+    ParticleBatch<typename Model::FloatType> extract_outside(uint64_t begin,
+                                                             uint64_t end);
+
+    /**
+     * @brief Append particles of batch as Idle particles
+     * @throw std::invalid_argument if batch sizes are not consistent with the
+     * model
+     */
+    void insert(const ParticleBatch<typename Model::FloatType>& batch);
+
     /**
      * @brief Save data into ar for serialization
      */
@@ -192,6 +295,16 @@ namespace MC
 
     void change_runtime(RuntimeParameters&& parameters) noexcept;
 
+    /**
+     * @brief Particles per team of the model kernel
+     * (KernelDispatchOptions::m_p_p_team_model).
+     *
+     * With RuntimeParameters::first_touch, views are reallocated so that each
+     * particle is first written by the thread of the model kernel which
+     * updates it, this also applies to views allocated before the call.
+     */
+    void set_kernel_team(std::size_t particle_per_team);
+
     void _sort(size_t n_c);
 
     /**
@@ -228,7 +341,10 @@ namespace MC
 
     void __allocate_buffer__();
     void _resize(std::size_t new_size, bool force = false);
+    void _first_touch_resize(std::size_t n_kernel);
+    void commit_recycled_slots();
     RuntimeParameters rt_params;
+    std::size_t kernel_team{};
     // FIXME
   public:
     // int begin;
@@ -513,6 +629,8 @@ namespace MC
         this->contribs,
         n_allocated_elements,
         Model::n_c); // Dont forget to allocate contribs which is not saved yet
+
+    free_slots = FreeSlots(0); // Slots are not saved, start with empty pool
 #ifndef NDEBUG
     Kokkos::printf("ParticlesContainer::load: Check if load_tuning_constant "
                    "works with different value");
@@ -545,6 +663,9 @@ namespace MC
     inactive_counter += out;
     inactive_counter += dead;
 
+    // Recycled slots hold newborn particles, they are not inactive anymore
+    commit_recycled_slots();
+
     const auto _threshold = std::max(
         rt_params.minimum_dead_particle_removal,
         static_cast<uint64_t>(static_cast<double>(n_used_elements)
@@ -561,9 +682,59 @@ namespace MC
   ParticlesContainer<Model>::handle_division(const MC::pool_type& random_pool,
                                              std::size_t idx1) const
   {
-    if (Kokkos::atomic_load(&buffer_index()) < buffer_model.extent(0))
+    return handle_division(random_pool, idx1, reserve_division(1), 0);
+  }
+
+  template <ModelType Model>
+  KOKKOS_INLINE_FUNCTION DivisionReservation
+  ParticlesContainer<Model>::reserve_division(const std::size_t n) const
+  {
+    DivisionReservation reservation{ 0, 0, 0, 0 };
+    reservation.n_recycled = free_slots.take(n, reservation.first_recycled);
+
+    const std::size_t n_left = n - reservation.n_recycled;
+    const std::size_t buffer_capacity = buffer_model.extent(0);
+    if (n_left != 0
+        && Kokkos::atomic_load(&buffer_index()) < buffer_capacity)
     {
-      const auto idx2 = Kokkos::atomic_fetch_add(&buffer_index(), 1);
+      reservation.first_buffer
+          = Kokkos::atomic_fetch_add(&buffer_index(), n_left);
+      // buffer_index may exceed capacity, it is clamped during merge
+      reservation.n_buffer
+          = (reservation.first_buffer >= buffer_capacity)
+                ? 0
+                : Kokkos::min<std::size_t>(
+                      n_left, buffer_capacity - reservation.first_buffer);
+    }
+    return reservation;
+  }
+
+  template <ModelType Model>
+  KOKKOS_INLINE_FUNCTION bool
+  ParticlesContainer<Model>::handle_division(
+      const MC::pool_type& random_pool,
+      std::size_t idx1,
+      const DivisionReservation& reservation,
+      const std::size_t rank) const
+  {
+    if (rank < reservation.n_recycled)
+    {
+      // Slot was released in a previous step, no other thread reads it as its
+      // status is not Idle
+      const auto idx2 = free_slots.at(reservation.first_recycled + rank);
+      Model::division(random_pool, idx1, idx2, model, model);
+      position(idx2) = position(idx1);
+      ages(idx2, 0) = 0;
+      ages(idx2, 1) = 0;
+      ages(idx1, 1) = 0;
+      status(idx2) = MC::Status::Division; // Set to Idle in commit
+      return true;
+    }
+
+    const auto buffer_rank = rank - reservation.n_recycled;
+    if (buffer_rank < reservation.n_buffer)
+    {
+      const auto idx2 = reservation.first_buffer + buffer_rank;
       Model::division(random_pool, idx1, idx2, model, buffer_model);
       buffer_position(idx2) = position(idx1);
       ages(idx1, 1) = 0;
@@ -572,13 +743,45 @@ namespace MC
     return false;
   }
 
+  template <ModelType Model>
+  KOKKOS_INLINE_FUNCTION void
+  ParticlesContainer<Model>::handle_death(std::size_t idx) const
+  {
+    status(idx) = MC::Status::Dead;
+    free_slots.push(idx);
+  }
+
+  template <ModelType Model>
+  void
+  ParticlesContainer<Model>::commit_recycled_slots()
+  {
+    PROFILE_SECTION("ParticlesContainer::commit_recycled_slots")
+    const auto n_recycled = free_slots.n_recycled();
+    if (n_recycled != 0)
+    {
+      const auto recycled = free_slots.recycled();
+      const auto _status = status;
+      Kokkos::parallel_for(
+          "commit_recycled_slots",
+          Kokkos::RangePolicy<ComputeSpace>(0, n_recycled),
+          KOKKOS_LAMBDA(const std::size_t i) {
+            _status(recycled(i)) = MC::Status::Idle;
+          });
+      KOKKOS_ASSERT(inactive_counter >= n_recycled);
+      inactive_counter -= n_recycled;
+    }
+    free_slots.commit();
+  }
+
   template <ModelType Model>
   void
   ParticlesContainer<Model>::merge_buffer()
   {
     PROFILE_SECTION("ParticlesContainer::merge_buffer")
     const auto original_size = n_used_elements;
-    const auto n_add_item = buffer_index();
+    // Index can go past the buffer when reservations overflow
+    const auto n_add_item = std::min<std::size_t>(buffer_index(),
+                                                  buffer_position.extent(0));
     if (n_add_item == 0)
     {
       return;
@@ -598,6 +801,209 @@ namespace MC
     __allocate_buffer__();
   }
 
+  template <ModelType Model>
+  ParticleBatch<typename Model::FloatType>
+  ParticlesContainer<Model>::extract(std::size_t n)
+  {
+    PROFILE_SECTION("ParticlesContainer::extract")
+    KOKKOS_ASSERT(buffer_index() == 0);
+    force_remove_dead();
+
+    n = std::min<std::size_t>(n, n_used_elements);
+    const std::size_t first = n_used_elements - n;
+    const auto range = std::make_pair(first, first + n);
+
+    ParticleBatch<typename Model::FloatType> batch;
+    batch.model.resize(n * Model::n_var);
+    batch.position.resize(n);
+    batch.ages.resize(n * 2);
+
+    const auto h_model = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), Kokkos::subview(model, range, Kokkos::ALL));
+    const auto h_position = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), Kokkos::subview(position, range));
+    const auto h_ages = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), Kokkos::subview(ages, range, Kokkos::ALL));
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      for (std::size_t j = 0; j < Model::n_var; ++j)
+      {
+        batch.model[i * Model::n_var + j] = h_model(i, j);
+      }
+      batch.position[i] = h_position(i);
+      batch.ages[i * 2] = h_ages(i, 0);
+      batch.ages[i * 2 + 1] = h_ages(i, 1);
+    }
+
+    if constexpr (!ConstWeightModelType<Model>)
+    {
+      batch.weights.resize(n);
+      const auto h_weights = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace(), Kokkos::subview(weights, range));
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        batch.weights[i] = h_weights(i);
+      }
+    }
+
+    n_used_elements = first;
+    return batch;
+  }
+
+  template <ModelType Model>
+  ParticleBatch<typename Model::FloatType>
+  ParticlesContainer<Model>::extract_outside(const uint64_t begin,
+                                             const uint64_t end)
+  {
+    PROFILE_SECTION("ParticlesContainer::extract_outside")
+    using F = typename Model::FloatType;
+    KOKKOS_ASSERT(buffer_index() == 0);
+    force_remove_dead();
+
+    ParticleBatch<F> batch;
+    const auto _position = position;
+    std::size_t n = 0;
+    Kokkos::parallel_reduce(
+        "count_outside",
+        Kokkos::RangePolicy<ComputeSpace>(0, n_used_elements),
+        KOKKOS_LAMBDA(const std::size_t i, std::size_t& count) {
+          const auto p = _position(i);
+          count += (p < begin || p >= end) ? 1 : 0;
+        },
+        n);
+    if (n == 0)
+    {
+      return batch;
+    }
+
+    constexpr bool weighted = !ConstWeightModelType<Model>;
+    Kokkos::View<F**, Kokkos::LayoutRight, ComputeSpace> out_model(
+        "out_model", n, Model::n_var);
+    Kokkos::View<uint64_t*, ComputeSpace> out_position("out_position", n);
+    Kokkos::View<float**, Kokkos::LayoutRight, ComputeSpace> out_ages(
+        "out_ages", n, 2);
+    Kokkos::View<F*, ComputeSpace> out_weights("out_weights", weighted ? n : 0);
+
+    const auto _model = model;
+    const auto _ages = ages;
+    const auto _status = status;
+    const auto _weights = weights;
+    // Extracted particles are flagged out of the container then compacted
+    Kokkos::parallel_scan(
+        "gather_outside",
+        Kokkos::RangePolicy<ComputeSpace>(0, n_used_elements),
+        KOKKOS_LAMBDA(
+            const std::size_t i, std::size_t& offset, const bool final) {
+          const auto p = _position(i);
+          if (p >= begin && p < end)
+          {
+            return;
+          }
+          if (final)
+          {
+            for (std::size_t j = 0; j < Model::n_var; ++j)
+            {
+              out_model(offset, j) = _model(i, j);
+            }
+            out_position(offset) = p;
+            out_ages(offset, 0) = _ages(i, 0);
+            out_ages(offset, 1) = _ages(i, 1);
+            if constexpr (weighted)
+            {
+              out_weights(offset) = _weights(i);
+            }
+            _status(i) = MC::Status::Exit;
+          }
+          offset++;
+        });
+
+    // Batch vectors are filled in place through unmanaged host views
+    using Unmanaged = Kokkos::MemoryTraits<Kokkos::Unmanaged>;
+    using HostRows = Kokkos::
+        View<F**, Kokkos::LayoutRight, Kokkos::HostSpace, Unmanaged>;
+    using HostAges = Kokkos::
+        View<float**, Kokkos::LayoutRight, Kokkos::HostSpace, Unmanaged>;
+    batch.model.resize(n * Model::n_var);
+    batch.position.resize(n);
+    batch.ages.resize(n * 2);
+    Kokkos::deep_copy(HostRows(batch.model.data(), n, Model::n_var),
+                      out_model);
+    Kokkos::deep_copy(Kokkos::View<uint64_t*, Kokkos::HostSpace, Unmanaged>(
+                          batch.position.data(), n),
+                      out_position);
+    Kokkos::deep_copy(HostAges(batch.ages.data(), n, 2), out_ages);
+    if constexpr (weighted)
+    {
+      batch.weights.resize(n);
+      Kokkos::deep_copy(
+          Kokkos::View<F*, Kokkos::HostSpace, Unmanaged>(batch.weights.data(),
+                                                         n),
+          out_weights);
+    }
+
+    inactive_counter += n;
+    force_remove_dead();
+    return batch;
+  }
+
+  template <ModelType Model>
+  void
+  ParticlesContainer<Model>::insert(
+      const ParticleBatch<typename Model::FloatType>& batch)
+  {
+    PROFILE_SECTION("ParticlesContainer::insert")
+    const std::size_t n = batch.size();
+    const bool weighted = !ConstWeightModelType<Model>;
+    if (batch.model.size() != n * Model::n_var || batch.ages.size() != n * 2
+        || batch.weights.size() != (weighted ? n : 0))
+    {
+      throw std::invalid_argument("ParticleBatch size mismatch");
+    }
+    if (n == 0)
+    {
+      return;
+    }
+
+    const std::size_t first = n_used_elements;
+    _resize(first + n);
+    const auto range = std::make_pair(first, first + n);
+
+    const auto d_model = Kokkos::subview(model, range, Kokkos::ALL);
+    const auto d_position = Kokkos::subview(position, range);
+    const auto d_ages = Kokkos::subview(ages, range, Kokkos::ALL);
+    auto h_model = Kokkos::create_mirror_view(d_model);
+    auto h_position = Kokkos::create_mirror_view(d_position);
+    auto h_ages = Kokkos::create_mirror_view(d_ages);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      for (std::size_t j = 0; j < Model::n_var; ++j)
+      {
+        h_model(i, j) = batch.model[i * Model::n_var + j];
+      }
+      h_position(i) = batch.position[i];
+      h_ages(i, 0) = batch.ages[i * 2];
+      h_ages(i, 1) = batch.ages[i * 2 + 1];
+    }
+    Kokkos::deep_copy(d_model, h_model);
+    Kokkos::deep_copy(d_position, h_position);
+    Kokkos::deep_copy(d_ages, h_ages);
+    Kokkos::deep_copy(Kokkos::subview(status, range), MC::Status::Idle);
+
+    if constexpr (!ConstWeightModelType<Model>)
+    {
+      const auto d_weights = Kokkos::subview(weights, range);
+      auto h_weights = Kokkos::create_mirror_view(d_weights);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        h_weights(i) = batch.weights[i];
+      }
+      Kokkos::deep_copy(d_weights, h_weights);
+    }
+
+    n_used_elements += n;
+    __allocate_buffer__();
+  }
+
   template <ModelType Model>
   void
   ParticlesContainer<Model>::_resize(std::size_t new_size, bool force)
@@ -617,6 +1023,19 @@ namespace MC
         // Update the allocated size
         n_allocated_elements = new_allocated_size;
 
+        if constexpr (Kokkos::SpaceAccessibility<
+                          Kokkos::HostSpace,
+                          ComputeSpace::memory_space>::accessible)
+        {
+          if (rt_params.first_touch && kernel_team != 0)
+          {
+            // Without force new_size is the number of particles once grown,
+            // forced resizes happen after n_used_elements is updated
+            _first_touch_resize(force ? n_used_elements : new_size);
+            return;
+          }
+        }
+
         // Perform the resizing on all relevant data containers
         Kokkos::resize(position, n_allocated_elements);
         Kokkos::resize(model,
@@ -642,6 +1061,142 @@ namespace MC
     }
   }
 
+  /**
+   * @brief Runs f(i) for i in [0, n_alloc) with the team mapping of the model
+   * kernel.
+   *
+   * [0, n_used) is launched as the model kernel over n_used particles: a
+   * league of c_league_size(n_used, npt) teams where team r owns particles
+   * [r * npt, (r + 1) * npt), so that OpenMP gives each particle to the
+   * thread which later updates it. The spare tail [n_used, n_alloc) gets its
+   * own league and does not shift this mapping.
+   */
+  template <typename ExecSpace, typename F>
+  void
+  first_touch_for(const ExecSpace& space,
+                  std::size_t n_used,
+                  std::size_t n_alloc,
+                  std::size_t npt,
+                  F f)
+  {
+    using Policy = Kokkos::TeamPolicy<ExecSpace>;
+    n_used = std::min(n_used, n_alloc);
+    const std::array<std::size_t, 3> bounds = { 0, n_used, n_alloc };
+    for (std::size_t k = 0; k < 2; ++k)
+    {
+      const std::size_t first = bounds[k];
+      const std::size_t last = bounds[k + 1];
+      if (first == last)
+      {
+        continue;
+      }
+      const auto league
+          = static_cast<int>(Common::c_league_size(last - first, npt));
+      Kokkos::parallel_for(
+          "first_touch",
+          Policy(space, league, Kokkos::AUTO(), Kokkos::AUTO()),
+          KOKKOS_LAMBDA(const typename Policy::member_type& team) {
+            const std::size_t begin = first + team.league_rank() * npt;
+            const std::size_t end = Kokkos::min(begin + npt, last);
+            Kokkos::parallel_for(Kokkos::TeamThreadRange(team, begin, end), f);
+          });
+    }
+  }
+
+  namespace
+  {
+    /**
+     * @brief Reallocate view to n_alloc rows, each row is first written
+     * (copied or value initialized) with first_touch_for so that its pages
+     * are placed on the NUMA node of the thread which later processes it.
+     *
+     * n_col_alloc is the second extent of rank 2 views, as given to
+     * Kokkos::resize (dynamic views have no static second extent)
+     */
+    template <typename ViewType, typename... Columns>
+    void
+    first_touch_realloc(ViewType& view,
+                        std::size_t n_kernel,
+                        std::size_t n_alloc,
+                        std::size_t npt,
+                        Columns... n_col_alloc)
+    {
+      static_assert(sizeof...(Columns) + 1 >= ViewType::rank_dynamic(),
+                    "Dynamic rank 2 views need their number of columns");
+      using T = typename ViewType::non_const_value_type;
+      ViewType old = view;
+      ViewType next(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, view.label()),
+          n_alloc,
+          n_col_alloc...);
+      const std::size_t n_copy = std::min<std::size_t>(old.extent(0), n_alloc);
+      const std::size_t n_col = next.extent(1);
+
+      first_touch_for(ComputeSpace(),
+                      n_kernel,
+                      n_alloc,
+                      npt,
+                      KOKKOS_LAMBDA(const std::size_t i) {
+                        if constexpr (ViewType::rank() == 1)
+                        {
+                          next(i) = (i < n_copy) ? old(i) : T{};
+                        }
+                        else
+                        {
+                          for (std::size_t j = 0; j < n_col; ++j)
+                          {
+                            next(i, j) = (i < n_copy) ? old(i, j) : T{};
+                          }
+                        }
+                      });
+      view = next;
+    }
+  } // namespace
+
+  template <ModelType Model>
+  void
+  ParticlesContainer<Model>::_first_touch_resize(const std::size_t n_kernel)
+  {
+    PROFILE_SECTION("ParticlesContainer::_first_touch_resize")
+    const std::size_t npt = kernel_team;
+    const std::size_t n_alloc = n_allocated_elements;
+    first_touch_realloc(position, n_kernel, n_alloc, npt);
+    // Same columns as the regular resize
+    first_touch_realloc(model, n_kernel, n_alloc, npt, Model::n_var);
+    first_touch_realloc(contribs, n_kernel, n_alloc, npt, Model::n_c);
+    first_touch_realloc(status, n_kernel, n_alloc, npt);
+    first_touch_realloc(ages, n_kernel, n_alloc, npt);
+    if constexpr (ConstWeightModelType<Model>)
+    {
+      Kokkos::resize(weights, 1);
+    }
+    else
+    {
+      first_touch_realloc(weights, n_kernel, n_alloc, npt);
+    }
+    Kokkos::fence();
+  }
+
+  template <ModelType Model>
+  void
+  ParticlesContainer<Model>::set_kernel_team(
+      const std::size_t particle_per_team)
+  {
+    const bool changed = kernel_team != particle_per_team;
+    kernel_team = particle_per_team;
+    if constexpr (Kokkos::SpaceAccessibility<
+                      Kokkos::HostSpace,
+                      ComputeSpace::memory_space>::accessible)
+    {
+      // Views allocated before the kernel was known are touched again
+      if (changed && rt_params.first_touch && kernel_team != 0
+          && n_allocated_elements != 0)
+      {
+        _first_touch_resize(n_used_elements);
+      }
+    }
+  }
+
   // template <ModelType Model>
   // void
   // ParticlesContainer<Model>::__allocate_buffer__()
@@ -682,6 +1237,7 @@ namespace MC
       Kokkos::realloc(buffer_model, required_buffer_size, Model::n_var);
       buffer_index() = 0;
     }
+    free_slots.reserve(required_buffer_size);
   }
 
 // NOLINTBEGIN
@@ -700,7 +1256,7 @@ namespace MC
         position(alloc_without_init("particle_position"), 0),
         status(alloc_without_init("particle_status"), 0),
         weights(alloc_without_init("particle_weigth"), 0),
-        ages(alloc_without_init("particle_age"), 0),
+        ages(alloc_without_init("particle_age"), 0), free_slots(0),
         buffer_model("buffer_particle_model", 0),
         buffer_position("buffer_particle_position", 0),
         buffer_index("buffer_index"), n_allocated_elements(0),
@@ -743,6 +1299,9 @@ namespace MC
       return;
     }
 
+    // Compaction moves particles, recorded slots are not valid anymore
+    free_slots.clear();
+
     if (to_remove == n_used_elements)
     {
       _resize(0, true);
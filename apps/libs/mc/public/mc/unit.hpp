@@ -1,6 +1,7 @@
 #ifndef __MC_UNIT_HPP__
 #define __MC_UNIT_HPP__
 
+#include <mc/diagnostics.hpp>
 #include <mc/domain.hpp>
 #include <mc/events.hpp>
 #include <mc/particles_container.hpp>
@@ -34,6 +35,9 @@ namespace MC
   {
     /// Container to manage and store simulation events
     EventContainer events;
+    /// Failures reported by kernels, drained by host after each step (not
+    /// saved)
+    DiagnosticChannel diagnostics;
     /// Domain in which the simulation is performed
     ReactorDomain domain;
 
@@ -53,8 +57,17 @@ namespace MC
 
     [[nodiscard]] uint64_t n_particle() const;
 
+    /**
+     * @brief Number of particles per compartment, in flowmap numbering
+     */
     [[nodiscard]] std::vector<uint64_t> getRepartition() const;
 
+    /**
+     * @brief Move particles to internal numbering and store it in domain
+     * @param new_to_old Flowmap index of each compartment
+     */
+    void renumber_compartments(std::vector<std::size_t> new_to_old);
+
     [[nodiscard]] std::vector<std::string> getSpeciesNames() const;
 
     template <class Archive>
@@ -0,0 +1,122 @@
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <common/logger.hpp>
+#include <cstddef>
+#include <mc/diagnostics.hpp>
+#include <string>
+#include <vector>
+
+namespace MC
+{
+  std::string_view
+  diagnostic_name(const DiagnosticCode code) noexcept
+  {
+    switch (code)
+    {
+    case DiagnosticCode::DivisionOverflow:
+      return "Division overflow";
+    default:
+      return "Unknown";
+    }
+  }
+
+  DiagnosticChannel::DiagnosticChannel(const std::size_t capacity)
+      : records("diagnostic_records", capacity),
+        counters("diagnostic_counters"), head("diagnostic_head")
+  {
+    Kokkos::deep_copy(counters, 0);
+  }
+
+  std::array<uint64_t, number_diagnostic_code>
+  DiagnosticChannel::drain(std::vector<DiagnosticRecord>& host_records)
+  {
+    Kokkos::fence();
+    std::array<uint64_t, number_diagnostic_code> counts{};
+    std::copy(counters.data(),
+              counters.data() + number_diagnostic_code,
+              counts.begin());
+
+    const std::size_t n_records
+        = std::min<std::size_t>(head(), records.extent(0));
+    host_records.resize(n_records);
+    if (n_records != 0)
+    {
+      Kokkos::View<DiagnosticRecord*, HostSpace, Kokkos::MemoryUnmanaged>
+          host_view(host_records.data(), n_records);
+      Kokkos::deep_copy(
+          host_view,
+          Kokkos::subview(records, std::make_pair(std::size_t{ 0 }, n_records)));
+    }
+
+    Kokkos::deep_copy(counters, 0);
+    head() = 0;
+    return counts;
+  }
+
+  DiagnosticReporter::DiagnosticReporter(const std::size_t _min_step_interval,
+                                         const std::size_t _max_sample)
+      : min_step_interval(_min_step_interval), max_sample(_max_sample)
+  {
+  }
+
+  uint64_t
+  DiagnosticReporter::process(DiagnosticChannel& channel, IO::Logger* logger)
+  {
+    const auto counts = channel.drain(host_records);
+    uint64_t n_drained = 0;
+
+    for (std::size_t i_code = 0; i_code < number_diagnostic_code; ++i_code)
+    {
+      n_drained += counts[i_code];
+      pending[i_code] += counts[i_code];
+      totals[i_code] += counts[i_code];
+
+      const bool can_report = !has_reported[i_code]
+                              || step - last_report[i_code] >= min_step_interval;
+
+      if (pending[i_code] == 0 || !can_report || logger == nullptr)
+      {
+        continue;
+      }
+
+      const auto code = static_cast<DiagnosticCode>(i_code);
+      std::string message
+          = IO::format(std::string(diagnostic_name(code)),
+                       ": ",
+                       std::to_string(pending[i_code]),
+                       " occurrence(s) (total ",
+                       std::to_string(totals[i_code]),
+                       ")");
+
+      std::size_t n_sample = 0;
+      for (const auto& record : host_records)
+      {
+        if (record.code != code || n_sample >= max_sample)
+        {
+          continue;
+        }
+        message += IO::format(" [id=",
+                              std::to_string(record.particle_id),
+                              " value=",
+                              std::to_string(record.value),
+                              "]");
+        ++n_sample;
+      }
+
+      logger->alert("Kernel", message);
+      pending[i_code] = 0;
+      last_report[i_code] = step;
+      has_reported[i_code] = true;
+    }
+
+    ++step;
+    return n_drained;
+  }
+
+  uint64_t
+  DiagnosticReporter::total(const DiagnosticCode code) const noexcept
+  {
+    return totals[static_cast<std::size_t>(code)];
+  }
+
+} // namespace MC
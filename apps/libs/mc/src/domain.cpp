@@ -6,6 +6,12 @@
 #include <cassert>
 #include <mc/domain.hpp>
 #include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace MC
 {
@@ -18,8 +24,10 @@ namespace MC
 
     this->_total_volume
         = std::reduce(volumes_liq.begin(), volumes_liq.end(), 0.);
-    Kokkos::View<const double*, HostSpace> tmp_host_volume(volumes_liq.data(),
-                                                           volumes_liq.size());
+    const auto rows = volumes_liq.subspan(first_row,
+                                          this->inner.liquid_volume.extent(0));
+    Kokkos::View<const double*, HostSpace> tmp_host_volume(rows.data(),
+                                                           rows.size());
     Kokkos::deep_copy(this->inner.liquid_volume, tmp_host_volume);
   }
 
@@ -54,22 +62,42 @@ namespace MC
       throw std::invalid_argument(
           "Neighbors and proba should have the same size");
     }
+    if (tables_shared && n_cols != inner.neighbors.extent(1))
+    {
+      throw std::invalid_argument(
+          "Number of neighbors does not match shared tables");
+    }
+    if (!tables_writer)
+    {
+      // Writer of the node copies the same tables
+      this->_total_volume = std::reduce(
+          newliquid_volume.begin(), newliquid_volume.end(), 0.);
+      return;
+    }
 
-    this->setLiquidNeighbors(n_rows, n_cols, neighors_flat);
+    // Only rows of kept compartments are copied
+    const auto n_kept = (kept_rows == 0) ? n_rows : kept_rows;
+    this->setLiquidNeighbors(
+        n_kept,
+        n_cols,
+        neighors_flat.subspan(first_row * n_cols, n_kept * n_cols));
     this->setVolumes(newliquid_volume);
 
-    KOKKOS_ASSERT(newliquid_volume.size()
-                  == this->inner.liquid_volume.extent(0));
+    KOKKOS_ASSERT(n_kept == this->inner.liquid_volume.extent(0));
 
     KOKKOS_ASSERT(proba_flat.size() % n_rows == 0);
 
-    DiagonalView<HostSpace, true> _diag_transition(out_flows.data(), n_rows);
+    DiagonalView<HostSpace, true> _diag_transition(out_flows.data() + first_row,
+                                                   n_kept);
     Kokkos::deep_copy(this->inner.diag_transition, _diag_transition);
 
-    const auto* chunk_proba = proba_flat.data();
+    const auto* chunk_proba = proba_flat.data() + first_row * n_cols;
     CumulativeProbabilityView<HostSpace, true> tmp_host_proba(
-        chunk_proba, n_rows, n_cols);
-    Kokkos::resize(this->inner.cumulative_probability, n_rows, n_cols);
+        chunk_proba, n_kept, n_cols);
+    if (!tables_shared)
+    {
+      Kokkos::resize(this->inner.cumulative_probability, n_kept, n_cols);
+    }
     Kokkos::deep_copy(this->inner.cumulative_probability, tmp_host_proba);
   }
 
@@ -89,7 +117,10 @@ namespace MC
 
     const auto* chunk = flat_data.data();
     HostNeighsView neighbors_view(chunk, e1, e2);
-    Kokkos::resize(this->inner.neighbors, e1, e2);
+    if (!tables_shared)
+    {
+      Kokkos::resize(this->inner.neighbors, e1, e2);
+    }
     Kokkos::deep_copy(this->inner.neighbors, neighbors_view);
   }
 
@@ -115,10 +146,18 @@ namespace MC
       this->id = other.id;
       this->size = other.size;
       this->_total_volume = other._total_volume;
+      this->new_to_old = std::move(other.new_to_old);
     }
     return *this;
   }
 
+  void
+  ReactorDomain::set_renumbering(std::vector<std::size_t> _new_to_old)
+  {
+    KOKKOS_ASSERT(_new_to_old.empty() || _new_to_old.size() == size);
+    this->new_to_old = std::move(_new_to_old);
+  }
+
   void
   ReactorDomain::init_inner(const std::size_t n_flows)
   {
@@ -138,4 +177,127 @@ namespace MC
     this->inner = _inner;
   }
 
+  std::size_t
+  ReactorDomain::shared_tables_size(const std::size_t n_compartments,
+                                    const std::size_t n_neighbors) noexcept
+  {
+    // Probabilities, diagonal and volumes as doubles then neighbors
+    return n_compartments
+           * ((n_neighbors + 2) * sizeof(double)
+              + n_neighbors * sizeof(std::size_t));
+  }
+
+  void
+  ReactorDomain::share_tables(std::span<std::byte> memory,
+                              const std::size_t n_neighbors,
+                              const bool writer)
+  {
+    constexpr bool is_const = false;
+    if constexpr (!Kokkos::SpaceAccessibility<
+                      HostSpace,
+                      ComputeSpace::memory_space>::accessible)
+    {
+      throw std::logic_error("Domain tables on device cannot be shared");
+    }
+    if (kept_rows != 0)
+    {
+      throw std::logic_error("Restricted domain tables cannot be shared");
+    }
+    const auto n_c = this->getNumberCompartments();
+    if (memory.size() < shared_tables_size(n_c, n_neighbors))
+    {
+      throw std::invalid_argument("Shared memory is too small for tables");
+    }
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto* probabilities = reinterpret_cast<double*>(memory.data());
+    auto* diagonal = probabilities + n_c * n_neighbors;
+    auto* volumes = diagonal + n_c;
+    auto* neighbors = reinterpret_cast<std::size_t*>(volumes + n_c);
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+
+    // clang-format off
+    inner.cumulative_probability = CumulativeProbabilityView<ComputeSpace,is_const>(probabilities, n_c, n_neighbors);
+    inner.diag_transition = DiagonalView<ComputeSpace,is_const>(diagonal, n_c);
+    inner.liquid_volume = VolumeView<ComputeSpace,is_const>(volumes, n_c);
+    inner.neighbors = NeighborsView<ComputeSpace,is_const>(neighbors, n_c, n_neighbors);
+    // clang-format on
+    tables_shared = true;
+    tables_writer = writer;
+  }
+
+  void
+  ReactorDomain::own_tables()
+  {
+    if (!tables_shared)
+    {
+      return;
+    }
+    const auto copy = [](auto& view, const std::string& label)
+    {
+      std::remove_reference_t<decltype(view)> owned(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, label),
+          view.layout());
+      Kokkos::deep_copy(owned, view);
+      view = owned;
+    };
+    copy(inner.neighbors, "neighbors");
+    copy(inner.diag_transition, "diag_transition");
+    copy(inner.liquid_volume, "liquid_volume");
+    copy(inner.cumulative_probability, "cumulative_proba");
+    tables_shared = false;
+    tables_writer = true;
+  }
+
+  void
+  ReactorDomain::restrict_tables(const std::size_t first,
+                                 const std::size_t end)
+  {
+    if (tables_shared)
+    {
+      throw std::logic_error("Shared domain tables cannot be restricted");
+    }
+    if (first >= end || end > size)
+    {
+      throw std::invalid_argument("Compartment range is out of the domain");
+    }
+    const auto n_kept = end - first;
+    const auto first_kept = first - first_row;
+    const auto range = std::make_pair(first_kept, first_kept + n_kept);
+
+    // Rows are copied if tables were already set by an update
+    const auto keep = [&](auto& view, const std::string& label)
+    {
+      using view_type = std::remove_reference_t<decltype(view)>;
+      const bool filled = view.extent(0) != 0;
+      if constexpr (view_type::rank() == 1)
+      {
+        view_type kept(Kokkos::view_alloc(Kokkos::WithoutInitializing, label),
+                       n_kept);
+        if (filled)
+        {
+          Kokkos::deep_copy(kept, Kokkos::subview(view, range));
+        }
+        view = kept;
+      }
+      else
+      {
+        view_type kept(Kokkos::view_alloc(Kokkos::WithoutInitializing, label),
+                       filled ? n_kept : 0,
+                       view.extent(1));
+        if (filled)
+        {
+          Kokkos::deep_copy(kept, Kokkos::subview(view, range, Kokkos::ALL));
+        }
+        view = kept;
+      }
+    };
+    keep(inner.neighbors, "neighbors");
+    keep(inner.diag_transition, "diag_transition");
+    keep(inner.liquid_volume, "liquid_volume");
+    keep(inner.cumulative_probability, "cumulative_proba");
+    first_row = first;
+    kept_rows = n_kept;
+  }
+
 } // namespace MC
@@ -7,27 +7,36 @@
 namespace MC
 {
 
-  pool_type
-  get_pool(std::size_t seed)
+  namespace
   {
-
-    if (seed == 0)
+    std::size_t
+    resolve_seed(std::size_t seed)
     {
-      // #ifndef NDEBUG
-      //       seed = AutoGenerated::MC::debug_MC_RAND_DEFAULT_SEED;
-      // #else
-      //       seed = std::random_device{}();
-      // #endif
+      if (seed == 0)
+      {
+        // #ifndef NDEBUG
+        //       seed = AutoGenerated::MC::debug_MC_RAND_DEFAULT_SEED;
+        // #else
+        //       seed = std::random_device{}();
+        // #endif
 #ifdef FIX_SEED
-      seed = AutoGenerated::MC::debug_MC_RAND_DEFAULT_SEED;
+        seed = AutoGenerated::MC::debug_MC_RAND_DEFAULT_SEED;
 #else
-      seed = std::random_device{}();
+        seed = std::random_device{}();
 #endif
+      }
+      return seed;
     }
-    return (seed);
+  } // namespace
+
+  pool_type
+  get_pool(std::size_t seed)
+  {
+    return (resolve_seed(seed));
   }
 
-  KPRNG::KPRNG(size_t _seed) : seed(_seed)
+  // Drawn seed is kept so that a checkpoint can restart from it
+  KPRNG::KPRNG(size_t _seed) : seed(resolve_seed(_seed))
   {
     random_pool = get_pool(this->seed);
   };
@@ -99,6 +99,19 @@ namespace
     }
   };
 
+  // Flowmap compartment index to internal index
+  struct RenumberFunctor
+  {
+    MC::ParticlePositions positions;
+    Kokkos::View<const uint64_t*, ComputeSpace> old_to_new;
+
+    KOKKOS_FUNCTION void
+    operator()(const std::size_t i_particle) const
+    {
+      positions(i_particle) = old_to_new(positions(i_particle));
+    }
+  };
+
   template <ModelType Model> struct InitFunctor
   {
     explicit InitFunctor(MC::ParticlesContainer<Model> _list,
@@ -224,11 +237,51 @@ namespace MC
     auto host = Kokkos::create_mirror_view_and_copy(HostSpace(), n_cells);
 
     std::vector<uint64_t> dist(n_compartment);
-    std::memcpy(dist.data(), host.data(), host.size() * sizeof(uint64_t));
+    const auto new_to_old = domain.renumbering();
+    if (new_to_old.empty())
+    {
+      std::memcpy(dist.data(), host.data(), host.size() * sizeof(uint64_t));
+    }
+    else
+    {
+      for (std::size_t i = 0; i < n_compartment; ++i)
+      {
+        dist[new_to_old[i]] = host(i);
+      }
+    }
 
     return dist;
   }
 
+  void
+  MonteCarloUnit::renumber_compartments(std::vector<std::size_t> new_to_old)
+  {
+    const auto n_compartment = domain.getNumberCompartments();
+    KOKKOS_ASSERT(new_to_old.size() == n_compartment);
+
+    Kokkos::View<uint64_t*, HostSpace> host_old_to_new("old_to_new",
+                                                       n_compartment);
+    for (std::size_t i = 0; i < n_compartment; ++i)
+    {
+      host_old_to_new(new_to_old[i]) = i;
+    }
+    const auto old_to_new
+        = Kokkos::create_mirror_view_and_copy(ComputeSpace(), host_old_to_new);
+
+    std::visit(
+        [&old_to_new](auto&& _container)
+        {
+          Kokkos::parallel_for(
+              "renumber_compartments",
+              Kokkos::RangePolicy<ComputeSpace>(0, _container.n_particles()),
+              RenumberFunctor{ _container.position, old_to_new });
+        },
+        container);
+    Kokkos::fence();
+
+    domain.set_renumbering(std::move(new_to_old));
+  }
+
   void
   post_init_weight(std::unique_ptr<MonteCarloUnit>& unit,
                    double x0,
@@ -335,11 +388,16 @@ namespace MC
                             AutoGenerated::MC::default_shink_ratio,
                             0.,
                             1.);
+
+    // Team size comes from the kernel options, see set_kernel_team
+    const auto first_touch = Common::read_env_or("BIOMC_NUMA", false);
+
     return { minimum_dead_particle_removal,
              buffer_ratio,
              allocation_factor,
              shink_ratio,
-             dead_particle_ratio_threshold };
+             dead_particle_ratio_threshold,
+             first_touch };
   }
 
 } // namespace MC
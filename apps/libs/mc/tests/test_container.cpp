@@ -72,6 +72,31 @@ div_test()
   KOKKOS_ASSERT(container.get_buffer_index() == ndiv);
 }
 
+template <ModelType M>
+void
+reserve_div_test()
+{
+  const std::size_t size = 1000;
+  const std::size_t ndiv = 10;
+  MC::ParticlesContainer<M> container(MC::load_tuning_constant(), size, 0);
+  MC::pool_type rng;
+  // One reservation for all daughters, as done per team in cycle kernel
+  Kokkos::parallel_for(
+      "spawn", 1, KOKKOS_LAMBDA(const int) {
+        const auto reservation = container.reserve_division(ndiv);
+        KOKKOS_ASSERT(reservation.n_buffer == ndiv);
+        for (std::size_t i = 0; i < ndiv; ++i)
+        {
+          KOKKOS_ASSERT(container.handle_division(rng, i, reservation, i));
+        }
+        KOKKOS_ASSERT(!container.handle_division(rng, 0, reservation, ndiv));
+      });
+  Kokkos::fence();
+  KOKKOS_ASSERT(container.get_buffer_index() == ndiv);
+  container.merge_buffer();
+  KOKKOS_ASSERT(container.n_particles() == ndiv + size);
+}
+
 template <ModelType M>
 void
 merge_test()
@@ -147,15 +172,237 @@ clean_test_and_shrink()
   KOKKOS_ASSERT(container.n_particles() == size - to_remove);
 }
 
+template <ModelType M>
+void
+recycle_test()
+{
+  const std::size_t size = 1000;
+  const std::size_t n_exit = 5; // Below removal threshold
+  const std::size_t ndiv = 10;
+  MC::ParticlesContainer<M> container(MC::load_tuning_constant(), size, 0);
+  MC::pool_type rng;
+  Kokkos::parallel_for(
+      "exit", n_exit, KOKKOS_LAMBDA(const int i) {
+        container.status(i) = MC::Status::Exit;
+        container.free_slots.push(i);
+      });
+  Kokkos::fence();
+  container.update_and_remove_inactive(n_exit, 0);
+  KOKKOS_ASSERT(container.get_inactive() == n_exit);
+  KOKKOS_ASSERT(container.free_slots.size() == n_exit);
+
+  // First divisions use released slots, remaining ones go to buffer
+  Kokkos::parallel_for(
+      "spawn", ndiv, KOKKOS_LAMBDA(const int i) {
+        KOKKOS_ASSERT(container.handle_division(rng, n_exit + i));
+      });
+  Kokkos::fence();
+  KOKKOS_ASSERT(container.get_buffer_index() == ndiv - n_exit);
+
+  container.update_and_remove_inactive(0, 0);
+  KOKKOS_ASSERT(container.get_inactive() == 0);
+  KOKKOS_ASSERT(container.free_slots.size() == 0);
+
+  container.merge_buffer();
+  KOKKOS_ASSERT(container.n_particles() == size + ndiv - n_exit);
+
+  std::size_t n_idle = 0;
+  const auto status = container.status;
+  Kokkos::parallel_reduce(
+      "count_idle",
+      container.n_particles(),
+      KOKKOS_LAMBDA(const int i, std::size_t& local) {
+        local += (status(i) == MC::Status::Idle) ? 1 : 0;
+      },
+      n_idle);
+  KOKKOS_ASSERT(n_idle == container.n_particles());
+}
+
+template <ModelType M>
+void
+migration_test()
+{
+  const std::size_t size = 1000;
+  const std::size_t n_move = 100;
+  const std::size_t n_dead = 10;
+  MC::ParticlesContainer<M> sender(MC::load_tuning_constant(), size, 0);
+  MC::ParticlesContainer<M> receiver(MC::load_tuning_constant(), size / 2, 0);
+
+  const auto position = sender.position;
+  const auto status = sender.status;
+  Kokkos::parallel_for(
+      "tag", size, KOKKOS_LAMBDA(const int i) {
+        position(i) = i;
+        const bool dead = static_cast<std::size_t>(i) < n_dead;
+        status(i) = dead ? MC::Status::Dead : MC::Status::Idle;
+      });
+  Kokkos::fence();
+  sender.update_and_remove_inactive(0, n_dead);
+
+  // Dead particles are removed before extraction
+  const auto batch = sender.extract(n_move);
+  KOKKOS_ASSERT(batch.size() == n_move);
+  KOKKOS_ASSERT(sender.n_particles() == size - n_dead - n_move);
+  KOKKOS_ASSERT(batch.model.size() == n_move * M::n_var);
+  for (const auto p : batch.position)
+  {
+    KOKKOS_ASSERT(p >= n_dead);
+  }
+
+  receiver.insert(batch);
+  KOKKOS_ASSERT(receiver.n_particles() == size / 2 + n_move);
+  const auto h_position = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace(), receiver.position);
+  for (std::size_t i = 0; i < n_move; ++i)
+  {
+    KOKKOS_ASSERT(h_position(size / 2 + i) == batch.position[i]);
+  }
+
+  // Extracting more than available empties the container
+  const auto all = receiver.extract(10 * size);
+  KOKKOS_ASSERT(all.size() == size / 2 + n_move);
+  KOKKOS_ASSERT(receiver.n_particles() == 0);
+
+  // Particles out of the owned compartment range
+  const uint64_t begin = 200;
+  const uint64_t end = 500;
+  const auto n_before = sender.n_particles();
+  const auto outside = sender.extract_outside(begin, end);
+  KOKKOS_ASSERT(outside.size() == n_before - (end - begin));
+  KOKKOS_ASSERT(sender.n_particles() == end - begin);
+  for (const auto p : outside.position)
+  {
+    KOKKOS_ASSERT(p < begin || p >= end);
+  }
+  const auto kept_range = std::make_pair<std::size_t, std::size_t>(
+      0, static_cast<std::size_t>(end - begin));
+  const auto h_kept = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace(), Kokkos::subview(sender.position, kept_range));
+  for (std::size_t i = 0; i < end - begin; ++i)
+  {
+    KOKKOS_ASSERT(h_kept(i) >= begin && h_kept(i) < end);
+  }
+  KOKKOS_ASSERT(sender.extract_outside(begin, end).size() == 0);
+}
+
+template <ModelType M>
+void
+first_touch_test()
+{
+  const std::size_t size = 1000;
+  auto params = MC::load_tuning_constant();
+  params.first_touch = true;
+  MC::ParticlesContainer<M> container(params, size, 0);
+  container.set_kernel_team(32);
+  MC::ParticlesContainer<M> other(MC::load_tuning_constant(), 2 * size, 0);
+
+  const auto position = container.position;
+  const auto model = container.model;
+  const auto other_position = other.position;
+  const auto other_model = other.model;
+  const auto other_status = other.status;
+  Kokkos::parallel_for(
+      "tag", 2 * size, KOKKOS_LAMBDA(const int i) {
+        if (static_cast<std::size_t>(i) < size)
+        {
+          position(i) = i;
+          model(i, 0) = static_cast<typename M::FloatType>(i);
+        }
+        other_position(i) = size + i;
+        other_model(i, 0) = static_cast<typename M::FloatType>(size + i);
+        other_status(i) = MC::Status::Idle;
+      });
+  Kokkos::fence();
+
+  // Growing above capacity reallocates with the first touch kernel
+  const auto batch = other.extract(2 * size);
+  container.insert(batch);
+  KOKKOS_ASSERT(container.n_particles() == 3 * size);
+  KOKKOS_ASSERT(container.position.extent(0) == container.capacity());
+  KOKKOS_ASSERT(container.model.extent(0) == container.capacity());
+  KOKKOS_ASSERT(container.model.extent(1) == M::n_var);
+  KOKKOS_ASSERT(container.contribs.extent(1) == M::n_c);
+  KOKKOS_ASSERT(container.ages.extent(0) == container.capacity());
+
+  const auto h_position = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace(), container.position);
+  const auto h_model = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace(), container.model);
+  for (std::size_t i = 0; i < 3 * size; ++i)
+  {
+    KOKKOS_ASSERT(h_position(i) == i);
+    KOKKOS_ASSERT(h_model(i, 0) == static_cast<typename M::FloatType>(i));
+  }
+}
+
+// Thread of each particle in the model kernel launch (launch_model and
+// ModelKernel) and in the first touch, for a league that does not divide
+// the number of threads and a spare tail
+void
+first_touch_mapping_test()
+{
+  using Space = Kokkos::DefaultHostExecutionSpace;
+  using Policy = Kokkos::TeamPolicy<Space>;
+  const std::size_t npt = 32;
+  const std::size_t n_used = 1000;
+  const std::size_t n_alloc = 1500;
+  const Kokkos::View<int*, Kokkos::HostSpace> kernel_thread("kernel_thread",
+                                                            n_used);
+  const Kokkos::View<int*, Kokkos::HostSpace> touch_thread("touch_thread",
+                                                           n_alloc);
+  Kokkos::deep_copy(touch_thread, -1);
+
+  Kokkos::parallel_for(
+      "kernel_mapping",
+      Policy(Space(),
+             static_cast<int>(Common::c_league_size(n_used, npt)),
+             Kokkos::AUTO(),
+             Kokkos::AUTO()),
+      KOKKOS_LAMBDA(const Policy::member_type& team) {
+        const std::size_t p0 = team.league_rank() * npt;
+        const auto upper_bound = ((p0 + npt) >= n_used) ? n_used - p0 : npt;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange(team, 0, upper_bound),
+                             [&](std::size_t relative_index)
+                             {
+                               kernel_thread(p0 + relative_index)
+                                   = Space::impl_hardware_thread_id();
+                             });
+      });
+
+  MC::first_touch_for(Space(),
+                      n_used,
+                      n_alloc,
+                      npt,
+                      KOKKOS_LAMBDA(const std::size_t i) {
+                        touch_thread(i) = Space::impl_hardware_thread_id();
+                      });
+  Kokkos::fence();
+
+  for (std::size_t i = 0; i < n_used; ++i)
+  {
+    KOKKOS_ASSERT(kernel_thread(i) == touch_thread(i));
+  }
+  for (std::size_t i = n_used; i < n_alloc; ++i)
+  {
+    KOKKOS_ASSERT(touch_thread(i) >= 0);
+  }
+}
+
 int
 main()
 {
   Kokkos::ScopeGuard guard;
   basic_test<DefaultModel>();
   div_test<DefaultModel>();
+  reserve_div_test<DefaultModel>();
   merge_test<DefaultModel>();
   clean_test<DefaultModel>();
   clean_test_and_shrink<DefaultModel>();
+  recycle_test<DefaultModel>();
+  migration_test<DefaultModel>();
+  first_touch_test<DefaultModel>();
+  first_touch_test<DynamicDefaultModel>();
+  first_touch_mapping_test();
 }
 
 // int
@@ -0,0 +1,56 @@
+#include <Kokkos_Assert.hpp>
+#include <Kokkos_Core.hpp>
+#include <mc/diagnostics.hpp>
+#include <vector>
+
+void
+storm_test()
+{
+  const std::size_t capacity = 8;
+  const std::size_t n_report = 10000;
+  MC::DiagnosticChannel channel(capacity);
+  Kokkos::parallel_for(
+      "report", n_report, KOKKOS_LAMBDA(const int i) {
+        channel.report(MC::DiagnosticCode::DivisionOverflow, i, 1.);
+      });
+  Kokkos::fence();
+
+  std::vector<MC::DiagnosticRecord> records;
+  const auto counts = channel.drain(records);
+  KOKKOS_ASSERT(counts[0] == n_report);
+  KOKKOS_ASSERT(records.size() == capacity);
+  for (const auto& r : records)
+  {
+    KOKKOS_ASSERT(r.code == MC::DiagnosticCode::DivisionOverflow);
+    KOKKOS_ASSERT(r.particle_id < n_report);
+  }
+
+  // Channel is reset after drain
+  const auto counts_2 = channel.drain(records);
+  KOKKOS_ASSERT(counts_2[0] == 0);
+  KOKKOS_ASSERT(records.empty());
+}
+
+void
+reporter_test()
+{
+  MC::DiagnosticChannel channel(4);
+  MC::DiagnosticReporter reporter(2);
+  for (int step = 0; step < 5; ++step)
+  {
+    Kokkos::parallel_for(
+        "report", 3, KOKKOS_LAMBDA(const int i) {
+          channel.report(MC::DiagnosticCode::DivisionOverflow, i, 0.);
+        });
+    KOKKOS_ASSERT(reporter.process(channel, nullptr) == 3);
+  }
+  KOKKOS_ASSERT(reporter.total(MC::DiagnosticCode::DivisionOverflow) == 15);
+}
+
+int
+main()
+{
+  Kokkos::ScopeGuard guard;
+  storm_test();
+  reporter_test();
+}
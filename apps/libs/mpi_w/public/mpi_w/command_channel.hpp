@@ -0,0 +1,78 @@
+#ifndef __MPI_W_COMMAND_CHANNEL_HPP__
+#define __MPI_W_COMMAND_CHANNEL_HPP__
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mpi.h>
+#include <mpi_w/message_t.hpp>
+
+namespace WrapMPI
+{
+
+  /**
+   * @brief Commands sent by root to every other rank as nonblocking
+   * broadcasts on a communicator of their own.
+   *
+   * All ranks get a command from the same collective instead of one message
+   * per rank. As the communicator is duplicated, commands are ordered between
+   * themselves only and root can post a command while other collectives are
+   * pending.
+   *
+   * Waiting ranks test the broadcast with an exponential backoff (sleep from
+   * 1 µs up to max_backoff) instead of busy polling, so that they do not
+   * steal cores from threads of other ranks on the node.
+   */
+  class CommandChannel
+  {
+  public:
+    /**
+     * @brief Collective on MPI_COMM_WORLD
+     * @param max_backoff Longest sleep between two tests, 0 blocks in
+     * MPI_Wait
+     */
+    explicit CommandChannel(std::size_t root = 0,
+                            std::chrono::microseconds max_backoff
+                            = std::chrono::microseconds(100));
+
+    ~CommandChannel();
+    CommandChannel(const CommandChannel&) = delete;
+    CommandChannel(CommandChannel&&) = delete;
+    CommandChannel& operator=(const CommandChannel&) = delete;
+    CommandChannel& operator=(CommandChannel&&) = delete;
+
+    /**
+     * @brief Root side: start sending signal to every other rank, does not
+     * wait for previous commands
+     */
+    void post(SIGNALS signal);
+
+    /**
+     * @brief Other ranks: wait for the next command
+     */
+    [[nodiscard]] SIGNALS wait();
+
+    /**
+     * @brief Complete posted commands and free the communicator. Every rank
+     * must call it at the same point, right after STOP. Called by destructor
+     * if not called before.
+     */
+    void release() noexcept;
+
+  private:
+    struct Pending
+    {
+      SIGNALS signal;
+      MPI_Request request;
+    };
+
+    MPI_Comm comm = MPI_COMM_NULL;
+    int root;
+    std::chrono::microseconds max_backoff;
+    // Deque keeps buffers of pending broadcasts in place
+    std::deque<Pending> pending;
+  };
+
+} // namespace WrapMPI
+
+#endif //__MPI_W_COMMAND_CHANNEL_HPP__
@@ -0,0 +1,85 @@
+#ifndef __MPI_W_COMPRESSED_EXCHANGE_HPP__
+#define __MPI_W_COMPRESSED_EXCHANGE_HPP__
+
+#include <cstddef>
+#include <mpi.h>
+#include <mpi_w/payload_codec.hpp>
+#include <span>
+#include <vector>
+
+namespace WrapMPI
+{
+
+  /**
+   * @brief Reduced volume replacement of the contribution reduction (workers
+   * to root) and of the concentration broadcast (root to workers).
+   *
+   * Contributions are sent point to point as encoded messages and summed by
+   * root, concentrations are broadcast as float32 deltas when the policy
+   * allows it, as double otherwise.
+   */
+  class CompressedExchange
+  {
+  public:
+    CompressedExchange(CompressionPolicy policy, std::size_t n_concentration);
+
+    ~CompressedExchange();
+    CompressedExchange(const CompressedExchange&) = delete;
+    CompressedExchange(CompressedExchange&&) = delete;
+    CompressedExchange& operator=(const CompressedExchange&) = delete;
+    CompressedExchange& operator=(CompressedExchange&&) = delete;
+
+    /**
+     * @brief Worker side: encode values and start sending them to root.
+     * Values are copied, the message stays valid until request completes.
+     */
+    int send_contributions(std::span<const double> values,
+                           std::size_t root,
+                           MPI_Request& request);
+
+    /**
+     * @brief Root side: start receiving the message of every other rank, for
+     * contribution arrays of n_values
+     */
+    void recv_contributions(std::size_t n_values,
+                            std::size_t root,
+                            std::size_t n_rank);
+
+    /**
+     * @brief Root side: complete receives started by recv_contributions and
+     * add messages to values. Does nothing if no receive is pending.
+     */
+    void wait_add_contributions(std::span<double> values);
+
+    /**
+     * @brief Complete pending receives, messages are dropped
+     */
+    void wait_pending() noexcept;
+
+    /**
+     * @brief Start the concentration broadcast, values are read on root and
+     * must be given to finish_concentration on other ranks once request
+     * completes
+     */
+    int broadcast_concentration(std::span<double> values,
+                                std::size_t root,
+                                bool is_root,
+                                MPI_Request& request);
+
+    /**
+     * @brief Receiver side: decode broadcast concentration into values
+     */
+    void finish_concentration(std::span<double> values);
+
+  private:
+    CompressionPolicy policy;
+    ContributionCodec contributions;
+    DeltaCodec concentrations;
+    std::vector<std::vector<std::byte>> recv_buffers;
+    std::vector<MPI_Request> recv_requests;
+    std::vector<MPI_Status> recv_status;
+  };
+
+} // namespace WrapMPI
+
+#endif //__MPI_W_COMPRESSED_EXCHANGE_HPP__
@@ -144,6 +144,69 @@ namespace WrapMPI::Async
     return _broadcast_unsafe(data.data(), data.size(), root, request);
   }
 
+  /**
+   * @brief Start the sum of data over all ranks into root, in place on root.
+   *
+   * With MPI >= 4 the request is persistent: it is created at the first call
+   * (request must be MPI_REQUEST_NULL) and restarted by the following ones, so
+   * data must keep the same address and size. Otherwise a new MPI_Ireduce is
+   * posted each call. Complete with wait() and release with free().
+   */
+  template <POD_t T>
+  int
+  reduce_sum_span(std::span<T> data,
+                  size_t root,
+                  bool is_root,
+                  MPI_Request& request)
+  {
+    const void* send_buffer = is_root ? MPI_IN_PLACE : data.data();
+    void* recv_buffer = is_root ? data.data() : nullptr;
+#if MPI_VERSION >= 4
+    if (request == MPI_REQUEST_NULL)
+    {
+      const int init_status = MPI_Reduce_init(send_buffer,
+                                              recv_buffer,
+                                              static_cast<int>(data.size()),
+                                              get_type<T>(),
+                                              MPI_SUM,
+                                              static_cast<int>(root),
+                                              MPI_COMM_WORLD,
+                                              MPI_INFO_NULL,
+                                              &request);
+      if (init_status != MPI_SUCCESS)
+      {
+        return init_status;
+      }
+    }
+    return MPI_Start(&request);
+#else
+    return MPI_Ireduce(send_buffer,
+                       recv_buffer,
+                       static_cast<int>(data.size()),
+                       get_type<T>(),
+                       MPI_SUM,
+                       static_cast<int>(root),
+                       MPI_COMM_WORLD,
+                       &request);
+#endif
+  }
+
+  /**
+   * @brief Complete and release a request, persistent or not
+   */
+  inline void
+  free(MPI_Request& request)
+  {
+    if (request != MPI_REQUEST_NULL)
+    {
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+    }
+    if (request != MPI_REQUEST_NULL)
+    {
+      MPI_Request_free(&request);
+    }
+  }
+
 } // namespace WrapMPI::Async
 
 #endif
\ No newline at end of file
@@ -318,6 +318,48 @@ namespace WrapMPI
     return global_sum;
   }
 
+  /**
+   * @brief Gathers one value of every process on all processes
+   *
+   * @return Values ordered by rank
+   */
+  template <POD_t T>
+  std::vector<T>
+  all_gather(T data, size_t n_rank)
+  {
+    std::vector<T> result(n_rank);
+    MPI_Allgather(&data,
+                  1,
+                  get_type<T>(),
+                  result.data(),
+                  1,
+                  get_type<T>(),
+                  MPI_COMM_WORLD);
+    return result;
+  }
+
+  /**
+   * @brief Sends data[i] to process i and receives one value from every
+   * process
+   *
+   * @param data One value per process, size must be n_rank
+   * @return Received values ordered by source rank
+   */
+  template <POD_t T>
+  std::vector<T>
+  all_to_all(std::span<const T> data, size_t n_rank)
+  {
+    std::vector<T> result(n_rank);
+    MPI_Alltoall(data.data(),
+                 1,
+                 get_type<T>(),
+                 result.data(),
+                 1,
+                 get_type<T>(),
+                 MPI_COMM_WORLD);
+    return result;
+  }
+
   /**
    * @brief Gathers a vector of data from all processes.
    *
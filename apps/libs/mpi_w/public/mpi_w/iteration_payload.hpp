@@ -1,7 +1,10 @@
 #ifndef __ITERATION_PAYLOAD_HPP__
 #define __ITERATION_PAYLOAD_HPP__
 
+#include <array>
 #include <cma_utils/alias.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <mpi.h>
 #include <span>
 #include <vector>
@@ -9,6 +12,18 @@
 namespace WrapMPI
 {
 
+  /**
+   * @brief Copy of the flowmap arrays of an iteration payload, kept on every
+   * rank so that a flowmap already sent is only referenced by its slot.
+   */
+  struct FlowmapSlot
+  {
+    std::vector<double> liquid_volumes;
+    std::vector<std::size_t> liquid_neighbors_flat;
+    std::vector<double> proba_leaving_flat;
+    std::vector<double> liquid_out_flows;
+  };
+
   /**
    * @class IterationPayload
    * @brief Represents the payload of data exchanged during an iteration.
@@ -56,8 +71,13 @@ namespace WrapMPI
      *
      * @note This method uses MPI to perform the receive operation and assumes
      * the MPI environment is initialized.
+     * @note If the host references a cached flowmap, arrays are copied from
+     * the local slot and only the slot number is received.
      */
     bool recv(size_t source, MPI_Status* status) noexcept;
+
+  private:
+    std::vector<FlowmapSlot> slots;
   };
 
   /**
@@ -69,8 +89,21 @@ namespace WrapMPI
   class HostIterationPayload
   {
   public:
+    HostIterationPayload() = default;
+
+    /**
+     * @param cache_capacity Number of flowmaps kept by workers. A flowmap
+     * equal to a cached one is sent as its slot number only, 0 sends every
+     * array at each update.
+     */
+    explicit HostIterationPayload(std::size_t cache_capacity);
+
     void fill(const CmaUtils::IterationStatePtrType& current_reactor_state);
 
+    /**
+     * @brief Start sending the payload to every other rank, which must have
+     * received the HydroUpdate command first
+     */
     [[nodiscard]] bool sendAll(std::size_t n_rank) noexcept;
 
     void wait() noexcept;
@@ -82,7 +115,7 @@ namespace WrapMPI
     std::span<const double> proba_leaving_flat;
     std::span<const double> liquid_out_flows;
 
-    bool to_wait;
+    bool to_wait = false;
 
     /**
      * @brief Sends this payload to a specified MPI rank.
@@ -91,14 +124,28 @@ namespace WrapMPI
      * to a specified destination rank using MPI.
      *
      * @param rank The MPI rank of the destination process.
+     * @param cached Only send the slot number, workers already hold arrays
      *
      * @note This method uses MPI to perform the send operation and assumes the
      * MPI environment is initialized.
      */
-    [[nodiscard]] bool send(size_t rank) noexcept;
+    [[nodiscard]] bool send(size_t rank, bool cached) noexcept;
+
+    /**
+     * @brief Find the slot of the current arrays, or store them in a new
+     * slot (oldest one when cache is full)
+     * @return True if the arrays were already cached
+     */
+    bool select_slot();
+
+    std::size_t cache_capacity = 0;
+    std::size_t next_slot = 0;
+    std::vector<FlowmapSlot> slots;
+    // Slot number and cache hit flag, must live until sends complete
+    std::array<std::uint64_t, 2> header{};
 
-    static constexpr std::size_t n_vector_send = 4;
-    std::array<MPI_Request, n_vector_send> requests;
+    static constexpr std::size_t n_vector_send = 5;
+    std::vector<MPI_Request> requests;
   };
 
 } // namespace WrapMPI
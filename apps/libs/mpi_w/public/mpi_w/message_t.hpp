@@ -15,7 +15,8 @@ namespace WrapMPI
     HydroUpdate,
     RUN,
     NOP,
-    DUMP
+    DUMP,
+    Migrate
   };
 
   template <typename T>
@@ -1,6 +1,7 @@
 #ifndef __MPI_TYPES_HPP__
 #define __MPI_TYPES_HPP__
 
+#include <cstddef>
 #include <mpi.h>
 #include <mpi_w/message_t.hpp>
 #include <type_traits>
@@ -24,6 +25,10 @@ namespace WrapMPI
     {
       datatype = MPI_DOUBLE;
     }
+    else if constexpr (std::is_same_v<_type, float>)
+    {
+      datatype = MPI_FLOAT;
+    }
     else if constexpr (std::is_same_v<_type, int>)
     {
       datatype = MPI_INT;
@@ -33,6 +38,7 @@ namespace WrapMPI
       datatype = MPI_CXX_BOOL;
     }
     else if constexpr (std::is_same_v<_type, char>
+                       || std::is_same_v<_type, std::byte>
                        || std::is_same_v<_type, WrapMPI::SIGNALS>)
     {
       datatype = MPI_BYTE;
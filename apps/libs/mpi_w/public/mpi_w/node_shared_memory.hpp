@@ -0,0 +1,90 @@
+#ifndef __MPI_W_NODE_SHARED_MEMORY_HPP__
+#define __MPI_W_NODE_SHARED_MEMORY_HPP__
+
+#include <cstddef>
+#include <mpi.h>
+#include <span>
+
+namespace WrapMPI
+{
+
+  /**
+   * @brief Memory written by one rank of a node and read in place by the
+   * other ranks of the node (MPI-3 shared memory).
+   *
+   * Members are grouped by node with MPI_Comm_split_type, the lowest member
+   * rank of each node is the writer and owns the memory of the node. Ranks
+   * which are not members take no part in calls after the constructor.
+   *
+   * Memory is allocated once, when its size is known. Accesses are ordered
+   * by barrier(): writes done before a barrier are seen by reads done after
+   * it on every rank of the node.
+   */
+  class NodeSharedMemory
+  {
+  public:
+    /**
+     * @brief Collective on MPI_COMM_WORLD
+     */
+    explicit NodeSharedMemory(bool member);
+
+    ~NodeSharedMemory();
+    NodeSharedMemory(const NodeSharedMemory&) = delete;
+    NodeSharedMemory(NodeSharedMemory&&) = delete;
+    NodeSharedMemory& operator=(const NodeSharedMemory&) = delete;
+    NodeSharedMemory& operator=(NodeSharedMemory&&) = delete;
+
+    /**
+     * @brief Allocate n_bytes on the writer of each node and return them on
+     * every member. Collective on the members of the node, n_bytes must be
+     * the same on all of them.
+     */
+    std::span<std::byte> allocate(std::size_t n_bytes);
+
+    /**
+     * @brief Node barrier with memory synchronisation, collective on the
+     * members of the node
+     */
+    void barrier() noexcept;
+
+    /**
+     * @brief Free window and communicator, collective on the members of the
+     * node. Called by destructor if not called before.
+     */
+    void release() noexcept;
+
+    [[nodiscard]] bool
+    is_member() const noexcept
+    {
+      return node_comm != MPI_COMM_NULL;
+    }
+
+    [[nodiscard]] bool
+    is_writer() const noexcept
+    {
+      return is_member() && node_rank == 0;
+    }
+
+    [[nodiscard]] bool
+    is_allocated() const noexcept
+    {
+      return window_allocated;
+    }
+
+    [[nodiscard]] std::span<std::byte>
+    memory() const noexcept
+    {
+      return shared;
+    }
+
+  private:
+    MPI_Comm node_comm = MPI_COMM_NULL;
+    int node_rank = 0;
+    MPI_Win window{};
+    bool window_allocated = false;
+    std::span<std::byte> shared;
+  };
+
+} // namespace WrapMPI
+
+#endif //__MPI_W_NODE_SHARED_MEMORY_HPP__
@@ -0,0 +1,99 @@
+#ifndef __MPI_W_PARTITIONED_EXCHANGE_HPP__
+#define __MPI_W_PARTITIONED_EXCHANGE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <mpi.h>
+#include <span>
+#include <vector>
+
+namespace WrapMPI
+{
+
+  /**
+   * @brief Replacement of the contribution reduction and of the concentration
+   * broadcast when each rank owns a contiguous range of compartments.
+   *
+   * Arrays hold block values per compartment (one per species), a rank only
+   * sends the values of its compartments to root and only receives these
+   * values from root. Root arrays hold every compartment, arrays of other
+   * ranks only hold their own compartments (first one at index 0).
+   */
+  class PartitionedExchange
+  {
+  public:
+    /**
+     * @brief Storage of the block values of each compartment
+     */
+    enum class Layout : char
+    {
+      CompartmentMajor, ///< Contiguous block per compartment (LayoutLeft)
+      SpeciesMajor      ///< Row of compartments per species (LayoutRight)
+    };
+
+    /**
+     * @param offsets First compartment of each rank followed by the number of
+     * compartments (size n_rank + 1)
+     * @throw std::invalid_argument if offsets are not increasing
+     */
+    explicit PartitionedExchange(std::vector<uint64_t> offsets);
+
+    PartitionedExchange(const PartitionedExchange&) = delete;
+    PartitionedExchange(PartitionedExchange&&) = delete;
+    PartitionedExchange& operator=(const PartitionedExchange&) = delete;
+    PartitionedExchange& operator=(PartitionedExchange&&) = delete;
+    ~PartitionedExchange();
+
+    /**
+     * @brief Start gathering the owned values on root, root values are left
+     * in place
+     */
+    int gather(std::span<double> values,
+               Layout layout,
+               std::size_t root,
+               std::size_t rank,
+               MPI_Request& request);
+
+    /**
+     * @brief Start sending to each rank its owned values, values are read on
+     * root
+     */
+    int scatter(std::span<double> values,
+                Layout layout,
+                std::size_t root,
+                std::size_t rank,
+                MPI_Request& request);
+
+  private:
+    /**
+     * @brief Counts, displacements and datatype of the collective, in
+     * compartments of column_type for species major values
+     */
+    struct Partition
+    {
+      const std::vector<int>& counts;
+      const std::vector<int>& displacements;
+      MPI_Datatype type;
+    };
+
+    Partition set_block(std::size_t n_values,
+                        Layout layout,
+                        std::size_t n_compartments);
+    void free_column_type() noexcept;
+
+    std::vector<uint64_t> offsets;
+    std::size_t block = 0;
+    std::size_t stride = 0; ///< Compartments of species major values
+    // Arguments of nonblocking collectives must live until completion
+    std::vector<int> counts;
+    std::vector<int> displacements;
+    std::vector<int> column_counts;
+    std::vector<int> column_displacements;
+    // One compartment of species major values of stride compartments, extent
+    // of one double
+    MPI_Datatype column_type = MPI_DATATYPE_NULL;
+  };
+
+} // namespace WrapMPI
+
+#endif //__MPI_W_PARTITIONED_EXCHANGE_HPP__
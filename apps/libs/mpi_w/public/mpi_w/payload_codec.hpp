@@ -0,0 +1,123 @@
+#ifndef __MPI_W_PAYLOAD_CODEC_HPP__
+#define __MPI_W_PAYLOAD_CODEC_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace WrapMPI
+{
+
+  /**
+   * @brief Encoding of a contribution message, selected for each message
+   */
+  enum class PayloadEncoding : std::uint8_t
+  {
+    Dense64 = 0, // Full array as double (exact)
+    Dense32,     // Full array as float
+    Sparse64,    // (index, value) of non zero entries as double (exact)
+    Sparse32     // (index, value) of non zero entries as float
+  };
+
+  /**
+   * @brief Codec settings, must be the same on every rank
+   */
+  struct CompressionPolicy
+  {
+    // Allow float32 contributions and concentration deltas. Exact encodings
+    // are kept when a value does not fit in a float.
+    bool allow_float32 = false;
+  };
+
+  /**
+   * @brief Encode contribution arrays into a self describing byte message.
+   *
+   * The smallest encoding is chosen for each message: sparse lists when few
+   * entries are non zero (a rank with no particle in most compartments),
+   * dense otherwise. Float32 is only used if allowed by the policy and if
+   * every value is representable (finite, non zero stays non zero),
+   * otherwise the exact double encoding is used.
+   */
+  class ContributionCodec
+  {
+  public:
+    explicit ContributionCodec(CompressionPolicy policy = {}) noexcept;
+
+    /**
+     * @brief Encode values into the internal message buffer
+     * @return Encoding selected
+     */
+    PayloadEncoding encode(std::span<const double> values);
+
+    /**
+     * @brief Last encoded message, valid until next encode
+     */
+    [[nodiscard]] std::span<const std::byte>
+    message() const noexcept
+    {
+      return buffer;
+    }
+
+    /**
+     * @brief Upper bound of message size for n_values, whatever the encoding
+     */
+    static std::size_t max_message_size(std::size_t n_values) noexcept;
+
+    /**
+     * @brief Add the values of message to values
+     * @throw std::invalid_argument if message is malformed or if its size
+     * differs from values
+     */
+    static void decode_add(std::span<const std::byte> message,
+                           std::span<double> values);
+
+  private:
+    CompressionPolicy policy;
+    std::vector<std::byte> buffer;
+    std::vector<std::uint32_t> non_zero;
+  };
+
+  /**
+   * @brief Float32 deltas of an array sent at every step.
+   *
+   * Sender and receivers hold the same reference, the values reconstructed
+   * from the deltas already exchanged. The sender encodes the difference
+   * between exact values and this reference, so rounding errors do not
+   * accumulate over steps: receivers are within float precision of the
+   * last step change.
+   */
+  class DeltaCodec
+  {
+  public:
+    explicit DeltaCodec(std::size_t size);
+
+    /**
+     * @brief Sender side: compute deltas from values and update reference
+     * @return Deltas to send
+     */
+    std::span<const float> encode(std::span<const double> values);
+
+    /**
+     * @brief Receiver side: buffer in which deltas are received
+     */
+    [[nodiscard]] std::span<float>
+    deltas() noexcept
+    {
+      return m_deltas;
+    }
+
+    /**
+     * @brief Receiver side: apply received deltas and copy reference to
+     * values
+     */
+    void decode(std::span<double> values);
+
+  private:
+    std::vector<double> reference;
+    std::vector<float> m_deltas;
+  };
+
+} // namespace WrapMPI
+
+#endif //__MPI_W_PAYLOAD_CODEC_HPP__
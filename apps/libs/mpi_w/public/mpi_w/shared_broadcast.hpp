@@ -0,0 +1,119 @@
+#ifndef __MPI_W_SHARED_BROADCAST_HPP__
+#define __MPI_W_SHARED_BROADCAST_HPP__
+
+#include <array>
+#include <cstddef>
+#include <mpi.h>
+#include <span>
+
+namespace WrapMPI
+{
+
+  /**
+   * @brief Broadcast through one leader per node and a node shared window
+   * (MPI-3 shared memory).
+   *
+   * Ranks of a node are grouped with MPI_Comm_split_type, the lowest rank of
+   * each node (root on its node) is the leader. Root only sends to leaders,
+   * leaders receive in a window allocated once per node with
+   * MPI_Win_allocate_shared and other ranks of the node copy values from
+   * this window.
+   *
+   * The window holds two buffers used alternately from one broadcast to the
+   * next: a node barrier per broadcast is enough to never overwrite values
+   * still read by a rank of the node.
+   *
+   * In place, the window holds a single buffer that ranks other than root
+   * read directly (node_values) between finish and the next start instead
+   * of copying it. start then waits until every rank of the node is done
+   * with the previous values before the buffer is written.
+   */
+  class SharedBroadcast
+  {
+  public:
+    /**
+     * @brief Collective on MPI_COMM_WORLD
+     * @param n_values Number of broadcast values, same for every call
+     * @param in_place Ranks other than root read values from the window
+     */
+    SharedBroadcast(std::size_t n_values,
+                    std::size_t root,
+                    bool in_place = false);
+
+    ~SharedBroadcast();
+    SharedBroadcast(const SharedBroadcast&) = delete;
+    SharedBroadcast(SharedBroadcast&&) = delete;
+    SharedBroadcast& operator=(const SharedBroadcast&) = delete;
+    SharedBroadcast& operator=(SharedBroadcast&&) = delete;
+
+    /**
+     * @brief Start the broadcast of values (read on root). request is
+     * MPI_REQUEST_NULL on ranks which are not leaders.
+     */
+    int start(std::span<double> values, MPI_Request& request);
+
+    /**
+     * @brief Once request completes: publish values to the node (leaders) or
+     * copy them from the node window (other ranks, values is not used in
+     * place). Root returns without waiting for the ranks of its node.
+     */
+    void finish(std::span<double> values);
+
+    /**
+     * @brief Complete the node barrier pending on root
+     */
+    void wait_pending() noexcept;
+
+    /**
+     * @brief Free window and communicators, collective on the ranks of the
+     * node. Called by destructor if not called before.
+     */
+    void release() noexcept;
+
+    [[nodiscard]] bool
+    is_leader() const noexcept
+    {
+      return leader_comm != MPI_COMM_NULL;
+    }
+
+    [[nodiscard]] int
+    node_size() const noexcept
+    {
+      return n_node_rank;
+    }
+
+    [[nodiscard]] bool
+    is_in_place() const noexcept
+    {
+      return in_place;
+    }
+
+    /**
+     * @brief Values of the node window read in place, valid until release
+     */
+    [[nodiscard]] std::span<double>
+    node_values() const noexcept
+    {
+      return { shared[0], n_values };
+    }
+
+  private:
+    [[nodiscard]] double* buffer() const noexcept;
+    void node_barrier(MPI_Request& request) noexcept;
+
+    std::size_t n_values;
+    bool is_root;
+    bool in_place;
+    int n_node_rank = 1;
+    std::size_t parity = 0;
+    MPI_Comm node_comm = MPI_COMM_NULL;
+    MPI_Comm leader_comm = MPI_COMM_NULL;
+    MPI_Win window{};
+    bool window_allocated = false;
+    std::array<double*, 2> shared{};
+    MPI_Request pending_barrier = MPI_REQUEST_NULL;
+  };
+
+} // namespace WrapMPI
+
+#endif //__MPI_W_SHARED_BROADCAST_HPP__
@@ -1,9 +1,14 @@
 #ifndef __WRAP_MPI_HPP__
 #define __WRAP_MPI_HPP__
 
+#include <mpi_w/command_channel.hpp>
+#include <mpi_w/compressed_exchange.hpp>
 #include <mpi_w/impl_async.hpp>
 #include <mpi_w/impl_op.hpp>
 #include <mpi_w/iteration_payload.hpp>
 #include <mpi_w/message_t.hpp>
+#include <mpi_w/node_shared_memory.hpp>
+#include <mpi_w/partitioned_exchange.hpp>
+#include <mpi_w/shared_broadcast.hpp>
 
 #endif //__WRAP_MPI_HPP__
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <chrono>
+#include <common/common.hpp>
+#include <cstddef>
+#include <mpi.h>
+#include <mpi_w/command_channel.hpp>
+#include <thread>
+
+namespace WrapMPI
+{
+
+  CommandChannel::CommandChannel(std::size_t _root,
+                                 std::chrono::microseconds _max_backoff)
+      : root(static_cast<int>(_root)), max_backoff(_max_backoff)
+  {
+    MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+  }
+
+  CommandChannel::~CommandChannel()
+  {
+    release();
+  }
+
+  void
+  CommandChannel::post(SIGNALS signal)
+  {
+    PROFILE_SECTION("WrapMPI::post_command")
+    // Forget commands already received by every rank
+    while (!pending.empty())
+    {
+      int done = 0;
+      MPI_Test(&pending.front().request, &done, MPI_STATUS_IGNORE);
+      if (done == 0)
+      {
+        break;
+      }
+      pending.pop_front();
+    }
+
+    auto& command = pending.emplace_back(Pending{ signal, MPI_REQUEST_NULL });
+    MPI_Ibcast(&command.signal,
+               sizeof(SIGNALS),
+               MPI_CHAR,
+               root,
+               comm,
+               &command.request);
+  }
+
+  SIGNALS
+  CommandChannel::wait()
+  {
+    SIGNALS signal{};
+    MPI_Request request = MPI_REQUEST_NULL;
+    MPI_Ibcast(&signal, sizeof(SIGNALS), MPI_CHAR, root, comm, &request);
+
+    if (max_backoff.count() == 0)
+    {
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+      return signal;
+    }
+
+    // Next command usually follows soon, sleep is short first
+    auto delay = std::chrono::microseconds(1);
+    int done = 0;
+    MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+    while (done == 0)
+    {
+      std::this_thread::sleep_for(delay);
+      delay = std::min(delay * 2, max_backoff);
+      MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+    }
+    return signal;
+  }
+
+  void
+  CommandChannel::release() noexcept
+  {
+    if (comm == MPI_COMM_NULL)
+    {
+      return;
+    }
+    for (auto& command : pending)
+    {
+      MPI_Wait(&command.request, MPI_STATUS_IGNORE);
+    }
+    pending.clear();
+    MPI_Comm_free(&comm);
+  }
+
+} // namespace WrapMPI
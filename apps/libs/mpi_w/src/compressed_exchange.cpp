@@ -0,0 +1,141 @@
+#include <common/common.hpp>
+#include <cstddef>
+#include <mpi.h>
+#include <mpi_w/compressed_exchange.hpp>
+#include <mpi_w/impl_async.hpp>
+#include <mpi_w/mpi_types.hpp>
+#include <span>
+
+namespace WrapMPI
+{
+  namespace
+  {
+    // Distinct from iteration payload and signal tags
+    constexpr int contribution_tag = 16;
+  } // namespace
+
+  CompressedExchange::CompressedExchange(CompressionPolicy _policy,
+                                         std::size_t n_concentration)
+      : policy(_policy), contributions(_policy),
+        concentrations(n_concentration)
+  {
+  }
+
+  CompressedExchange::~CompressedExchange()
+  {
+    wait_pending();
+  }
+
+  int
+  CompressedExchange::send_contributions(std::span<const double> values,
+                                         std::size_t root,
+                                         MPI_Request& request)
+  {
+    PROFILE_SECTION("WrapMPI::send_contributions")
+    contributions.encode(values);
+    const auto message = contributions.message();
+    return MPI_Isend(message.data(),
+                     static_cast<int>(message.size()),
+                     MPI_BYTE,
+                     static_cast<int>(root),
+                     contribution_tag,
+                     MPI_COMM_WORLD,
+                     &request);
+  }
+
+  void
+  CompressedExchange::recv_contributions(std::size_t n_values,
+                                         std::size_t root,
+                                         std::size_t n_rank)
+  {
+    PROFILE_SECTION("WrapMPI::recv_contributions")
+    wait_pending();
+    recv_buffers.resize(n_rank);
+    recv_requests.assign(n_rank, MPI_REQUEST_NULL);
+    recv_status.resize(n_rank);
+    for (std::size_t rank = 0; rank < n_rank; ++rank)
+    {
+      if (rank == root)
+      {
+        continue;
+      }
+      auto& buffer = recv_buffers[rank];
+      buffer.resize(ContributionCodec::max_message_size(n_values));
+      MPI_Irecv(buffer.data(),
+                static_cast<int>(buffer.size()),
+                MPI_BYTE,
+                static_cast<int>(rank),
+                contribution_tag,
+                MPI_COMM_WORLD,
+                &recv_requests[rank]);
+    }
+  }
+
+  void
+  CompressedExchange::wait_add_contributions(std::span<double> values)
+  {
+    PROFILE_SECTION("WrapMPI::wait_add_contributions")
+    if (recv_requests.empty())
+    {
+      return;
+    }
+    MPI_Waitall(static_cast<int>(recv_requests.size()),
+                recv_requests.data(),
+                recv_status.data());
+    for (std::size_t rank = 0; rank < recv_requests.size(); ++rank)
+    {
+      if (recv_buffers[rank].empty())
+      {
+        continue;
+      }
+      int count = 0;
+      MPI_Get_count(&recv_status[rank], MPI_BYTE, &count);
+      ContributionCodec::decode_add(
+          std::span<const std::byte>(recv_buffers[rank])
+              .first(static_cast<std::size_t>(count)),
+          values);
+    }
+    recv_requests.clear();
+  }
+
+  void
+  CompressedExchange::wait_pending() noexcept
+  {
+    if (!recv_requests.empty())
+    {
+      MPI_Waitall(static_cast<int>(recv_requests.size()),
+                  recv_requests.data(),
+                  MPI_STATUSES_IGNORE);
+      recv_requests.clear();
+    }
+  }
+
+  int
+  CompressedExchange::broadcast_concentration(std::span<double> values,
+                                              std::size_t root,
+                                              bool is_root,
+                                              MPI_Request& request)
+  {
+    if (!policy.allow_float32)
+    {
+      return Async::broadcast_span(values, root, request);
+    }
+
+    auto deltas = concentrations.deltas();
+    if (is_root)
+    {
+      concentrations.encode(values);
+    }
+    return Async::broadcast_span(deltas, root, request);
+  }
+
+  void
+  CompressedExchange::finish_concentration(std::span<double> values)
+  {
+    if (policy.allow_float32)
+    {
+      concentrations.decode(values);
+    }
+  }
+
+} // namespace WrapMPI
@@ -1,5 +1,8 @@
 #include "mpi_w/impl_op.hpp"
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <mpi.h>
 #include <mpi_w/iteration_payload.hpp>
 #include <mpi_w/wrap_mpi.hpp>
@@ -12,30 +15,93 @@ namespace WrapMPI
     volumes = 0,
     flows,
     proba,
-    neighbors
+    neighbors,
+    slot
   };
 
+  namespace
+  {
+    // Slot number sent when the flowmap is not cached
+    constexpr std::uint64_t no_slot = std::numeric_limits<std::uint64_t>::max();
+
+    template <typename T>
+    bool
+    same(std::span<const T> lhs, const std::vector<T>& rhs) noexcept
+    {
+      return std::ranges::equal(lhs, rhs);
+    }
+  } // namespace
+
   IterationPayload::IterationPayload(const size_t volumes)
       : liquid_volumes(volumes), liquid_out_flows(volumes)
   {
   }
 
+  HostIterationPayload::HostIterationPayload(std::size_t _cache_capacity)
+      : cache_capacity(_cache_capacity)
+  {
+  }
+
+  bool
+  HostIterationPayload::select_slot()
+  {
+    PROFILE_SECTION("host:select_slot")
+    if (cache_capacity == 0)
+    {
+      header = { no_slot, 0 };
+      return false;
+    }
+
+    for (std::size_t i = 0; i < slots.size(); ++i)
+    {
+      const auto& cached = slots[i];
+      // Volumes usually differ between flowmaps, comparison stops early
+      if (same(liquid_volumes, cached.liquid_volumes)
+          && same(liquid_out_flows, cached.liquid_out_flows)
+          && same(proba_leaving_flat, cached.proba_leaving_flat)
+          && same(liquid_neighbors_flat, cached.liquid_neighbors_flat))
+      {
+        header = { i, 1 };
+        return true;
+      }
+    }
+
+    const std::size_t i_slot = next_slot;
+    next_slot = (next_slot + 1) % cache_capacity;
+    if (i_slot == slots.size())
+    {
+      slots.emplace_back();
+    }
+    auto& cached = slots[i_slot];
+    cached.liquid_volumes.assign(liquid_volumes.begin(), liquid_volumes.end());
+    cached.liquid_out_flows.assign(liquid_out_flows.begin(),
+                                   liquid_out_flows.end());
+    cached.proba_leaving_flat.assign(proba_leaving_flat.begin(),
+                                     proba_leaving_flat.end());
+    cached.liquid_neighbors_flat.assign(liquid_neighbors_flat.begin(),
+                                        liquid_neighbors_flat.end());
+    header = { i_slot, 0 };
+    return false;
+  }
+
   [[nodiscard]] bool
   HostIterationPayload::sendAll(std::size_t n_rank) noexcept
   {
     PROFILE_SECTION("host:sendAll")
-    bool flag = false;
+    bool flag = true;
     if (n_rank == 1)
     {
       to_wait = false;
       return true;
     }
 
+    const bool cached = select_slot();
+    requests.clear();
+    requests.reserve((n_rank - 1) * n_vector_send);
+    // HydroUpdate command is sent before by the caller
     for (size_t __macro_j = 1; __macro_j < n_rank; ++__macro_j)
     {
-      auto _ = WrapMPI::send(WrapMPI::SIGNALS::HydroUpdate,
-                             __macro_j); // Need to be synchro
-      flag = this->send(__macro_j);
+      flag = this->send(__macro_j, cached) && flag;
     }
     to_wait = true;
 
@@ -51,34 +117,67 @@ namespace WrapMPI
       {
         MPI_Wait(&req, MPI_STATUS_IGNORE); // Wait for each send to finish
       }
+      requests.clear();
       to_wait = false;
     }
   }
 
   bool
-  HostIterationPayload::send(const size_t rank) noexcept
+  HostIterationPayload::send(const size_t rank, const bool cached) noexcept
   {
     PROFILE_SECTION("host:to_node")
 
+    requests.emplace_back();
+    int rc0 = WrapMPI::Async::send_v<std::uint64_t>(
+        requests.back(), header, rank, TagExchange::slot, false);
+    if (cached)
+    {
+      return rc0 == MPI_SUCCESS;
+    }
+
+    requests.emplace_back();
     int rc1 = WrapMPI::Async::send_v(
-        requests[0], liquid_volumes, rank, TagExchange::volumes, false);
+        requests.back(), liquid_volumes, rank, TagExchange::volumes, false);
 
+    requests.emplace_back();
     int rc2 = WrapMPI::Async::send_v(
-        requests[1], liquid_out_flows, rank, TagExchange::flows, false);
+        requests.back(), liquid_out_flows, rank, TagExchange::flows, false);
 
+    requests.emplace_back();
     int rc3 = WrapMPI::Async::send_v(
-        requests[2], proba_leaving_flat, rank, TagExchange::proba, true);
+        requests.back(), proba_leaving_flat, rank, TagExchange::proba, true);
 
-    int rc4 = WrapMPI::Async::send_v(
-        requests[3], liquid_neighbors_flat, rank, TagExchange::neighbors, true);
+    requests.emplace_back();
+    int rc4 = WrapMPI::Async::send_v(requests.back(),
+                                     liquid_neighbors_flat,
+                                     rank,
+                                     TagExchange::neighbors,
+                                     true);
 
-    return rc1 == MPI_SUCCESS && rc2 == MPI_SUCCESS && rc3 == MPI_SUCCESS
-           && rc4 == MPI_SUCCESS;
+    return rc0 == MPI_SUCCESS && rc1 == MPI_SUCCESS && rc2 == MPI_SUCCESS
+           && rc3 == MPI_SUCCESS && rc4 == MPI_SUCCESS;
   }
 
   bool
   IterationPayload::recv(const size_t source, MPI_Status* status) noexcept
   {
+    std::array<std::uint64_t, 2> header{};
+    int rc0 = WrapMPI::recv_span<std::uint64_t>(
+        header, source, status, TagExchange::slot);
+    const auto i_slot = header[0];
+    if (header[1] != 0)
+    {
+      if (rc0 != MPI_SUCCESS || i_slot >= slots.size())
+      {
+        return false;
+      }
+      const auto& cached = slots[i_slot];
+      liquid_volumes = cached.liquid_volumes;
+      liquid_out_flows = cached.liquid_out_flows;
+      proba_leaving_flat = cached.proba_leaving_flat;
+      liquid_neighbors_flat = cached.liquid_neighbors_flat;
+      return true;
+    }
 
     int rc1 = WrapMPI::recv_span<double>(
         liquid_volumes, source, status, TagExchange::volumes);
@@ -101,7 +200,20 @@ namespace WrapMPI
 
     liquid_neighbors_flat = opt.value();
 
-    return rc1 == MPI_SUCCESS && rc2 == MPI_SUCCESS;
+    if (i_slot != no_slot)
+    {
+      // Host stores the same arrays in the same slot
+      if (i_slot >= slots.size())
+      {
+        slots.resize(i_slot + 1);
+      }
+      slots[i_slot] = { liquid_volumes,
+                        liquid_neighbors_flat,
+                        proba_leaving_flat,
+                        liquid_out_flows };
+    }
+
+    return rc0 == MPI_SUCCESS && rc1 == MPI_SUCCESS && rc2 == MPI_SUCCESS;
   }
 
   void
@@ -114,4 +226,4 @@ namespace WrapMPI
     proba_leaving_flat = state->flat_probability_leaving();
   }
 
-} // namespace WrapMPI
\ No newline at end of file
+} // namespace WrapMPI
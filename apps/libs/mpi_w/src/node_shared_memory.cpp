@@ -0,0 +1,100 @@
+#include <common/common.hpp>
+#include <cstddef>
+#include <mpi.h>
+#include <mpi_w/node_shared_memory.hpp>
+#include <span>
+#include <stdexcept>
+
+namespace WrapMPI
+{
+
+  NodeSharedMemory::NodeSharedMemory(bool member)
+  {
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm members = MPI_COMM_NULL;
+    MPI_Comm_split(
+        MPI_COMM_WORLD, member ? 0 : MPI_UNDEFINED, rank, &members);
+    if (members == MPI_COMM_NULL)
+    {
+      return;
+    }
+    MPI_Comm_split_type(
+        members, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+    MPI_Comm_free(&members);
+    MPI_Comm_rank(node_comm, &node_rank);
+  }
+
+  NodeSharedMemory::~NodeSharedMemory()
+  {
+    release();
+  }
+
+  std::span<std::byte>
+  NodeSharedMemory::allocate(std::size_t n_bytes)
+  {
+    PROFILE_SECTION("WrapMPI::node_shared_allocate")
+    if (!is_member() || window_allocated)
+    {
+      throw std::logic_error("Node shared memory is already allocated");
+    }
+
+    // Writer owns the memory, other ranks attach with an empty segment
+    const std::size_t n_local = is_writer() ? n_bytes : 0;
+    std::byte* local_base = nullptr;
+    MPI_Win_allocate_shared(static_cast<MPI_Aint>(n_local),
+                            1,
+                            MPI_INFO_NULL,
+                            node_comm,
+                            &local_base,
+                            &window);
+    window_allocated = true;
+
+    MPI_Aint writer_size = 0;
+    int disp_unit = 0;
+    std::byte* writer_base = nullptr;
+    MPI_Win_shared_query(window, 0, &writer_size, &disp_unit, &writer_base);
+    shared = { writer_base, static_cast<std::size_t>(writer_size) };
+
+    // Passive epoch for the lifetime of the window, memory ordering comes
+    // from MPI_Win_sync around node barriers
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+    return shared;
+  }
+
+  void
+  NodeSharedMemory::barrier() noexcept
+  {
+    PROFILE_SECTION("WrapMPI::node_shared_barrier")
+    if (!is_member())
+    {
+      return;
+    }
+    if (window_allocated)
+    {
+      MPI_Win_sync(window);
+    }
+    MPI_Barrier(node_comm);
+    if (window_allocated)
+    {
+      MPI_Win_sync(window);
+    }
+  }
+
+  void
+  NodeSharedMemory::release() noexcept
+  {
+    if (window_allocated)
+    {
+      MPI_Win_unlock_all(window);
+      MPI_Win_free(&window);
+      window_allocated = false;
+      shared = {};
+    }
+    if (node_comm != MPI_COMM_NULL)
+    {
+      MPI_Comm_free(&node_comm);
+    }
+  }
+
+} // namespace WrapMPI
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <common/common.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <mpi.h>
+#include <mpi_w/partitioned_exchange.hpp>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace WrapMPI
+{
+
+  PartitionedExchange::PartitionedExchange(std::vector<uint64_t> _offsets)
+      : offsets(std::move(_offsets))
+  {
+    if (offsets.size() < 2 || !std::ranges::is_sorted(offsets)
+        || offsets.front() != 0)
+    {
+      throw std::invalid_argument("Partition offsets are not increasing");
+    }
+    const std::size_t n_rank = offsets.size() - 1;
+    column_counts.resize(n_rank);
+    column_displacements.resize(n_rank);
+    for (std::size_t i = 0; i < n_rank; ++i)
+    {
+      column_counts[i] = static_cast<int>(offsets[i + 1] - offsets[i]);
+      column_displacements[i] = static_cast<int>(offsets[i]);
+    }
+  }
+
+  PartitionedExchange::~PartitionedExchange()
+  {
+    free_column_type();
+  }
+
+  void
+  PartitionedExchange::free_column_type() noexcept
+  {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (column_type != MPI_DATATYPE_NULL && finalized == 0)
+    {
+      MPI_Type_free(&column_type);
+    }
+    column_type = MPI_DATATYPE_NULL;
+  }
+
+  PartitionedExchange::Partition
+  PartitionedExchange::set_block(std::size_t n_values,
+                                 Layout layout,
+                                 std::size_t n_compartments)
+  {
+    if (n_compartments == 0 || n_values % n_compartments != 0)
+    {
+      throw std::invalid_argument("Values do not match partition");
+    }
+    const std::size_t new_block = n_values / n_compartments;
+    if (new_block != block || n_compartments != stride || counts.empty())
+    {
+      block = new_block;
+      stride = n_compartments;
+      const std::size_t n_rank = offsets.size() - 1;
+      counts.resize(n_rank);
+      displacements.resize(n_rank);
+      for (std::size_t i = 0; i < n_rank; ++i)
+      {
+        counts[i] = static_cast<int>((offsets[i + 1] - offsets[i]) * block);
+        displacements[i] = static_cast<int>(offsets[i] * block);
+      }
+
+      // Block values stride compartments apart, resized so that consecutive
+      // compartments start one double apart
+      free_column_type();
+      MPI_Datatype column = MPI_DATATYPE_NULL;
+      MPI_Type_vector(static_cast<int>(block),
+                      1,
+                      static_cast<int>(stride),
+                      MPI_DOUBLE,
+                      &column);
+      MPI_Type_create_resized(column, 0, sizeof(double), &column_type);
+      MPI_Type_commit(&column_type);
+      MPI_Type_free(&column);
+    }
+
+    if (layout == Layout::SpeciesMajor)
+    {
+      return { column_counts, column_displacements, column_type };
+    }
+    return { counts, displacements, MPI_DOUBLE };
+  }
+
+  int
+  PartitionedExchange::gather(std::span<double> values,
+                              Layout layout,
+                              std::size_t root,
+                              std::size_t rank,
+                              MPI_Request& request)
+  {
+    PROFILE_SECTION("WrapMPI::partitioned_gather")
+    if (rank == root)
+    {
+      const auto partition = set_block(values.size(), layout, offsets.back());
+      return MPI_Igatherv(MPI_IN_PLACE,
+                          0,
+                          MPI_DOUBLE,
+                          values.data(),
+                          partition.counts.data(),
+                          partition.displacements.data(),
+                          partition.type,
+                          static_cast<int>(root),
+                          MPI_COMM_WORLD,
+                          &request);
+    }
+    const auto partition = set_block(
+        values.size(), layout, offsets[rank + 1] - offsets[rank]);
+    return MPI_Igatherv(values.data(),
+                        partition.counts[rank],
+                        partition.type,
+                        nullptr,
+                        nullptr,
+                        nullptr,
+                        MPI_DOUBLE,
+                        static_cast<int>(root),
+                        MPI_COMM_WORLD,
+                        &request);
+  }
+
+  int
+  PartitionedExchange::scatter(std::span<double> values,
+                               Layout layout,
+                               std::size_t root,
+                               std::size_t rank,
+                               MPI_Request& request)
+  {
+    PROFILE_SECTION("WrapMPI::partitioned_scatter")
+    if (rank == root)
+    {
+      const auto partition = set_block(values.size(), layout, offsets.back());
+      return MPI_Iscatterv(values.data(),
+                           partition.counts.data(),
+                           partition.displacements.data(),
+                           partition.type,
+                           MPI_IN_PLACE,
+                           0,
+                           MPI_DOUBLE,
+                           static_cast<int>(root),
+                           MPI_COMM_WORLD,
+                           &request);
+    }
+    const auto partition = set_block(
+        values.size(), layout, offsets[rank + 1] - offsets[rank]);
+    return MPI_Iscatterv(nullptr,
+                         nullptr,
+                         nullptr,
+                         MPI_DOUBLE,
+                         values.data(),
+                         partition.counts[rank],
+                         partition.type,
+                         static_cast<int>(root),
+                         MPI_COMM_WORLD,
+                         &request);
+  }
+
+} // namespace WrapMPI
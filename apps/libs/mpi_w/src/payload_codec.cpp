@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mpi_w/payload_codec.hpp>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  using WrapMPI::PayloadEncoding;
+
+  struct MessageHeader
+  {
+    std::uint64_t n_values;
+    std::uint64_t n_entries;
+    PayloadEncoding encoding;
+  };
+
+  constexpr std::size_t header_size = sizeof(MessageHeader);
+
+  bool
+  fits_float(double value) noexcept
+  {
+    const auto f = static_cast<float>(value);
+    return std::isfinite(f) && (value == 0. || f != 0.F);
+  }
+
+  bool
+  is_sparse(PayloadEncoding encoding) noexcept
+  {
+    return encoding == PayloadEncoding::Sparse64
+           || encoding == PayloadEncoding::Sparse32;
+  }
+
+  std::size_t
+  value_size(PayloadEncoding encoding) noexcept
+  {
+    return (encoding == PayloadEncoding::Dense32
+            || encoding == PayloadEncoding::Sparse32)
+               ? sizeof(float)
+               : sizeof(double);
+  }
+
+  std::size_t
+  body_size(PayloadEncoding encoding, std::size_t n_entries) noexcept
+  {
+    const auto index_size = is_sparse(encoding) ? sizeof(std::uint32_t) : 0;
+    return n_entries * (index_size + value_size(encoding));
+  }
+
+  template <typename T>
+  void
+  write_values(std::byte* dst,
+               std::span<const double> src,
+               std::size_t n_entries,
+               auto&& index)
+  {
+    for (std::size_t k = 0; k < n_entries; ++k)
+    {
+      const auto value = static_cast<T>(src[index(k)]);
+      std::memcpy(dst + k * sizeof(T), &value, sizeof(T));
+    }
+  }
+
+  template <typename T>
+  double
+  read_value(const std::byte* src, std::size_t k) noexcept
+  {
+    T value;
+    std::memcpy(&value, src + k * sizeof(T), sizeof(T));
+    return static_cast<double>(value);
+  }
+
+} // namespace
+
+namespace WrapMPI
+{
+
+  ContributionCodec::ContributionCodec(CompressionPolicy _policy) noexcept
+      : policy(_policy)
+  {
+  }
+
+  PayloadEncoding
+  ContributionCodec::encode(std::span<const double> values)
+  {
+    const std::size_t n = values.size();
+    bool use_float = policy.allow_float32;
+    non_zero.clear();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      if (values[i] != 0.)
+      {
+        non_zero.push_back(static_cast<std::uint32_t>(i));
+      }
+      use_float = use_float && fits_float(values[i]);
+    }
+
+    const auto dense
+        = use_float ? PayloadEncoding::Dense32 : PayloadEncoding::Dense64;
+    const auto sparse
+        = use_float ? PayloadEncoding::Sparse32 : PayloadEncoding::Sparse64;
+    const bool indexable = n <= std::numeric_limits<std::uint32_t>::max();
+    const bool smaller
+        = body_size(sparse, non_zero.size()) < body_size(dense, n);
+    const auto encoding = (indexable && smaller) ? sparse : dense;
+    const std::size_t n_entries = is_sparse(encoding) ? non_zero.size() : n;
+
+    const MessageHeader header{ n, n_entries, encoding };
+    buffer.resize(header_size + body_size(encoding, n_entries));
+    std::memcpy(buffer.data(), &header, header_size);
+    std::byte* body = buffer.data() + header_size;
+
+    if (is_sparse(encoding))
+    {
+      std::memcpy(body, non_zero.data(), n_entries * sizeof(std::uint32_t));
+      body += n_entries * sizeof(std::uint32_t);
+    }
+
+    const auto index = [this, encoding](std::size_t k) -> std::size_t
+    { return is_sparse(encoding) ? non_zero[k] : k; };
+    if (value_size(encoding) == sizeof(float))
+    {
+      write_values<float>(body, values, n_entries, index);
+    }
+    else
+    {
+      write_values<double>(body, values, n_entries, index);
+    }
+    return encoding;
+  }
+
+  std::size_t
+  ContributionCodec::max_message_size(std::size_t n_values) noexcept
+  {
+    // Sparse is only selected when smaller than dense
+    return header_size + body_size(PayloadEncoding::Dense64, n_values);
+  }
+
+  void
+  ContributionCodec::decode_add(std::span<const std::byte> message,
+                                std::span<double> values)
+  {
+    if (message.size() < header_size)
+    {
+      throw std::invalid_argument("Contribution message is too short");
+    }
+    MessageHeader header{};
+    std::memcpy(&header, message.data(), header_size);
+    if (header.encoding > PayloadEncoding::Sparse32)
+    {
+      throw std::invalid_argument("Unknown contribution encoding");
+    }
+    if (header.n_values != values.size()
+        || message.size()
+               != header_size + body_size(header.encoding, header.n_entries))
+    {
+      throw std::invalid_argument("Contribution message size mismatch");
+    }
+
+    const std::byte* body = message.data() + header_size;
+    const bool sparse = is_sparse(header.encoding);
+    const std::byte* indices = body;
+    if (sparse)
+    {
+      body += header.n_entries * sizeof(std::uint32_t);
+    }
+    const bool use_float = value_size(header.encoding) == sizeof(float);
+
+    for (std::size_t k = 0; k < header.n_entries; ++k)
+    {
+      std::size_t i = k;
+      if (sparse)
+      {
+        std::uint32_t index = 0;
+        std::memcpy(&index, indices + k * sizeof(index), sizeof(index));
+        if (index >= values.size())
+        {
+          throw std::invalid_argument("Contribution index out of range");
+        }
+        i = index;
+      }
+      values[i] += use_float ? read_value<float>(body, k)
+                             : read_value<double>(body, k);
+    }
+  }
+
+  DeltaCodec::DeltaCodec(std::size_t size) : reference(size, 0.), m_deltas(size)
+  {
+  }
+
+  std::span<const float>
+  DeltaCodec::encode(std::span<const double> values)
+  {
+    if (values.size() != reference.size())
+    {
+      throw std::invalid_argument("Delta size mismatch");
+    }
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+      m_deltas[i] = static_cast<float>(values[i] - reference[i]);
+      reference[i] += static_cast<double>(m_deltas[i]);
+    }
+    return m_deltas;
+  }
+
+  void
+  DeltaCodec::decode(std::span<double> values)
+  {
+    if (values.size() != reference.size())
+    {
+      throw std::invalid_argument("Delta size mismatch");
+    }
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+      reference[i] += static_cast<double>(m_deltas[i]);
+    }
+    std::ranges::copy(reference, values.begin());
+  }
+
+} // namespace WrapMPI
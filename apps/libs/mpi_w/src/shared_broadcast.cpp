@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <common/common.hpp>
+#include <cstddef>
+#include <mpi.h>
+#include <mpi_w/shared_broadcast.hpp>
+#include <span>
+#include <stdexcept>
+
+namespace WrapMPI
+{
+
+  SharedBroadcast::SharedBroadcast(std::size_t _n_values,
+                                   std::size_t root,
+                                   bool _in_place)
+      : n_values(_n_values), in_place(_in_place)
+  {
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    is_root = static_cast<std::size_t>(rank) == root;
+
+    // Root gets the lowest key so that it leads its node and is rank 0 among
+    // leaders
+    const int key = is_root ? 0 : rank + 1;
+    MPI_Comm_split_type(
+        MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, key, MPI_INFO_NULL, &node_comm);
+    int node_rank = 0;
+    MPI_Comm_rank(node_comm, &node_rank);
+    MPI_Comm_size(node_comm, &n_node_rank);
+    MPI_Comm_split(
+        MPI_COMM_WORLD, node_rank == 0 ? 0 : MPI_UNDEFINED, key, &leader_comm);
+
+    // Leader owns the buffers, other ranks attach with an empty segment
+    const std::size_t n_buffer = in_place ? 1 : 2;
+    const std::size_t n_local = (node_rank == 0) ? n_buffer * n_values : 0;
+    double* local_base = nullptr;
+    MPI_Win_allocate_shared(static_cast<MPI_Aint>(n_local * sizeof(double)),
+                            sizeof(double),
+                            MPI_INFO_NULL,
+                            node_comm,
+                            &local_base,
+                            &window);
+    window_allocated = true;
+
+    MPI_Aint leader_size = 0;
+    int disp_unit = 0;
+    double* leader_base = nullptr;
+    MPI_Win_shared_query(window, 0, &leader_size, &disp_unit, &leader_base);
+    shared = { leader_base, leader_base + (n_buffer - 1) * n_values };
+
+    // Passive epoch for the lifetime of the window, memory ordering comes
+    // from MPI_Win_sync around node barriers
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+  }
+
+  SharedBroadcast::~SharedBroadcast()
+  {
+    release();
+  }
+
+  double*
+  SharedBroadcast::buffer() const noexcept
+  {
+    return shared[parity];
+  }
+
+  void
+  SharedBroadcast::node_barrier(MPI_Request& request) noexcept
+  {
+    MPI_Ibarrier(node_comm, &request);
+  }
+
+  int
+  SharedBroadcast::start(std::span<double> values, MPI_Request& request)
+  {
+    PROFILE_SECTION("WrapMPI::shared_broadcast")
+    if (values.size() != n_values)
+    {
+      throw std::invalid_argument("Values do not match shared window");
+    }
+    request = MPI_REQUEST_NULL;
+    if (in_place)
+    {
+      // Ranks of the node are done with the values of the previous
+      // broadcast once they all reach this barrier, others only wait for it
+      // in finish
+      wait_pending();
+      node_barrier(pending_barrier);
+      if (is_leader())
+      {
+        wait_pending();
+      }
+    }
+    else
+    {
+      parity = 1 - parity;
+    }
+    if (!is_leader())
+    {
+      return MPI_SUCCESS;
+    }
+
+    const int count = static_cast<int>(n_values);
+    if (is_root)
+    {
+      // Previous barrier ensures that the ranks of the node do not read this
+      // buffer anymore
+      wait_pending();
+      std::ranges::copy(values, buffer());
+      MPI_Win_sync(window);
+      node_barrier(pending_barrier);
+      return MPI_Ibcast(
+          values.data(), count, MPI_DOUBLE, 0, leader_comm, &request);
+    }
+    return MPI_Ibcast(buffer(), count, MPI_DOUBLE, 0, leader_comm, &request);
+  }
+
+  void
+  SharedBroadcast::finish(std::span<double> values)
+  {
+    PROFILE_SECTION("WrapMPI::shared_broadcast_finish")
+    if (is_root)
+    {
+      return;
+    }
+
+    wait_pending();
+    MPI_Request barrier = MPI_REQUEST_NULL;
+    if (is_leader())
+    {
+      MPI_Win_sync(window);
+      node_barrier(barrier);
+      MPI_Wait(&barrier, MPI_STATUS_IGNORE);
+    }
+    else
+    {
+      node_barrier(barrier);
+      MPI_Wait(&barrier, MPI_STATUS_IGNORE);
+      MPI_Win_sync(window);
+    }
+    if (!in_place)
+    {
+      std::copy(buffer(), buffer() + n_values, values.begin());
+    }
+  }
+
+  void
+  SharedBroadcast::wait_pending() noexcept
+  {
+    if (pending_barrier != MPI_REQUEST_NULL)
+    {
+      MPI_Wait(&pending_barrier, MPI_STATUS_IGNORE);
+    }
+  }
+
+  void
+  SharedBroadcast::release() noexcept
+  {
+    if (!window_allocated)
+    {
+      return;
+    }
+    wait_pending();
+    MPI_Win_unlock_all(window);
+    MPI_Win_free(&window);
+    window_allocated = false;
+    if (leader_comm != MPI_COMM_NULL)
+    {
+      MPI_Comm_free(&leader_comm);
+    }
+    MPI_Comm_free(&node_comm);
+  }
+
+} // namespace WrapMPI
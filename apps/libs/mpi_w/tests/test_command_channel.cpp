@@ -0,0 +1,44 @@
+#include <cassert>
+#include <iostream>
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <mpi_w/command_channel.hpp>
+
+int
+main(int argc, char** argv)
+{
+  int rank = 0;
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  {
+    const WrapMPI::SIGNALS sequence[]
+        = { WrapMPI::SIGNALS::HydroUpdate,
+            WrapMPI::SIGNALS::RUN,
+            WrapMPI::SIGNALS::DUMP,
+            WrapMPI::SIGNALS::STOP };
+
+    WrapMPI::CommandChannel commands;
+    if (rank == 0)
+    {
+      // Commands are posted without waiting for workers
+      for (const auto signal : sequence)
+      {
+        commands.post(signal);
+      }
+    }
+    else
+    {
+      for (const auto signal : sequence)
+      {
+        assert(commands.wait() == signal);
+      }
+    }
+    commands.release();
+  }
+
+  std::cout << "OK" << std::endl;
+  MPI_Finalize();
+  return 0;
+}
@@ -37,16 +37,34 @@ main(int argc, char** argv)
       host_payload.liquid_neighbors_flat = raw_neighbors;
       host_payload.proba_leaving_flat = flat_proba;
       auto _ = host_payload.sendAll(size);
+      host_payload.wait();
+
+      // Second update with the same flowmap only sends its slot
+      WrapMPI::HostIterationPayload cached_payload(2);
+      for (int i = 0; i < 2; ++i)
+      {
+        cached_payload.liquid_out_flows = flows;
+        cached_payload.liquid_volumes = volumes;
+        cached_payload.liquid_neighbors_flat = raw_neighbors;
+        cached_payload.proba_leaving_flat = flat_proba;
+        _ = cached_payload.sendAll(size);
+        assert(cached_payload.header[0] == 0);
+        assert(cached_payload.header[1] == static_cast<std::uint64_t>(i));
+        cached_payload.wait();
+      }
     }
-    else if (rank == 1)
+    else
     {
       WrapMPI::IterationPayload payload(3);
-      payload.recv(0, &status);
+      for (int i = 0; i < 3; ++i)
+      {
+        assert(payload.recv(0, &status));
 
-      assert(payload.liquid_out_flows == flows);
-      assert(payload.liquid_volumes == volumes);
-      assert(payload.liquid_neighbors_flat == raw_neighbors);
-      assert(payload.proba_leaving_flat == payload.proba_leaving_flat);
+        assert(payload.liquid_out_flows == flows);
+        assert(payload.liquid_volumes == volumes);
+        assert(payload.liquid_neighbors_flat == raw_neighbors);
+        assert(payload.proba_leaving_flat == flat_proba);
+      }
     }
   }
   std::cout << "OK" << std::endl;
@@ -0,0 +1,62 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <mpi_w/node_shared_memory.hpp>
+#include <span>
+
+int
+main(int argc, char** argv)
+{
+  int rank = 0;
+  int size = 0;
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  {
+    // Rank 0 is left out as the host is
+    const bool member = rank != 0 || size == 1;
+    WrapMPI::NodeSharedMemory shared(member);
+    assert(shared.is_member() == member);
+    if (member)
+    {
+      constexpr std::size_t n_values = 8;
+      const auto bytes = shared.allocate(n_values * sizeof(double));
+      assert(shared.is_allocated());
+      assert(bytes.size() == n_values * sizeof(double));
+      const std::span<double> values(reinterpret_cast<double*>(bytes.data()),
+                                     n_values);
+
+      // Writer updates values several times, readers see each update
+      for (int step = 0; step < 3; ++step)
+      {
+        shared.barrier();
+        if (shared.is_writer())
+        {
+          for (std::size_t i = 0; i < n_values; ++i)
+          {
+            values[i] = 10. * step + static_cast<double>(i);
+          }
+        }
+        shared.barrier();
+        for (std::size_t i = 0; i < n_values; ++i)
+        {
+          assert(values[i] == 10. * step + static_cast<double>(i));
+        }
+      }
+    }
+    else
+    {
+      assert(!shared.is_writer() && !shared.is_allocated());
+    }
+    shared.release();
+    assert(!shared.is_member() && shared.memory().empty());
+  }
+
+  std::cout << "OK" << std::endl;
+  MPI_Finalize();
+  return 0;
+}
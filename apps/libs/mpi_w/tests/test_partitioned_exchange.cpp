@@ -0,0 +1,147 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <mpi_w/partitioned_exchange.hpp>
+#include <vector>
+
+using Layout = WrapMPI::PartitionedExchange::Layout;
+
+namespace
+{
+  constexpr std::size_t n_species = 3;
+
+  // Rank i owns i + 1 compartments so that partitions are uneven
+  std::vector<uint64_t>
+  make_offsets(std::size_t n_rank)
+  {
+    std::vector<uint64_t> offsets(n_rank + 1, 0);
+    for (std::size_t i = 0; i < n_rank; ++i)
+    {
+      offsets[i + 1] = offsets[i] + i + 1;
+    }
+    return offsets;
+  }
+
+  // Value of species i_species in the j-th held compartment
+  std::size_t
+  index(Layout layout, std::size_t n_c, std::size_t i_species, std::size_t j)
+  {
+    return (layout == Layout::SpeciesMajor) ? i_species * n_c + j
+                                            : j * n_species + i_species;
+  }
+
+  double
+  expected(std::size_t i_species, std::size_t j)
+  {
+    return static_cast<double>(100 * i_species + j);
+  }
+
+  // Root holds every compartment, other ranks only their own ones
+  std::size_t
+  n_held(const std::vector<uint64_t>& offsets, std::size_t rank)
+  {
+    return (rank == 0) ? offsets.back() : offsets[rank + 1] - offsets[rank];
+  }
+
+  std::size_t
+  first_held(const std::vector<uint64_t>& offsets, std::size_t rank)
+  {
+    return (rank == 0) ? 0 : offsets[rank];
+  }
+
+  // Each rank fills its compartments, root receives all of them
+  void
+  check_gather(WrapMPI::PartitionedExchange& exchange,
+               const std::vector<uint64_t>& offsets,
+               Layout layout,
+               std::size_t rank)
+  {
+    const std::size_t n_c = n_held(offsets, rank);
+    const std::size_t first = first_held(offsets, rank);
+    std::vector<double> values(n_species * n_c, -1.);
+    for (std::size_t s = 0; s < n_species; ++s)
+    {
+      for (std::size_t j = offsets[rank]; j < offsets[rank + 1]; ++j)
+      {
+        values[index(layout, n_c, s, j - first)] = expected(s, j);
+      }
+    }
+    MPI_Request request = MPI_REQUEST_NULL;
+    exchange.gather(values, layout, 0, rank, request);
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    if (rank != 0)
+    {
+      return;
+    }
+    for (std::size_t s = 0; s < n_species; ++s)
+    {
+      for (std::size_t j = 0; j < n_c; ++j)
+      {
+        assert(values[index(layout, n_c, s, j)] == expected(s, j)
+               && "Root should receive the values of every compartment");
+      }
+    }
+  }
+
+  // Root fills every compartment, ranks only receive their own
+  void
+  check_scatter(WrapMPI::PartitionedExchange& exchange,
+                const std::vector<uint64_t>& offsets,
+                Layout layout,
+                std::size_t rank)
+  {
+    const std::size_t n_c = n_held(offsets, rank);
+    const std::size_t first = first_held(offsets, rank);
+    std::vector<double> values(n_species * n_c, -1.);
+    if (rank == 0)
+    {
+      for (std::size_t s = 0; s < n_species; ++s)
+      {
+        for (std::size_t j = 0; j < n_c; ++j)
+        {
+          values[index(layout, n_c, s, j)] = expected(s, j);
+        }
+      }
+    }
+    MPI_Request request = MPI_REQUEST_NULL;
+    exchange.scatter(values, layout, 0, rank, request);
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    for (std::size_t s = 0; s < n_species; ++s)
+    {
+      for (std::size_t j = 0; j < n_c; ++j)
+      {
+        assert(values[index(layout, n_c, s, j)] == expected(s, first + j)
+               && "Ranks should receive the values of their compartments");
+      }
+    }
+  }
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  int rank = 0;
+  int size = 0;
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  {
+    const auto offsets = make_offsets(static_cast<std::size_t>(size));
+    WrapMPI::PartitionedExchange exchange(offsets);
+    const auto r = static_cast<std::size_t>(rank);
+    for (const auto layout : { Layout::SpeciesMajor, Layout::CompartmentMajor })
+    {
+      check_gather(exchange, offsets, layout, r);
+      check_scatter(exchange, offsets, layout, r);
+    }
+  }
+
+  std::cout << "OK" << std::endl;
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <mpi_w/payload_codec.hpp>
+#include <stdexcept>
+#include <vector>
+
+using WrapMPI::CompressionPolicy;
+using WrapMPI::ContributionCodec;
+using WrapMPI::PayloadEncoding;
+
+void
+test_sparse_exact()
+{
+  std::vector<double> values(1000, 0.);
+  values[3] = 1.0 / 3.0;
+  values[999] = -2e-300;
+
+  ContributionCodec codec;
+  assert(codec.encode(values) == PayloadEncoding::Sparse64);
+  assert(codec.message().size()
+         < ContributionCodec::max_message_size(values.size()));
+
+  std::vector<double> sum(values.size(), 1.);
+  ContributionCodec::decode_add(codec.message(), sum);
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    assert(sum[i] == 1. + values[i]);
+  }
+}
+
+void
+test_dense_float()
+{
+  std::vector<double> values(64);
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    values[i] = 1. + static_cast<double>(i);
+  }
+
+  ContributionCodec exact;
+  assert(exact.encode(values) == PayloadEncoding::Dense64);
+
+  ContributionCodec lossy(CompressionPolicy{ .allow_float32 = true });
+  assert(lossy.encode(values) == PayloadEncoding::Dense32);
+  std::vector<double> sum(values.size(), 0.);
+  ContributionCodec::decode_add(lossy.message(), sum);
+  assert(sum == values);
+
+  // Not representable as float: exact fallback
+  values[7] = 1e300;
+  assert(lossy.encode(values) == PayloadEncoding::Dense64);
+  values[7] = 1e-300;
+  assert(lossy.encode(values) == PayloadEncoding::Dense64);
+}
+
+void
+test_malformed()
+{
+  ContributionCodec codec;
+  std::vector<double> values(8, 1.);
+  codec.encode(values);
+
+  bool thrown = false;
+  std::vector<double> wrong_size(4, 0.);
+  try
+  {
+    ContributionCodec::decode_add(codec.message(), wrong_size);
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+void
+test_delta()
+{
+  const std::size_t n = 16;
+  WrapMPI::DeltaCodec sender(n);
+  WrapMPI::DeltaCodec receiver(n);
+  std::vector<double> values(n);
+  std::vector<double> received(n);
+  for (int step = 0; step < 50; ++step)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      values[i] = 1e3 + std::sin(0.1 * step + static_cast<double>(i)) / 7.;
+    }
+    const auto deltas = sender.encode(values);
+    std::copy(deltas.begin(), deltas.end(), receiver.deltas().begin());
+    receiver.decode(received);
+    // First delta is the whole value, then error is relative to the change
+    // between steps and does not accumulate
+    const double tolerance = (step == 0) ? 1e-4 : 1e-8;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      assert(std::abs(received[i] - values[i]) < tolerance);
+    }
+  }
+}
+
+int
+main()
+{
+  test_sparse_exact();
+  test_dense_float();
+  test_malformed();
+  test_delta();
+  std::cout << "OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,90 @@
+#include <cassert>
+#include <iostream>
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <mpi_w/shared_broadcast.hpp>
+#include <span>
+#include <vector>
+
+namespace
+{
+  void
+  check_copy(int rank)
+  {
+    WrapMPI::SharedBroadcast broadcast(4, 0);
+    assert(broadcast.node_size() >= 1);
+    assert(!broadcast.is_in_place());
+    if (rank == 0)
+    {
+      assert(broadcast.is_leader());
+    }
+
+    // More steps than buffers to use both of them twice
+    for (int step = 0; step < 4; ++step)
+    {
+      const double offset = 10. * step;
+      std::vector<double> values(4, -1.);
+      if (rank == 0)
+      {
+        values = { offset, offset + 1, offset + 2, offset + 3 };
+      }
+      MPI_Request request = MPI_REQUEST_NULL;
+      broadcast.start(values, request);
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+      broadcast.finish(values);
+      for (int i = 0; i < 4; ++i)
+      {
+        assert(values[i] == offset + i);
+      }
+    }
+    broadcast.release();
+  }
+
+  // Ranks other than root read the node window between finish and the next
+  // start
+  void
+  check_in_place(int rank)
+  {
+    WrapMPI::SharedBroadcast broadcast(4, 0, true);
+    assert(broadcast.is_in_place());
+    std::vector<double> owned(4, -1.);
+    const std::span<double> values
+        = (rank == 0) ? std::span<double>(owned) : broadcast.node_values();
+
+    for (int step = 0; step < 4; ++step)
+    {
+      const double offset = 10. * step;
+      if (rank == 0)
+      {
+        owned = { offset, offset + 1, offset + 2, offset + 3 };
+      }
+      MPI_Request request = MPI_REQUEST_NULL;
+      broadcast.start(values, request);
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+      broadcast.finish(values);
+      for (int i = 0; i < 4; ++i)
+      {
+        assert(values[i] == offset + i);
+      }
+    }
+    broadcast.release();
+  }
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  int rank = 0;
+  int size = 0;
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  check_copy(rank);
+  check_in_place(rank);
+
+  std::cout << "OK" << std::endl;
+  MPI_Finalize();
+  return 0;
+}
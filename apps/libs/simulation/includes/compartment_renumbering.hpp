@@ -0,0 +1,195 @@
+#ifndef __SIMULATION_COMPARTMENT_RENUMBERING_HPP__
+#define __SIMULATION_COMPARTMENT_RENUMBERING_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Simulation
+{
+  /**
+   * @brief Bijection between flowmap compartment numbering and internal
+   * numbering used by domain, scalar matrices and particle positions.
+   *
+   * Internal compartment j is flowmap compartment to_old(j). Per compartment
+   * data is stored as blocks of `block` contiguous values (1 for volumes,
+   * n_species for LayoutLeft concentrations, max_neighbors for flat
+   * neighbors rows).
+   */
+  class CompartmentPermutation
+  {
+  public:
+    /**
+     * @param new_to_old Flowmap index of each internal compartment
+     * @throw std::invalid_argument if new_to_old is not a permutation
+     */
+    explicit CompartmentPermutation(std::vector<std::size_t> new_to_old);
+
+    static CompartmentPermutation identity(std::size_t n_compartment);
+
+    /**
+     * @brief Reverse Cuthill-McKee ordering of the undirected compartment
+     * graph given by flowmap neighbors (n_compartment rows of equal size,
+     * entries out of range or equal to the row are ignored).
+     *
+     * Each connected component starts from a pseudo-peripheral compartment
+     * and neighbors are visited by increasing degree, the order is then
+     * reversed. Compartments connected by a flow get close indices.
+     */
+    static CompartmentPermutation
+    reverse_cuthill_mckee(std::size_t n_compartment,
+                          std::span<const std::size_t> neighbors_flat);
+
+    /**
+     * @brief Max index distance between connected compartments in internal
+     * numbering
+     */
+    [[nodiscard]] std::size_t
+    bandwidth(std::span<const std::size_t> neighbors_flat) const;
+
+    [[nodiscard]] std::size_t
+    size() const noexcept
+    {
+      return m_new_to_old.size();
+    }
+
+    [[nodiscard]] std::size_t
+    to_new(std::size_t old_index) const noexcept
+    {
+      assert(old_index < size());
+      return m_old_to_new[old_index];
+    }
+
+    [[nodiscard]] std::size_t
+    to_old(std::size_t new_index) const noexcept
+    {
+      assert(new_index < size());
+      return m_new_to_old[new_index];
+    }
+
+    [[nodiscard]] const std::vector<std::size_t>&
+    new_to_old() const noexcept
+    {
+      return m_new_to_old;
+    }
+
+    [[nodiscard]] bool is_identity() const noexcept;
+
+    /**
+     * @brief Flowmap numbered blocks to internal numbering
+     */
+    template <typename T>
+    void
+    gather(std::span<const T> src, std::span<T> dst, std::size_t block) const
+    {
+      assert(src.size() == dst.size() && src.size() == size() * block);
+      for (std::size_t j = 0; j < size(); ++j)
+      {
+        const auto* first = src.data() + m_new_to_old[j] * block;
+        std::copy(first, first + block, dst.data() + j * block);
+      }
+    }
+
+    /**
+     * @brief Internal numbered blocks back to flowmap numbering
+     */
+    template <typename T>
+    void
+    scatter(std::span<const T> src, std::span<T> dst, std::size_t block) const
+    {
+      assert(src.size() == dst.size() && src.size() == size() * block);
+      for (std::size_t j = 0; j < size(); ++j)
+      {
+        const auto* first = src.data() + j * block;
+        std::copy(first, first + block, dst.data() + m_new_to_old[j] * block);
+      }
+    }
+
+    /**
+     * @brief Replace flowmap compartment indices by internal indices, values
+     * out of range (padding) are kept
+     */
+    void relabel(std::span<std::size_t> indices) const noexcept;
+
+  private:
+    std::vector<std::size_t> m_new_to_old;
+    std::vector<std::size_t> m_old_to_new;
+  };
+
+  /**
+   * @brief Permutation in use by a SimulationUnit together with buffers
+   * holding flowmap data in internal numbering (hydro update) and exported
+   * data in flowmap numbering. Buffers are reused between calls.
+   */
+  struct HydroRenumbering
+  {
+    explicit HydroRenumbering(CompartmentPermutation&& _permutation)
+        : permutation(std::move(_permutation))
+    {
+    }
+
+    template <typename T>
+    std::span<const T>
+    to_internal(std::span<const T> src,
+                std::vector<T>& buffer,
+                std::size_t block = 1) const
+    {
+      buffer.resize(src.size());
+      permutation.gather(src, std::span<T>(buffer), block);
+      return buffer;
+    }
+
+    template <typename T>
+    std::span<const T>
+    to_flowmap(std::span<const T> src,
+               std::vector<T>& buffer,
+               std::size_t block = 1) const
+    {
+      buffer.resize(src.size());
+      permutation.scatter(src, std::span<T>(buffer), block);
+      return buffer;
+    }
+
+    // Rows are moved and compartment indices relabeled
+    std::span<const std::size_t>
+    neighbors_to_internal(std::span<const std::size_t> src)
+    {
+      const std::size_t n_neighbors = src.size() / permutation.size();
+      buffer_neighbors.resize(src.size());
+      permutation.gather(
+          src, std::span<std::size_t>(buffer_neighbors), n_neighbors);
+      permutation.relabel(buffer_neighbors);
+      return buffer_neighbors;
+    }
+
+    std::span<const std::size_t>
+    indices_to_internal(std::span<const std::size_t> src,
+                        std::vector<std::size_t>& buffer) const
+    {
+      buffer.assign(src.begin(), src.end());
+      permutation.relabel(buffer);
+      return buffer;
+    }
+
+    CompartmentPermutation permutation;
+
+    std::vector<double> buffer_volumes;
+    std::vector<double> buffer_inverse_volumes;
+    std::vector<double> buffer_out_flows;
+    std::vector<double> buffer_probabilities;
+    std::vector<std::size_t> buffer_neighbors;
+    std::vector<std::size_t> buffer_rows;
+    std::vector<std::size_t> buffer_cols;
+
+    // Export accessors are const
+    mutable std::vector<double> export_liquid;
+    mutable std::vector<double> export_gas;
+    mutable std::vector<double> export_mtr;
+  };
+
+} // namespace Simulation
+
+#endif
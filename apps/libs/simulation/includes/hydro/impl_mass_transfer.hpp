@@ -10,6 +10,8 @@ EIGEN_DIAG_PUSH
 EIGEN_DIAG_POP
 
 #include <cma_utils/alias.hpp>
+#include <cstdint>
+#include <vector>
 
 #include <mc/domain.hpp>
 #include <simulation/mass_transfer.hpp>
@@ -27,6 +29,8 @@ namespace Simulation::MassTransfer
     Eigen::ArrayXXd kla;
     Eigen::ArrayXd Henry;
     double db;
+    //!< 1 if species has non zero kla somewhere, updated with kla
+    std::vector<std::uint8_t> transfer_mask;
   };
 
   namespace Impl
@@ -0,0 +1,98 @@
+#ifndef __SIMULATION_IMPLICIT_SCALAR_SOLVER_HPP__
+#define __SIMULATION_IMPLICIT_SCALAR_SOLVER_HPP__
+
+#include <common/eigen_diag.hpp>
+EIGEN_DIAG_PUSH
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <Eigen/SparseLU>
+EIGEN_DIAG_POP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace Simulation
+{
+  /**
+   * @brief Backward Euler solver for the linear part of the scalar mass
+   * balance.
+   *
+   * With one row per species, the liquid mass balance reads
+   *   M^{n+1} = M^n + d_t * (C^{n+1} T - C^{n+1} S + R)
+   * where C=M V^{-1}, T is the flowmap transition matrix, S the sink and R the
+   * explicit terms (sources, mass transfer). This gives, for all species:
+   *   (V + d_t (S - T))^T (C^{n+1})^T = (M^n + d_t R)^T
+   *
+   * The matrix only changes with flowmap, sink or d_t so its sparse LU
+   * factorization is computed once and cached per flowmap: a step then costs
+   * only triangular solves. Flowmap is identified by a fingerprint of the
+   * transition matrix and volumes given to `set_flowmap`.
+   *
+   * Unlike the explicit scheme, stability does not depend on residence time,
+   * d_t is only limited by accuracy.
+   */
+  class ImplicitScalarSolver
+  {
+  public:
+    using sparse_type = Eigen::SparseMatrix<double>;
+    using vector_type = Eigen::VectorXd;
+    using dense_type = Eigen::MatrixXd;
+
+    static constexpr std::size_t default_max_cached = 64;
+
+    explicit ImplicitScalarSolver(
+        std::size_t max_cached = default_max_cached) noexcept;
+
+    /**
+     * @brief Register current flowmap, must be called on each hydro update.
+     * The same transition matrix has to be given to `solve` until next call.
+     */
+    void set_flowmap(const sparse_type& transition,
+                     const vector_type& volumes);
+
+    /**
+     * @brief Compute concentration at next step
+     * @param transition Transition matrix given to `set_flowmap`
+     * @param rhs M^n + d_t * R (n_species x n_compartments)
+     * @param concentration Result C^{n+1} (n_species x n_compartments)
+     * @return false if matrix cannot be factorized, concentration is then
+     * unchanged and caller has to fallback to explicit scheme
+     */
+    [[nodiscard]] bool solve(double d_t,
+                             const sparse_type& transition,
+                             const vector_type& sink,
+                             const Eigen::Ref<const dense_type>& rhs,
+                             Eigen::Ref<dense_type> concentration);
+
+    /**
+     * @brief Number of factorizations done since construction
+     */
+    [[nodiscard]] std::size_t n_factorization() const noexcept;
+
+    /**
+     * @brief Number of factorizations currently stored
+     */
+    [[nodiscard]] std::size_t n_cached() const noexcept;
+
+    void clear() noexcept;
+
+  private:
+    using lu_type = Eigen::SparseLU<sparse_type, Eigen::COLAMDOrdering<int>>;
+
+    std::unique_ptr<lu_type> factorize(double d_t,
+                                       const sparse_type& transition,
+                                       const vector_type& sink) const;
+
+    std::size_t max_cached;
+    std::size_t factorization_counter{};
+    double cached_d_t{};
+    uint64_t flowmap_key{};
+    vector_type volumes;
+    std::unordered_map<uint64_t, std::unique_ptr<lu_type>> cache;
+  };
+
+} // namespace Simulation
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef __SIMULATION_SCALAR_INTEGRATION_POLICY_HPP__
+#define __SIMULATION_SCALAR_INTEGRATION_POLICY_HPP__
+
+#include <cstdint>
+
+namespace Simulation
+{
+  /**
+   * @brief Time integration of one species in the fused two-phase step
+   */
+  enum class SpeciesIntegration : std::uint8_t
+  {
+    NoTransfer = 0,    ///< No gas-liquid transfer, one explicit step
+    Explicit = 1,      ///< Explicit transfer, one explicit step
+    PointImplicit = 2, ///< Transfer solved implicitly per compartment
+    SubStep = 3,       ///< Several explicit steps of d_t/n_substep
+  };
+
+  struct SpeciesPolicy
+  {
+    SpeciesIntegration integration;
+    int n_substep;
+  };
+
+  /**
+   * @brief Select integration of a transferred species.
+   *
+   * Exchange is stiff when exchange_rate * d_t exceeds the explicit stability
+   * margin. Stiff species are sub-stepped when few sub-steps are needed and
+   * exchange is not much faster than transport. Otherwise liquid and gas are
+   * close to equilibrium within a residence time and the transfer term is
+   * treated point-implicitly (unconditionally stable, exact mass balance).
+   *
+   * @param exchange_rate max over compartments of kla * (1 + H * Vl / Vg)
+   * @param residence_time min over compartments of V / outflow
+   */
+  SpeciesPolicy select_species_integration(double exchange_rate,
+                                           double residence_time,
+                                           double d_t) noexcept;
+
+} // namespace Simulation
+
+#endif
@@ -15,9 +15,14 @@ EIGEN_DIAG_POP
 #include <common/common.hpp>
 #include <cstddef>
 #include <cstdint>
+#include <device_scalar_solver.hpp>
+#include <implicit_scalar_solver.hpp>
 #include <mc/traits.hpp>
+#include <memory>
+#include <scalar_integration_policy.hpp>
 #include <simulation/mass_transfer.hpp>
 #include <span>
+#include <transition_cache.hpp>
 #include <vector>
 
 namespace Simulation
@@ -25,6 +30,8 @@ namespace Simulation
   template <FloatingPointType ftype>
   using FlowMatrixType = Eigen::SparseMatrix<ftype>;
   using mass_balance_float_type = double;
+  class CompartmentPermutation;
+
   class ScalarSimulation
   {
     using concentration_t
@@ -53,6 +60,20 @@ namespace Simulation
 
     void set_transition(CmaUtils::StateCooMatrixType&& transition);
 
+    /**
+     * @brief Set transition from COO data already in internal numbering
+     */
+    void set_transition(std::span<const std::size_t> rows,
+                        std::span<const std::size_t> cols,
+                        std::span<const double> values);
+
+    /**
+     * @brief Move concentrations, volumes and masses from flowmap numbering
+     * to internal numbering. Sources, sink and transition are given in
+     * internal numbering at next feed and hydro updates.
+     */
+    void renumber(const CompartmentPermutation& permutation);
+
     void performStepGL(
         double d_t,
         const KokkosEigen::Alias::ColMajorMatrixtype<mass_balance_float_type>&
@@ -61,6 +82,23 @@ namespace Simulation
 
     void performStep(double d_t);
 
+    /**
+     * @brief Explicit step of both phases in one traversal: transport,
+     * gas-liquid mass transfer, sources, sink and liquid negative clipping.
+     *
+     * Work is parallel over compartments, species whose row cannot change
+     * (see `is_species_active`) are skipped. Without stiff species,
+     * equivalent to gas_liquid_mass_transfer + performStepGL on both phases
+     * + clearNegs. Species with stiff transfer are sub-stepped or get a
+     * point-implicit transfer (see `select_species_integration`).
+     * @return false if one phase uses implicit or device scheme, nothing is
+     * done and caller has to use the unfused path
+     */
+    static bool performStepGLFused(double d_t,
+                                   ScalarSimulation& liquid,
+                                   ScalarSimulation& gas,
+                                   MassTransfer::MassTransferProxy& proxy);
+
     void synchro_sources();
 
     // Getters
@@ -79,6 +117,28 @@ namespace Simulation
 
     [[nodiscard]] auto getConcentrationArray() const;
 
+    /**
+     * @brief Read and write concentrations in the n_row() x n_col() values
+     * of data (host memory owned by the caller) until own_concentration.
+     * Only when concentrations are in host memory (see
+     * KokkosEigen2D::host_aliases_device), device views taken before keep
+     * the previous storage.
+     */
+    void alias_concentration(std::span<concentration_float_type> data);
+
+    /**
+     * @brief Copy aliased concentrations back in an allocation of the object
+     */
+    void own_concentration();
+
+    /**
+     * @brief Keep concentrations, sources and contributions of compartments
+     * [first, end) only, column j holds compartment first + j. Volumes keep
+     * every compartment. For ranks that read concentrations and send
+     * contributions but do not integrate scalars.
+     */
+    void restrict_compartments(std::size_t first, std::size_t end);
+
     //
 
     [[nodiscard]] const KokkosEigen::Alias::DiagonalType<
@@ -107,7 +167,44 @@ namespace Simulation
 
     void clearNegs();
 
+    /**
+     * @brief False if species row is known to be zero and only transported:
+     * zero initial concentration, no feed and no particle contribution
+     */
+    [[nodiscard]] bool is_species_active(std::size_t i_r) const noexcept;
+
+    /**
+     * @brief Use backward Euler for transport and sink instead of explicit
+     * Euler (default given by BIOMC_SCALAR_IMPLICIT env variable)
+     */
+    void set_implicit(bool enable);
+    [[nodiscard]] bool is_implicit() const noexcept;
+
+    /**
+     * @brief Run explicit step on ComputeSpace, concentration is then copied
+     * back to host only when read (default given by BIOMC_SCALAR_DEVICE env
+     * variable). Implicit and device modes are exclusive.
+     */
+    void set_device(bool enable);
+    [[nodiscard]] bool is_device() const noexcept;
+
   private:
+    bool implicit_step(double d_t,
+                       const Eigen::Ref<const Eigen::MatrixXd>& rhs);
+
+    [[nodiscard]] double min_residence_time() const;
+
+    [[nodiscard]] std::vector<SpeciesPolicy>
+    species_integration(const ScalarSimulation& gas,
+                        const MassTransfer::MassTransferProxy& proxy,
+                        double d_t) const;
+
+    void device_step(
+        double d_t,
+        const KokkosEigen::Alias::ColMajorMatrixtype<mass_balance_float_type>*
+            mtr,
+        double sign);
+
     std::size_t n_r;
     std::size_t n_c;
 
@@ -126,12 +223,18 @@ namespace Simulation
         sources;
 
     MC::kernelContribution contribs;
-    FlowMatrixType<mass_balance_float_type> m_transition;
+    TransitionCache transitions;
 
     KokkosEigen::Alias::DiagonalType<mass_balance_float_type> m_volumes;
     KokkosEigen::Alias::DiagonalType<mass_balance_float_type> volumes_inverse;
     KokkosEigen::Alias::DiagonalType<mass_balance_float_type> sink;
 
+    std::unique_ptr<ImplicitScalarSolver> implicit_solver;
+    std::unique_ptr<DeviceScalarSolver> device_solver;
+
+    std::vector<std::uint8_t> species_mask;
+    bool concentration_aliased = false;
+
     // RowMajorEigenKokkos<double> sources;
     //
 
@@ -149,6 +252,7 @@ namespace Simulation
   ScalarSimulation::getConcentrationArray() const
   {
     // return alloc_concentrations.array();
+    concentrations.sync_host();
     return concentrations.as_array();
   }
 
@@ -163,9 +267,18 @@ namespace Simulation
   ScalarSimulation::set_zero_contribs()
   {
 
-    sources.eigen().setZero();
     this->sink.setZero();
-    sources.host_to_device_sync();
+    if (device_solver)
+    {
+      Kokkos::deep_copy(sources.device_view(), 0);
+      sources.modify_device();
+      device_solver->clear_feed();
+    }
+    else
+    {
+      sources.eigen().setZero();
+      sources.host_to_device_sync();
+    }
     Kokkos::deep_copy(contribs, 0);
   }
 
@@ -179,6 +292,12 @@ namespace Simulation
   inline void
   ScalarSimulation::set_feed(uint64_t i_r, uint64_t i_c, double val)
   {
+    species_mask[i_r] = 1;
+    if (device_solver)
+    {
+      device_solver->add_feed(i_r, i_c, val);
+      return;
+    }
     this->sources.eigen().coeffRef(EIGEN_INDEX(i_r), EIGEN_INDEX(i_c)) += val;
   }
 
@@ -197,24 +316,30 @@ namespace Simulation
   inline std::span<double>
   ScalarSimulation::getConcentrationData()
   {
+    this->concentrations.sync_host();
     return this->concentrations.get_span();
   }
 
   inline std::span<const double>
   ScalarSimulation::getConcentrationData() const
   {
+    this->concentrations.sync_host();
     return this->concentrations.get_span();
   }
 
   inline std::span<const double>
   ScalarSimulation::contribution_span() const
   {
+    this->sources.sync_host();
     return this->sources.get_span();
   }
 
   inline std::span<double>
   ScalarSimulation::contribution_span_mut()
   {
+    // Caller writes on host (MPI reduction), device is refreshed before step
+    this->sources.sync_host();
+    this->sources.modify_host();
     return this->sources.get_span();
   }
 
@@ -237,6 +362,17 @@ namespace Simulation
 
     this->volumes_inverse.diagonal() = Eigen::Map<const Eigen::VectorXd>(
         inv_volumes.data(), static_cast<int>(inv_volumes.size()));
+
+    if (device_solver)
+    {
+      device_solver->set_inverse_volumes(volumes_inverse.diagonal());
+    }
+  }
+
+  inline bool
+  ScalarSimulation::is_species_active(std::size_t i_r) const noexcept
+  {
+    return species_mask[i_r] != 0;
   }
 
   inline ScalarSimulation*
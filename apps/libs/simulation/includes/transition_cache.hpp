@@ -0,0 +1,92 @@
+#ifndef __SIMULATION_TRANSITION_CACHE_HPP__
+#define __SIMULATION_TRANSITION_CACHE_HPP__
+
+#include <common/eigen_diag.hpp>
+EIGEN_DIAG_PUSH
+#include <Eigen/Sparse>
+EIGEN_DIAG_POP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Simulation
+{
+  /**
+   * @brief Compressed transition matrices built from flowmap COO data.
+   *
+   * The sparsity pattern of a flowmap never changes, so the compressed matrix
+   * is built once per pattern (setFromTriplets: sort, duplicate merge and
+   * allocation) together with a COO->nnz permutation. Next updates with the
+   * same pattern only write values in place through the permutation, without
+   * allocation nor sort.
+   *
+   * Patterns are identified by a fingerprint of row/col indices and checked
+   * entry by entry, so a fingerprint collision only costs a rebuild.
+   */
+  class TransitionCache
+  {
+  public:
+    using sparse_type = Eigen::SparseMatrix<double>;
+
+    explicit TransitionCache(std::size_t n_compartment);
+
+    // Current matrix may point to an internal member
+    TransitionCache(const TransitionCache&) = delete;
+    TransitionCache(TransitionCache&&) = delete;
+    TransitionCache& operator=(const TransitionCache&) = delete;
+    TransitionCache& operator=(TransitionCache&&) = delete;
+    ~TransitionCache() = default;
+
+    /**
+     * @brief Set current matrix from COO data
+     * @return Current matrix, reference stays valid until cache destruction
+     */
+    const sparse_type& update(std::span<const std::size_t> rows,
+                              std::span<const std::size_t> cols,
+                              std::span<const double> vals);
+
+    /**
+     * @brief Matrix set by last update (zero matrix before first update)
+     */
+    [[nodiscard]] const sparse_type& current() const noexcept
+    {
+      return *m_current;
+    }
+
+    /**
+     * @brief Number of full builds (new pattern) since construction
+     */
+    [[nodiscard]] std::size_t n_build() const noexcept
+    {
+      return build_counter;
+    }
+
+    [[nodiscard]] std::size_t n_pattern() const noexcept
+    {
+      return entries.size();
+    }
+
+  private:
+    struct Entry
+    {
+      std::vector<std::size_t> rows;
+      std::vector<std::size_t> cols;
+      std::vector<std::size_t> permutation; ///< COO index -> nnz index
+      sparse_type matrix;
+    };
+
+    void build(Entry& entry, std::span<const double> vals) const;
+
+    std::size_t n_c;
+    std::size_t build_counter{};
+    sparse_type empty;
+    const sparse_type* m_current;
+    std::unordered_map<uint64_t, Entry> entries;
+  };
+
+} // namespace Simulation
+
+#endif
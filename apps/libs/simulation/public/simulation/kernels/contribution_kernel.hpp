@@ -40,7 +40,19 @@ template <ModelType M> struct ContributionFunctor
     np = m_particles.n_particles();
   }
 
+  /**
+   * @brief Set contributions of compartments [first, first + extent(1))
+   */
+  void
+  set_compartments(MC::ContributionView contribution_scatter,
+                   const std::size_t first)
+  {
+    m_contribution_scatter = std::move(contribution_scatter);
+    m_first_compartment = first;
+  }
+
   std::size_t m_particle_per_team;
+  std::size_t m_first_compartment{};
 
   MC::ContributionView m_contribution_scatter;
   MC::ParticlesContainer<M> m_particles;
@@ -177,7 +189,7 @@ template <ModelType M> struct ContributionFunctor
               return;
             }
             const double weight = m_particles.get_weight(p);
-            const auto pos = positions(p);
+            const auto pos = positions(p) - m_first_compartment;
             Kokkos::parallel_for(Kokkos::ThreadVectorRange(team, 0, M::n_c),
                                  [&](const int j)
                                  { access(j, pos) += weight * c(p, j); });
@@ -11,6 +11,7 @@
 #include <simulation/kernels/move_kernel.hpp>
 
 #include <common/execinfo.hpp>
+#include <common/instrumentation.hpp>
 #include <stdexcept>
 
 namespace Simulation::KernelInline
@@ -46,12 +47,18 @@ namespace Simulation::KernelInline
 
     bool f_multi_compartment;
 
+    /**
+     * @brief Refresh views used by kernels, concentrations and contributions
+     * hold the same compartments as domain tables
+     */
     void
     update(const double d_t,
            MC::ParticlesContainer<Model> container,
-           MC::DomainState<ComputeSpace>&& new_move)
+           MC::DomainState<ComputeSpace>&& new_move,
+           MC::KernelConcentrationType concentrations,
+           MC::ContributionView contribs_scatter)
     {
-      f_multi_compartment = new_move.liquid_volume.size() > 1;
+      f_multi_compartment = new_move.n_compartments > 1;
       const bool enable_move = f_multi_compartment;
       const bool enable_leave = new_move.leaving_flow.size() != 0;
 
@@ -62,8 +69,11 @@ namespace Simulation::KernelInline
       // 2. Manually update counter in update function (dirty way)
 
       cycle_kernel.update(d_t, container);
+      cycle_kernel.set_compartments(std::move(concentrations), new_move.first);
 
       contribution_kernel.update(container);
+      contribution_kernel.set_compartments(std::move(contribs_scatter),
+                                           new_move.first);
 
       // TODO: Why need to update all views (where did we lost the refcount ? )
       move_kernel.update(d_t,
@@ -72,6 +82,7 @@ namespace Simulation::KernelInline
                          container.position,
                          container.status,
                          container.ages,
+                         container.free_slots,
                          enable_move,
                          enable_leave);
     }
@@ -94,6 +105,7 @@ namespace Simulation::KernelInline
                   MC::KernelConcentrationType _concentrations,
                   MC::ContributionView _contribs_scatter,
                   MC::EventContainer _event,
+                  MC::DiagnosticChannel _diagnostics,
                   MC::DomainState<ComputeSpace> m,
                   ProbeAutogeneratedBuffer _probes,
                   ProbeAutogeneratedBuffer _probes_div)
@@ -103,6 +115,7 @@ namespace Simulation::KernelInline
                        _random_pool,
                        std::move(_concentrations),
                        _event,
+                       std::move(_diagnostics),
                        _probes_div),
           move_kernel(options.m_p_p_team_move,
                       options.m_p_p_team_leave,
@@ -120,6 +133,23 @@ namespace Simulation::KernelInline
     {
     }
 
+    /**
+     * @brief Run move and leave kernels, instantiation is selected from
+     * runtime instrumentation mask
+     */
+    void
+    launch_move(const std::size_t n_particle) const
+    {
+      Common::dispatch_instrumentation(
+          m_options.instrumentation,
+          [&](auto use_probe, auto use_event)
+          {
+            launch_move<decltype(use_probe)::value,
+                        decltype(use_event)::value>(n_particle);
+          });
+    }
+
+    template <bool UseProbe, bool UseEvent>
     void
     launch_move(const std::size_t n_particle) const
     {
@@ -135,11 +165,11 @@ namespace Simulation::KernelInline
 
         const std::size_t league_size = Common::c_league_size(n_particle, npt);
 
-        auto cycle_policy
-            = Kokkos::TeamPolicy<TagMove>(model_space,
-                                          static_cast<int>(league_size),
-                                          Kokkos::AUTO(),
-                                          Kokkos::AUTO());
+        auto cycle_policy = Kokkos::TeamPolicy<TagMove<UseEvent>>(
+            model_space,
+            static_cast<int>(league_size),
+            Kokkos::AUTO(),
+            Kokkos::AUTO());
 
         cycle_policy.set_scratch_size(0,
                                       Kokkos::PerTeam(sizeof(float) * npt * 2));
@@ -150,13 +180,31 @@ namespace Simulation::KernelInline
       if (move_kernel.enable_leave)
       {
 
-        const auto _policy_leave = Kokkos::RangePolicy<KernelInline::TagLeave>(
-            move_space, 0, n_particle);
+        const auto _policy_leave
+            = Kokkos::RangePolicy<KernelInline::TagLeave<UseProbe, UseEvent>>(
+                move_space, 0, n_particle);
         Kokkos ::parallel_reduce(
             "cycle_move_leave", _policy_leave, move_kernel, move_reducer);
       }
     }
 
+    /**
+     * @brief Run model kernels, instantiation is selected from runtime
+     * instrumentation mask
+     */
+    void
+    launch_model(const std::size_t n_particle) const
+    {
+      Common::dispatch_instrumentation(
+          m_options.instrumentation,
+          [&](auto use_probe, auto use_event)
+          {
+            launch_model<decltype(use_probe)::value,
+                         decltype(use_event)::value>(n_particle);
+          });
+    }
+
+    template <bool UseProbe, bool UseEvent>
     void
     launch_model(const std::size_t n_particle) const
     {
@@ -169,11 +217,17 @@ namespace Simulation::KernelInline
       std::size_t league_size
           = Common::c_league_size(n_particle, m_options.m_p_p_team_model);
 
-      const auto cycle_policy
-          = Kokkos::TeamPolicy<TagCycle>(model_space,
-                                         static_cast<int>(league_size),
-                                         Kokkos::AUTO(),
-                                         Kokkos::AUTO());
+      auto cycle_policy = Kokkos::TeamPolicy<TagCycle<UseProbe, UseEvent>>(
+          model_space,
+          static_cast<int>(league_size),
+          Kokkos::AUTO(),
+          Kokkos::AUTO());
+
+      // Per-team division flags and ranks used to aggregate reservations
+      cycle_policy.set_scratch_size(
+          0,
+          Kokkos::PerTeam(cycle_kernel_type::team_scratch_size(
+              m_options.m_p_p_team_model)));
 
       Kokkos::parallel_reduce(
           "cycle_model",
@@ -4,12 +4,12 @@
 #include <Kokkos_Assert.hpp>
 #include <Kokkos_Core.hpp>
 #include <Kokkos_Macros.hpp>
-#include <Kokkos_Printf.hpp>
 #include <Kokkos_Random.hpp>
 #include <biocma_cst_config.hpp>
 #include <cassert>
 #include <common/common.hpp>
 #include <mc/alias.hpp>
+#include <mc/diagnostics.hpp>
 #include <mc/domain.hpp>
 #include <mc/events.hpp>
 #include <mc/particles_container.hpp>
@@ -33,7 +33,11 @@ namespace Simulation::KernelInline
   struct TagContribution0D
   {
   };
-  struct TagCycle
+  /**
+   * @brief Tag of cycle kernel, instrumentation is part of the type so that
+   * each runtime mask selects its own instantiation (see launch_model)
+   */
+  template <bool UseProbe, bool UseEvent> struct TagCycle
   {
   };
 
@@ -125,6 +129,9 @@ namespace Simulation::KernelInline
     using TeamPolicy = Kokkos::TeamPolicy<ComputeSpace>;
     using TeamMember = TeamPolicy::member_type;
     using value_type = CycleReduceType;
+    using ScratchSpace = TeamPolicy::execution_space::scratch_memory_space;
+    using ScratchFlagView = Kokkos::View<uint8_t*, ScratchSpace>;
+    using ScratchRankView = Kokkos::View<uint32_t*, ScratchSpace>;
 
     CycleFunctor() = default;
 
@@ -138,11 +145,12 @@ namespace Simulation::KernelInline
                  MC::pool_type _random_pool,
                  MC::KernelConcentrationType&& _concentrations,
                  MC::EventContainer _event,
+                 MC::DiagnosticChannel _diagnostics,
                  ProbeAutogeneratedBuffer _probes)
         : m_p_team(p_per_team), d_t(0.), particles(std::move(_particles)),
           random_pool(std::move(_random_pool)),
           concentrations(std::move(_concentrations)), events(std::move(_event)),
-          probes(std::move(_probes))
+          diagnostics(std::move(_diagnostics)), probes(std::move(_probes))
     {
     }
 
@@ -160,8 +168,41 @@ namespace Simulation::KernelInline
       n_p = this->particles.n_particles();
     }
 
+    /**
+     * @brief Set concentrations of compartments [first, first + extent(1))
+     */
+    void
+    set_compartments(MC::KernelConcentrationType _concentrations,
+                     const std::size_t first)
+    {
+      this->concentrations = std::move(_concentrations);
+      this->first_compartment = first;
+    }
+
+    /**
+     * @brief Team scratch size needed to aggregate division reservation
+     */
+    static std::size_t
+    team_scratch_size(const std::size_t p_per_team)
+    {
+      return ScratchFlagView::shmem_size(p_per_team)
+             + ScratchRankView::shmem_size(p_per_team);
+    }
+
+    /**
+     * @brief Team kernel, particles are updated then dividing particles of the
+     * team reserve their daughter slots at once.
+     *
+     * 1. Each particle is updated and flags whether it divides
+     * 2. A team scan gives the rank of each dividing particle and the number of
+     * daughters for the team
+     * 3. One thread reserves the whole block (one atomic for the team instead
+     * of one per dividing particle), reservation is broadcast to the team
+     * 4. Daughters are written into contiguous slots
+     */
+    template <bool UseProbe, bool UseEvent>
     KOKKOS_INLINE_FUNCTION void
-    operator()(TagCycle _tag,
+    operator()(TagCycle<UseProbe, UseEvent> _tag,
                const TeamMember& team,
                value_type& reduce_val) const
     {
@@ -180,6 +221,9 @@ namespace Simulation::KernelInline
       KOKKOS_ASSERT(upper_bound > 0);
       KOKKOS_ASSERT(upper_bound < n_particle);
 
+      ScratchFlagView divide(team.team_scratch(0), count);
+      ScratchRankView rank(team.team_scratch(0), count);
+
       value_type local;
       Kokkos::parallel_reduce(
           Kokkos::TeamThreadRange(team, 0, upper_bound),
@@ -187,47 +231,88 @@ namespace Simulation::KernelInline
           {
             const std::size_t flatten_index = p0 + relative_index;
             const bool active = status(flatten_index) == MC::Status::Idle;
-
+            bool do_divide = false;
             if (active)
             {
               ages(flatten_index, 1) += _d_t;
-              exec_per_particle(flatten_index, lv);
+              do_divide = exec_per_particle<UseProbe, UseEvent>(
+                  flatten_index, lv);
             }
+            divide(relative_index) = static_cast<uint8_t>(do_divide);
           },
           local);
-      // Kokkos::parallel_reduce(
-      //     Kokkos::TeamThreadRange(team, count),
-      //     [&](std::size_t relative_index, value_type& lv)
-      //     {
-      //       const std::size_t flatten_index = p0 + relative_index;
-      //       const bool active = flatten_index < n_particle
-      //                           && status(flatten_index) == MC::Status::Idle;
-
-      //       if (active)
-      //       {
-      //         ages(flatten_index, 1) += _d_t;
-
-      //         exec_per_particle(flatten_index, lv);
-      //       }
-      //     },
-      //     local);
+      team.team_barrier();
+
+      std::size_t n_division = 0;
+      Kokkos::parallel_scan(
+          Kokkos::TeamThreadRange(team, 0, upper_bound),
+          [&](const std::size_t relative_index,
+              std::size_t& partial,
+              const bool final)
+          {
+            if (final)
+            {
+              rank(relative_index) = static_cast<uint32_t>(partial);
+            }
+            partial += divide(relative_index);
+          },
+          n_division);
+
+      if (n_division != 0)
+      {
+        MC::DivisionReservation reservation{};
+        Kokkos::single(
+            Kokkos::PerTeam(team),
+            [&](MC::DivisionReservation& r)
+            { r = particles.reserve_division(n_division); },
+            reservation);
+
+        std::size_t n_overflow = 0;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange(team, 0, upper_bound),
+            [&](const std::size_t relative_index, std::size_t& lo)
+            {
+              if (divide(relative_index) != 0)
+              {
+                const bool ok
+                    = particles.handle_division(random_pool,
+                                                p0 + relative_index,
+                                                reservation,
+                                                rank(relative_index));
+                lo += on_division<UseEvent>(ok, p0 + relative_index);
+              }
+            },
+            n_overflow);
+        local.waiting_allocation_particle += n_overflow;
+      }
+
       team.team_barrier();
 
       reduce_val += local;
     }
 
+    template <bool UseProbe, bool UseEvent>
     KOKKOS_FORCEINLINE_FUNCTION void
-    operator()(const TagCycle _tag,
+    operator()(const TagCycle<UseProbe, UseEvent> _tag,
                const std::size_t idx,
                value_type& reduce_val) const
     {
 
       (void)_tag;
       (void)reduce_val.dead_total;
-      exec_per_particle(idx, reduce_val);
+      if (exec_per_particle<UseProbe, UseEvent>(idx, reduce_val))
+      {
+        reduce_val.waiting_allocation_particle += on_division<UseEvent>(
+            particles.handle_division(random_pool, idx), idx);
+      }
     }
 
-    KOKKOS_INLINE_FUNCTION void
+    /**
+     * @brief Update particle
+     * @return true if particle divides, actual division is done by caller
+     */
+    template <bool UseProbe, bool UseEvent>
+    KOKKOS_INLINE_FUNCTION bool
     exec_per_particle(const std::size_t idx, value_type& reduce_val) const
     {
       using mem_space = ComputeSpace::memory_space;
@@ -237,12 +322,13 @@ namespace Simulation::KernelInline
                                         idx,
                                         particles.model,
                                         particles.contribs,
-                                        particles.position(idx),
+                                        particles.position(idx)
+                                            - first_compartment,
                                         concentrations);
 
       if (new_status == MC::Status::Division)
       {
-        if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+        if constexpr (UseProbe)
         {
           // Register probe here to sample BEFORE division and even if division
           // procedure fails to spawn new particle, the age is still the same
@@ -250,28 +336,52 @@ namespace Simulation::KernelInline
               particles.ages(idx, 1)); // Skip error
         }
 
-        if (!particles.handle_division(random_pool, idx)) [[unlikely]]
-        {
-          reduce_val.waiting_allocation_particle += 1;
-          events.wrap_incr<MC::EventType::Overflow>();
-          Kokkos::printf("[KERNEL] Division Overflow\r\n");
-        }
-        events.wrap_incr<MC::EventType::NewParticle>();
-
         /*
         TODO, it seems that after some calculation (example cstr 0d)
         size(division probes) = number of tally+1 where the last probe is 0
         where size(leaving time) == tally
         Is it a bug ?
         */
-      };
+        return true;
+      }
+
+      if (new_status == MC::Status::Dead) [[unlikely]]
+      {
+        particles.handle_death(idx);
+        reduce_val.dead_total += 1;
+        events.incr_if<MC::EventType::Death, UseEvent>();
+      }
+      return false;
+    }
+
+    /**
+     * @brief Record division events
+     * @return 1 if division overflowed, 0 otherwise
+     */
+    template <bool UseEvent>
+    KOKKOS_INLINE_FUNCTION std::size_t
+    on_division(const bool success, const std::size_t idx) const
+    {
+      events.incr_if<MC::EventType::NewParticle, UseEvent>();
+      if (!success) [[unlikely]]
+      {
+        events.incr_if<MC::EventType::Overflow, UseEvent>();
+        // Value is compartment to locate where the buffer is too small
+        diagnostics.report(MC::DiagnosticCode::DivisionOverflow,
+                           idx,
+                           static_cast<double>(particles.position(idx)));
+        return 1;
+      }
+      return 0;
     }
 
     M::FloatType d_t;
     MC::ParticlesContainer<M> particles;
     MC::pool_type random_pool;
     MC::KernelConcentrationType concentrations;
+    std::size_t first_compartment{}; ///< Compartment of concentrations column 0
     MC::EventContainer events;
+    MC::DiagnosticChannel diagnostics;
     ProbeAutogeneratedBuffer probes;
   };
 
@@ -11,6 +11,7 @@
 #include <mc/alias.hpp>
 #include <mc/domain.hpp>
 #include <mc/events.hpp>
+#include <mc/free_slots.hpp>
 #include <mc/prng/prng.hpp>
 #include <mc/traits.hpp>
 #include <simulation/probability_leaving.hpp>
@@ -65,6 +66,7 @@ namespace Simulation::KernelInline
       const MC::CumulativeProbabilityView<ComputeSpace, true>&
           cumulative_probability,
       const std::size_t i_compartment,
+      const std::size_t i_row,
       const double random_number)
   {
     const int mask_do_serch = static_cast<int>(do_serch);
@@ -91,14 +93,14 @@ namespace Simulation::KernelInline
     while (left < right)
     {
       const int mid = (left + right) >> 1; // NOLINT
-      const auto pm = cumulative_probability(i_compartment, mid);
+      const auto pm = cumulative_probability(i_row, mid);
       const int mask = static_cast<int>(random_number > pm);
       left = mask * (mid + 1) + (1 - mask) * left;
       right = mask * right + (1 - mask) * mid;
     }
     KOKKOS_ASSERT(left >= 0 && static_cast<size_t>(left) < neighbors.extent(1));
     const auto ret = i_compartment * (1 - mask_do_serch)
-                     + neighbors(i_compartment, left) * mask_do_serch;
+                     + neighbors(i_row, left) * mask_do_serch;
     return ret;
   }
 
@@ -129,10 +131,14 @@ namespace Simulation::KernelInline
   struct TagRNG
   {
   };
-  struct TagMove
+  /**
+   * @brief Tags of move kernels, instrumentation is part of the type so that
+   * each runtime mask selects its own instantiation (see launch_move)
+   */
+  template <bool UseEvent> struct TagMove
   {
   };
-  struct TagLeave
+  template <bool UseProbe, bool UseEvent> struct TagLeave
   {
   };
 
@@ -140,6 +146,8 @@ namespace Simulation::KernelInline
   {
     using TeamPolicy = Kokkos::TeamPolicy<ComputeSpace>;
     using TeamMember = TeamPolicy::member_type;
+    // Explicit because value type cannot be deduced from templated operator
+    using value_type = std::size_t;
     MoveFunctor() = default;
     MoveFunctor(std::size_t p_team_move,
                 std::size_t p_team_leave,
@@ -191,6 +199,7 @@ namespace Simulation::KernelInline
            MC::ParticlePositions _positions,
            MC::ParticleStatus _status,
            MC::ParticleAges _ages,
+           MC::FreeSlots _free_slots,
            bool b_move,
            bool b_leave)
     {
@@ -204,10 +213,12 @@ namespace Simulation::KernelInline
       this->positions = std::move(_positions);
       this->status = std::move(_status);
       this->ages = std::move(_ages);
+      this->free_slots = std::move(_free_slots);
     }
 
+    template <bool UseEvent>
     KOKKOS_INLINE_FUNCTION void
-    operator()(TagMove /*tag*/,
+    operator()(TagMove<UseEvent> /*tag*/,
                const Kokkos::TeamPolicy<ComputeSpace>::member_type& team) const
     {
       using ScratchSpace
@@ -268,7 +279,7 @@ namespace Simulation::KernelInline
                              KOKKOS_ASSERT(base + 1 < N);
                              const auto rng1 = rng(base);
                              const auto rng2 = rng(base + 1);
-                             handle_move(flat_index, rng1, rng2);
+                             handle_move<UseEvent>(flat_index, rng1, rng2);
                            });
     }
 
@@ -344,8 +355,9 @@ namespace Simulation::KernelInline
     //   //                });
     // }
 
+    template <bool UseProbe, bool UseEvent>
     KOKKOS_INLINE_FUNCTION void
-    operator()([[maybe_unused]] TagLeave _tag,
+    operator()([[maybe_unused]] TagLeave<UseProbe, UseEvent> _tag,
                const std::size_t& idx,
                std::size_t& local_dead_count) const
     {
@@ -355,7 +367,8 @@ namespace Simulation::KernelInline
       }
 
       ages(idx, 0) += d_t;
-      handle_exit(idx, move.leaving_flow, local_dead_count);
+      handle_exit<UseProbe, UseEvent>(
+          idx, move.leaving_flow, local_dead_count);
     }
 
     // KOKKOS_INLINE_FUNCTION void
@@ -389,6 +402,7 @@ namespace Simulation::KernelInline
       return enable_leave || enable_move;
     }
 
+    template <bool UseEvent>
     KOKKOS_FUNCTION void
     handle_move(const std::size_t idx, const float rng1, const float rng2) const
     {
@@ -399,21 +413,25 @@ namespace Simulation::KernelInline
       KOKKOS_ASSERT(rng1 >= 0. && rng1 <= 1 && rng2 >= 0. && rng2 <= 1);
 
       const std::size_t i_current_compartment = positions(idx);
+      // Tables may only hold the rows of owned compartments
+      const std::size_t i_row = i_current_compartment - move.first;
 
       KOKKOS_ASSERT(
-          i_current_compartment < move.liquid_volume.extent(0)
-          && "Particle position is incorect (greater than compartment number)");
+          i_current_compartment >= move.first
+          && i_row < move.liquid_volume.extent(0)
+          && "Particle position is incorect (not a compartment of tables)");
 
-      const bool mask_next = probability_leaving<fast_tag>(
-          rng1,
-          move.liquid_volume(i_current_compartment),
-          move.diag_transition(i_current_compartment),
-          d_t);
+      const bool mask_next
+          = probability_leaving<fast_tag>(rng1,
+                                          move.liquid_volume(i_row),
+                                          move.diag_transition(i_row),
+                                          d_t);
 
       positions(idx) = __find_next_compartment(mask_next,
                                                move.neighbors,
                                                move.cumulative_probability,
                                                i_current_compartment,
+                                               i_row,
                                                rng2);
 
       // positions(idx)
@@ -424,14 +442,14 @@ namespace Simulation::KernelInline
       //                   : i_current_compartment;
 
       KOKKOS_ASSERT(
-          positions(idx) < move.liquid_volume.extent(0)
+          positions(idx) < move.n_compartments
           && " Position after move is greater than compartment number");
 
-      if constexpr (AutoGenerated::FlagCompileTime::enable_event_counter)
+      if constexpr (UseEvent)
       {
         if (mask_next)
         {
-          events.wrap_incr<MC::EventType::Move>();
+          events.incr<MC::EventType::Move>();
         }
       }
     }
@@ -583,7 +601,7 @@ namespace Simulation::KernelInline
     // Assumption: given leaving_flow is valid (i_flow < n_compartment)
     // Add templated free-function "find_flow"
     // specialize function to empty with tag 0D
-    template <typename ExecSpace>
+    template <bool UseProbe, bool UseEvent, typename ExecSpace>
     KOKKOS_FORCEINLINE_FUNCTION std::size_t
     handle_exit(
         const std::size_t idx,
@@ -626,7 +644,7 @@ namespace Simulation::KernelInline
         // {
         dead_count += leave_mask;
         // }
-        if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+        if constexpr (UseProbe)
         {
           if (leave_mask != 0)
           {
@@ -638,7 +656,13 @@ namespace Simulation::KernelInline
             static_cast<int>(status(idx)) * (1 - leave_mask)
             + static_cast<int>(MC::Status::Exit) * leave_mask);
 
-        if constexpr (AutoGenerated::FlagCompileTime::enable_event_counter)
+        if (leave_mask != 0)
+        {
+          // Slot can be reused by division during next step
+          free_slots.push(idx);
+        }
+
+        if constexpr (UseEvent)
         {
           events.add<MC::EventType::Exit>(leave_mask);
         }
@@ -656,6 +680,7 @@ namespace Simulation::KernelInline
     MC::EventContainer events;
     ProbeAutogeneratedBuffer probes;
     MC::ParticleAges ages;
+    MC::FreeSlots free_slots;
     std::size_t m_p_team_leave{};
     std::size_t m_p_team_move{};
 
@@ -9,6 +9,7 @@
 namespace Simulation
 {
   class ScalarSimulation;
+  class CompartmentPermutation;
 };
 
 namespace Simulation::MassTransfer
@@ -60,7 +61,12 @@ namespace Simulation::MassTransfer
 
     void gas_liquid_mass_transfer() const;
 
-    void update(const CmaUtils::IterationStatePtrType& state);
+    /**
+     * @brief Compute kla from state. If compartments are renumbered, kla
+     * columns computed in flowmap numbering are moved to internal numbering
+     */
+    void update(const CmaUtils::IterationStatePtrType& state,
+                const CompartmentPermutation* permutation = nullptr);
 
     [[nodiscard]] const std::shared_ptr<MassTransferProxy>& proxy() const;
 
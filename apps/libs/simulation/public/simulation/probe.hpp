@@ -32,9 +32,11 @@ namespace Simulation
   */
 
   /**  @brief Class to store time event as bulk storage
-   *  !! The behaviour of this class is directly link to value of
-   * AutoGenerated::FlagCompileTime::use_probe When use_probe==false,
-   * implementation is such that no error/throw and no side effect for caller
+   *  Probes are enabled at construction (runtime instrumentation mask), an
+   * inactive probe allocates nothing and its implementation is such that no
+   * error/throw and no side effect for caller.
+   * Kernels do not rely on `active` to skip `set`, they are instantiated
+   * without probe call when probes are disabled.
    */
   template <std::size_t buffer_size> class Probes
   {
@@ -47,13 +49,10 @@ namespace Simulation
     void
     clear() const
     {
-      if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+      if (active)
       {
-        if (active)
-        {
-          Kokkos::deep_copy(buffer, 0.);
-          Kokkos::deep_copy(internal_counter, 0);
-        }
+        Kokkos::deep_copy(buffer, 0.);
+        Kokkos::deep_copy(internal_counter, 0);
       }
     }
 
@@ -64,64 +63,60 @@ namespace Simulation
       static_assert(Kokkos::SpaceAccessibility<
                     Space,
                     Kokkos::DefaultExecutionSpace::memory_space>::accessible);
-      //Strategy here: for the moment kernel implementation do not allow to have use_probe==true and active ==false.
-      // Then check active for safetiness but useless
-      if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+      // Return true if probe is not activated indicates no error to caller
+      if (!active)
       {
-        if (const auto i = Kokkos::atomic_fetch_inc(&internal_counter());
-            (i < buffer_size) && active)
-        {
-          this->buffer(i) = val;
-          return true;
-        }
-        return false;
+        return true;
       }
-      //Return true if probe is not activate indicates no error to caller
-      return true;
+      if (const auto i = Kokkos::atomic_fetch_inc(&internal_counter());
+          i < buffer_size)
+      {
+        this->buffer(i) = val;
+        return true;
+      }
+      return false;
     }
 
     [[nodiscard]] bool
     need_export() const noexcept
     {
-      if constexpr (AutoGenerated::FlagCompileTime::use_probe)
-      {
-        return active && (internal_counter() >= buffer_size);
-      }
-      return false; // As the probe never need to be exported, there is no error
+      // As an inactive probe never needs to be exported, there is no error
+      return active && (internal_counter() >= buffer_size);
     }
 
     [[nodiscard]] std::span<const double>
     get() const
     {
-      if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+      if (!active)
       {
-        if (!active)
-        {
-          // return empty span is a valid return ,
-          //  use {} constructor to comply clang and gcc
-          return {};
-        }
-        // TODO this should be alsway internal_counter(), but in case
-        // internal counter > buffersize (error in race condition) size
-        // never overrun buffer_size
-        const auto return_size = std::min(buffer_size, internal_counter());
-        assert(return_size <= buffer_size);
-        /*
-        // Safe: returning a span of size return_size is ok; the span may be
-        smaller than the full host_buffer
-        */
-        Kokkos::deep_copy(host_buffer, buffer);
-        return { host_buffer.data(), return_size };
+        // return empty span is a valid return ,
+        //  use {} constructor to comply clang and gcc
+        return {};
       }
+      // TODO this should be alsway internal_counter(), but in case
+      // internal counter > buffersize (error in race condition) size
+      // never overrun buffer_size
+      const auto return_size = std::min(buffer_size, internal_counter());
+      assert(return_size <= buffer_size);
+      /*
+      // Safe: returning a span of size return_size is ok; the span may be
+      smaller than the full host_buffer
+      */
+      Kokkos::deep_copy(host_buffer, buffer);
+      return { host_buffer.data(), return_size };
+    }
 
-      return {}; // Also valid, probe not activated returns empty span
+    [[nodiscard]] bool
+    is_active() const noexcept
+    {
+      return active;
     }
 
-    Probes()
+    explicit Probes(bool enable = AutoGenerated::FlagCompileTime::use_probe)
+        : active(enable)
     {
-      if constexpr (AutoGenerated::FlagCompileTime::use_probe)
+      if (active)
       {
-        active = true;
         buffer = buffer_type<Kokkos::DefaultExecutionSpace>("probe_buffer");
         internal_counter = Kokkos::View<uint64_t, Kokkos::SharedSpace>("i_c");
         host_buffer
@@ -129,11 +124,6 @@ namespace Simulation
 
         clear();
       }
-      else
-      {
-
-        active = false;
-      }
     }
 
   private:
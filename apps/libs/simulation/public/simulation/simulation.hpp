@@ -15,6 +15,8 @@
 #include <mc/unit.hpp>
 #include <memory>
 #include <optional>
+#include <span>
+#include <type_traits>
 #include <simulation/descriptors/dimensions.hpp>
 #include <simulation/feed_descriptor.hpp>
 #include <simulation/kernels/kernels.hpp>
@@ -40,6 +42,7 @@ namespace CmaUtils
 namespace Simulation
 {
   class ScalarSimulation;
+  struct HydroRenumbering;
 
   class SimulationUnit
   {
@@ -82,10 +85,57 @@ namespace Simulation
     double advance(double d_t) noexcept;
 
     void updateHydro(const CmaUtils::IterationStatePtrType& newstate);
+
+    /**
+     * @brief Update domain from flowmap data. First call selects compartment
+     * numbering (see `init_renumbering`), flowmap data is then moved to
+     * internal numbering.
+     */
     void updateMCHydro(std::span<const double> newliquid_volume,
                        std::span<const std::size_t> neighors_flat,
                        std::span<const double> proba_flat,
-                       std::span<const double> out_flows) const;
+                       std::span<const double> out_flows);
+
+    /**
+     * @brief True when concentrations and domain tables are in host memory,
+     * they can then be read in place from memory shared by the ranks of a
+     * node
+     */
+    static constexpr bool host_aliases_device
+        = std::is_same_v<MC::ComputeSpace::memory_space,
+                         MC::HostSpace::memory_space>;
+
+    /**
+     * @brief Read and write liquid concentrations in values (host memory of
+     * getCliqData_mut().size() doubles) until own_shared_memory. Kernels
+     * use the new storage if called before init_functors.
+     */
+    void alias_concentration(std::span<double> values);
+
+    /**
+     * @brief Keep domain tables in memory shared by the ranks of a node (see
+     * MC::ReactorDomain::share_tables)
+     */
+    void share_domain_tables(std::span<std::byte> memory,
+                             std::size_t n_neighbors,
+                             bool writer);
+
+    /**
+     * @brief Copy aliased concentrations and shared domain tables in own
+     * allocations, before the shared memory is released
+     */
+    void own_shared_memory();
+
+    /**
+     * @brief Keep domain tables of compartments [first, end) only, particles
+     * must stay in these compartments at the start of each cycle. With
+     * local_scalars, liquid concentrations and contributions are also
+     * restricted (see ScalarSimulation::restrict_compartments), kernels use
+     * them from the next cycle
+     */
+    void restrict_compartments(std::size_t first,
+                               std::size_t end,
+                               bool local_scalars);
 
     bool checkScalar() const;
 
@@ -102,6 +152,17 @@ namespace Simulation
 
     void updateScalarHydro(const CmaUtils::IterationStatePtrType& newstate);
 
+    /**
+     * @brief Reverse Cuthill-McKee renumbering of compartments from first
+     * flowmap neighbors (BIOMC_RENUMBER_COMPARTMENTS) or numbering restored
+     * with particles. Particles and scalars are moved to internal numbering,
+     * flowmap numbering is kept if bandwidth is not reduced.
+     */
+    void init_renumbering(std::span<const std::size_t> neighors_flat);
+
+    [[nodiscard]] std::size_t
+    internal_compartment(std::size_t flowmap_index) const noexcept;
+
     void setLiquidFlow(CmaUtils::PreCalculatedHydroState* _flows_l);
     void setGasFlow(CmaUtils::PreCalculatedHydroState* _flows_g);
     void post_init_compartments();
@@ -139,6 +200,11 @@ namespace Simulation
     MassTransfer::MassTransferModel mt_model;
 
     std::shared_ptr<IO::Logger> logger;
+    MC::DiagnosticReporter diagnostic_reporter;
+
+    // Null if compartments keep flowmap numbering
+    std::unique_ptr<HydroRenumbering> renumbering;
+    bool renumbering_pending;
 
     template <ModelType Model>
     void post_cycle(MC::ParticlesContainer<Model>& container,
@@ -158,8 +224,11 @@ namespace Simulation
   {
     PROFILE_SECTION("Simulation::pre_cycle")
 
-    cycle_functors.update(
-        d_t, container, this->mc_unit->domain.get_const_inner());
+    cycle_functors.update(d_t,
+                          container,
+                          this->mc_unit->domain.get_const_inner(),
+                          getkernel_concentration(),
+                          contribs_scatter);
   }
 
   template <typename Space, ModelType Model>
@@ -175,6 +244,7 @@ namespace Simulation
         getkernel_concentration(),
         contribs_scatter,
         mc_unit->events,
+        mc_unit->diagnostics,
         mc_unit->domain.get_const_inner(),
         probes[ProbeType ::LeavingTime],
         probes[ProbeType ::DivisionTime]);
@@ -225,15 +295,9 @@ namespace Simulation
 
     container.merge_buffer();
 
-    if (host_red.waiting_allocation_particle != 0)
-    {
-      if (logger)
-      {
-        logger->alert("Simulation",
-                      "Overflow of particle not implemented yet (ignore "
-                      "_waiting_allocation_particle)");
-      }
-    }
+    // Overflowing particles are reported through the diagnostic channel
+    // (waiting_allocation_particle is not handled yet)
+    diagnostic_reporter.process(this->mc_unit->diagnostics, logger.get());
 
     // set_kernel_contribs_to_host();
   }
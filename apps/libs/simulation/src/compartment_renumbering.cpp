@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <compartment_renumbering.hpp>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  constexpr auto unset = std::numeric_limits<std::size_t>::max();
+
+  // Undirected compartment graph in CSR format, without self loop
+  struct CompartmentGraph
+  {
+    std::vector<std::size_t> offsets;
+    std::vector<std::size_t> adjacency;
+
+    [[nodiscard]] std::size_t
+    degree(std::size_t i) const noexcept
+    {
+      return offsets[i + 1] - offsets[i];
+    }
+
+    [[nodiscard]] std::span<const std::size_t>
+    neighbors(std::size_t i) const noexcept
+    {
+      return { adjacency.data() + offsets[i], degree(i) };
+    }
+
+    // Comparator by increasing degree
+    [[nodiscard]] auto
+    lower_degree() const noexcept
+    {
+      return [this](std::size_t a, std::size_t b)
+      { return degree(a) < degree(b); };
+    }
+  };
+
+  CompartmentGraph
+  make_graph(std::size_t n, std::span<const std::size_t> neighbors_flat)
+  {
+    if (n == 0 || neighbors_flat.size() % n != 0)
+    {
+      throw std::invalid_argument(
+          "Neighbors size is not a multiple of compartment number");
+    }
+    const std::size_t n_neighbors = neighbors_flat.size() / n;
+
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    edges.reserve(2 * neighbors_flat.size());
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      for (std::size_t k = 0; k < n_neighbors; ++k)
+      {
+        const auto j = neighbors_flat[i * n_neighbors + k];
+        if (j < n && j != i)
+        {
+          edges.emplace_back(i, j);
+          edges.emplace_back(j, i);
+        }
+      }
+    }
+    std::ranges::sort(edges);
+    const auto duplicates = std::ranges::unique(edges);
+    edges.erase(duplicates.begin(), duplicates.end());
+
+    CompartmentGraph graph;
+    graph.offsets.assign(n + 1, 0);
+    graph.adjacency.reserve(edges.size());
+    for (const auto& [i, j] : edges)
+    {
+      graph.offsets[i + 1]++;
+      graph.adjacency.push_back(j);
+    }
+    std::partial_sum(
+        graph.offsets.begin(), graph.offsets.end(), graph.offsets.begin());
+    return graph;
+  }
+
+  // Level structure rooted at root: returns eccentricity and fills last level
+  std::size_t
+  last_level(const CompartmentGraph& graph,
+             std::size_t root,
+             std::vector<std::size_t>& depth,
+             std::vector<std::size_t>& last)
+  {
+    std::ranges::fill(depth, unset);
+    std::queue<std::size_t> queue;
+    depth[root] = 0;
+    queue.push(root);
+    std::size_t eccentricity = 0;
+    last.clear();
+    while (!queue.empty())
+    {
+      const auto u = queue.front();
+      queue.pop();
+      if (depth[u] > eccentricity)
+      {
+        eccentricity = depth[u];
+        last.clear();
+      }
+      last.push_back(u);
+      for (const auto v : graph.neighbors(u))
+      {
+        if (depth[v] == unset)
+        {
+          depth[v] = depth[u] + 1;
+          queue.push(v);
+        }
+      }
+    }
+    return eccentricity;
+  }
+
+  // George-Liu heuristic: move root to a min degree compartment of the last
+  // level while eccentricity grows
+  std::size_t
+  pseudo_peripheral(const CompartmentGraph& graph, std::size_t root)
+  {
+    std::vector<std::size_t> depth(graph.offsets.size() - 1);
+    std::vector<std::size_t> last;
+    std::size_t eccentricity = last_level(graph, root, depth, last);
+    while (true)
+    {
+      const auto candidate
+          = *std::ranges::min_element(last, graph.lower_degree());
+      std::vector<std::size_t> candidate_last;
+      const auto candidate_eccentricity
+          = last_level(graph, candidate, depth, candidate_last);
+      if (candidate_eccentricity <= eccentricity)
+      {
+        return root;
+      }
+      root = candidate;
+      eccentricity = candidate_eccentricity;
+      last = std::move(candidate_last);
+    }
+  }
+
+  void
+  cuthill_mckee(const CompartmentGraph& graph,
+                std::size_t root,
+                std::vector<bool>& visited,
+                std::vector<std::size_t>& order)
+  {
+    std::queue<std::size_t> queue;
+    std::vector<std::size_t> next;
+    visited[root] = true;
+    queue.push(root);
+    while (!queue.empty())
+    {
+      const auto u = queue.front();
+      queue.pop();
+      order.push_back(u);
+
+      next.clear();
+      for (const auto v : graph.neighbors(u))
+      {
+        if (!visited[v])
+        {
+          visited[v] = true;
+          next.push_back(v);
+        }
+      }
+      std::ranges::stable_sort(next, graph.lower_degree());
+      for (const auto v : next)
+      {
+        queue.push(v);
+      }
+    }
+  }
+
+} // namespace
+
+namespace Simulation
+{
+
+  CompartmentPermutation::CompartmentPermutation(
+      std::vector<std::size_t> new_to_old)
+      : m_new_to_old(std::move(new_to_old)),
+        m_old_to_new(m_new_to_old.size(), unset)
+  {
+    for (std::size_t j = 0; j < m_new_to_old.size(); ++j)
+    {
+      const auto old_index = m_new_to_old[j];
+      if (old_index >= m_new_to_old.size() || m_old_to_new[old_index] != unset)
+      {
+        throw std::invalid_argument("Compartment renumbering is not a "
+                                    "permutation");
+      }
+      m_old_to_new[old_index] = j;
+    }
+  }
+
+  CompartmentPermutation
+  CompartmentPermutation::identity(std::size_t n_compartment)
+  {
+    std::vector<std::size_t> order(n_compartment);
+    std::iota(order.begin(), order.end(), 0);
+    return CompartmentPermutation(std::move(order));
+  }
+
+  CompartmentPermutation
+  CompartmentPermutation::reverse_cuthill_mckee(
+      std::size_t n_compartment, std::span<const std::size_t> neighbors_flat)
+  {
+    const auto graph = make_graph(n_compartment, neighbors_flat);
+
+    // Components are started from their smallest degree compartment
+    std::vector<std::size_t> starts(n_compartment);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::ranges::stable_sort(starts, graph.lower_degree());
+
+    std::vector<bool> visited(n_compartment, false);
+    std::vector<std::size_t> order;
+    order.reserve(n_compartment);
+    for (const auto start : starts)
+    {
+      if (!visited[start])
+      {
+        cuthill_mckee(graph, pseudo_peripheral(graph, start), visited, order);
+      }
+    }
+
+    std::ranges::reverse(order);
+    return CompartmentPermutation(std::move(order));
+  }
+
+  std::size_t
+  CompartmentPermutation::bandwidth(
+      std::span<const std::size_t> neighbors_flat) const
+  {
+    const auto n = size();
+    if (n == 0)
+    {
+      return 0;
+    }
+    const std::size_t n_neighbors = neighbors_flat.size() / n;
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      for (std::size_t k = 0; k < n_neighbors; ++k)
+      {
+        const auto j = neighbors_flat[i * n_neighbors + k];
+        if (j < n)
+        {
+          const auto a = m_old_to_new[i];
+          const auto b = m_old_to_new[j];
+          result = std::max(result, (a > b) ? a - b : b - a);
+        }
+      }
+    }
+    return result;
+  }
+
+  bool
+  CompartmentPermutation::is_identity() const noexcept
+  {
+    for (std::size_t j = 0; j < size(); ++j)
+    {
+      if (m_new_to_old[j] != j)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void
+  CompartmentPermutation::relabel(std::span<std::size_t> indices) const noexcept
+  {
+    for (auto& index : indices)
+    {
+      if (index < size())
+      {
+        index = m_old_to_new[index];
+      }
+    }
+  }
+
+} // namespace Simulation
@@ -0,0 +1,288 @@
+#include <Kokkos_Assert.hpp>
+#include <Kokkos_Core.hpp>
+#include <common/common.hpp>
+#include <cstddef>
+#include <device_scalar_solver.hpp>
+
+namespace
+{
+  using Solver = Simulation::DeviceScalarSolver;
+
+  template <typename T>
+  using unmanaged_host_view
+      = Kokkos::View<T, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+
+  template <typename T>
+  void
+  upload(Kokkos::View<T*, ComputeSpace>& dst,
+         const T* src,
+         std::size_t n,
+         const char* label)
+  {
+    if (dst.extent(0) != n)
+    {
+      dst = Kokkos::View<T*, ComputeSpace>(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, label), n);
+    }
+    Kokkos::deep_copy(dst, unmanaged_host_view<const T*>(src, n));
+  }
+
+  void
+  upload(Kokkos::View<double**, Kokkos::LayoutLeft, ComputeSpace> dst,
+         const Eigen::MatrixXd& src)
+  {
+    KOKKOS_ASSERT(dst.extent(0) == static_cast<std::size_t>(src.rows())
+                  && dst.extent(1) == static_cast<std::size_t>(src.cols()));
+    Kokkos::deep_copy(
+        dst,
+        Kokkos::View<const double**,
+                     Kokkos::LayoutLeft,
+                     Kokkos::HostSpace,
+                     Kokkos::MemoryUnmanaged>(
+            src.data(), dst.extent(0), dst.extent(1)));
+  }
+
+  // dM = C T - C S + Src (+ sign * mtr), one thread per compartment gathers
+  // inflows from the compressed column of T
+  template <bool WithMtr>
+  void
+  update_mass(double d_t,
+              int n_r,
+              Kokkos::View<const int*, ComputeSpace> row_map,
+              Kokkos::View<const int*, ComputeSpace> entries,
+              Kokkos::View<const double*, ComputeSpace> values,
+              Kokkos::View<const double*, ComputeSpace> sink,
+              const Solver::concentration_view_type& c,
+              const Solver::sources_view_type& sources,
+              Kokkos::View<const double**, Kokkos::LayoutLeft, ComputeSpace>
+                  mtr,
+              double sign,
+              Kokkos::View<double**, Kokkos::LayoutLeft, ComputeSpace> mass)
+  {
+    const auto n_c = static_cast<int>(mass.extent(1));
+    Kokkos::parallel_for(
+        "scalar_device_mass",
+        Kokkos::RangePolicy<ComputeSpace>(0, n_c),
+        KOKKOS_LAMBDA(const int i_c) {
+          const double s = sink(i_c);
+          const int begin = row_map(i_c);
+          const int end = row_map(i_c + 1);
+          for (int i_r = 0; i_r < n_r; ++i_r)
+          {
+            double dm = sources(i_r, i_c) - c(i_r, i_c) * s;
+            for (int k = begin; k < end; ++k)
+            {
+              dm += c(i_r, entries(k)) * values(k);
+            }
+            if constexpr (WithMtr)
+            {
+              dm += sign * mtr(i_r, i_c);
+            }
+            mass(i_r, i_c) += d_t * dm;
+          }
+        });
+  }
+
+  void
+  update_concentration(
+      Kokkos::View<const double**, Kokkos::LayoutLeft, ComputeSpace> mass,
+      Kokkos::View<const double*, ComputeSpace> inv_volumes,
+      const Solver::concentration_view_type& c)
+  {
+    Kokkos::parallel_for(
+        "scalar_device_concentration",
+        Kokkos::MDRangePolicy<
+            ComputeSpace,
+            Kokkos::Rank<2, Kokkos::Iterate::Left, Kokkos::Iterate::Left>>(
+            { 0, 0 }, { mass.extent(0), mass.extent(1) }),
+        KOKKOS_LAMBDA(const int i_r, const int i_c) {
+          c(i_r, i_c) = mass(i_r, i_c) * inv_volumes(i_c);
+        });
+  }
+
+  // Several feeds can target the same compartment
+  void
+  scatter_feed(double d_t,
+               Kokkos::View<const Solver::FeedEntry*, ComputeSpace> feeds,
+               Kokkos::View<double**, Kokkos::LayoutLeft, ComputeSpace> mass)
+  {
+    Kokkos::parallel_for(
+        "scalar_device_feed",
+        Kokkos::RangePolicy<ComputeSpace>(0, feeds.extent(0)),
+        KOKKOS_LAMBDA(const std::size_t i) {
+          const auto feed = feeds(i);
+          Kokkos::atomic_add(&mass(feed.i_r, feed.i_c), d_t * feed.value);
+        });
+  }
+
+} // namespace
+
+namespace Simulation
+{
+
+  DeviceScalarSolver::DeviceScalarSolver(std::size_t n_species,
+                                         std::size_t n_compartments)
+      : n_r(n_species), n_c(n_compartments),
+        row_map("scalar_device_row_map", n_c + 1),
+        mass("scalar_device_mass", n_r, n_c),
+        mtr("scalar_device_mtr", n_r, n_c),
+        inv_volumes("scalar_device_inv_volumes", n_c),
+        sink("scalar_device_sink", n_c),
+        uploaded_sink(vector_type::Zero(EIGEN_INDEX(n_c)))
+  {
+    Kokkos::deep_copy(inv_volumes, 1.);
+  }
+
+  void
+  DeviceScalarSolver::set_transition(const sparse_type& transition)
+  {
+    KOKKOS_ASSERT(transition.isCompressed());
+    KOKKOS_ASSERT(static_cast<std::size_t>(transition.outerSize()) == n_c);
+    const auto nnz = static_cast<std::size_t>(transition.nonZeros());
+    upload(row_map,
+           transition.outerIndexPtr(),
+           n_c + 1,
+           "scalar_device_row_map");
+    upload(entries, transition.innerIndexPtr(), nnz, "scalar_device_entries");
+    upload(values, transition.valuePtr(), nnz, "scalar_device_values");
+  }
+
+  void
+  DeviceScalarSolver::set_inverse_volumes(const vector_type& _inv_volumes)
+  {
+    KOKKOS_ASSERT(static_cast<std::size_t>(_inv_volumes.size()) == n_c);
+    upload(inv_volumes, _inv_volumes.data(), n_c, "scalar_device_inv_volumes");
+  }
+
+  void
+  DeviceScalarSolver::set_sink(const vector_type& _sink)
+  {
+    KOKKOS_ASSERT(static_cast<std::size_t>(_sink.size()) == n_c);
+    // Sink is rebuilt each step from feeds but rarely changes
+    if (_sink == uploaded_sink)
+    {
+      return;
+    }
+    upload(sink, _sink.data(), n_c, "scalar_device_sink");
+    uploaded_sink = _sink;
+  }
+
+  void
+  DeviceScalarSolver::set_mass(const dense_type& _mass)
+  {
+    upload(mass, _mass);
+  }
+
+  void
+  DeviceScalarSolver::get_mass(dense_type& _mass) const
+  {
+    _mass.resize(EIGEN_INDEX(n_r), EIGEN_INDEX(n_c));
+    Kokkos::deep_copy(
+        Kokkos::View<double**,
+                     Kokkos::LayoutLeft,
+                     Kokkos::HostSpace,
+                     Kokkos::MemoryUnmanaged>(_mass.data(), n_r, n_c),
+        mass);
+  }
+
+  void
+  DeviceScalarSolver::add_feed(std::size_t i_r, std::size_t i_c, double val)
+  {
+    KOKKOS_ASSERT(i_r < n_r && i_c < n_c);
+    feeds.push_back({ static_cast<int>(i_r), static_cast<int>(i_c), val });
+  }
+
+  void
+  DeviceScalarSolver::clear_feed() noexcept
+  {
+    feeds.clear();
+  }
+
+  void
+  DeviceScalarSolver::apply_feed(double d_t)
+  {
+    const auto n_feed = feeds.size();
+    if (n_feed == 0)
+    {
+      return;
+    }
+    if (device_feeds.extent(0) < n_feed)
+    {
+      device_feeds = Kokkos::View<FeedEntry*, ComputeSpace>(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                             "scalar_device_feeds"),
+          n_feed);
+    }
+    auto current_feeds = Kokkos::subview(
+        device_feeds, Kokkos::make_pair(std::size_t{ 0 }, n_feed));
+    Kokkos::deep_copy(current_feeds,
+                      unmanaged_host_view<const FeedEntry*>(feeds.data(),
+                                                            n_feed));
+
+    scatter_feed(d_t, current_feeds, mass);
+  }
+
+  void
+  DeviceScalarSolver::step(double d_t,
+                           const concentration_view_type& concentration,
+                           const sources_view_type& sources)
+  {
+    update_mass<false>(d_t,
+                       static_cast<int>(n_r),
+                       row_map,
+                       entries,
+                       values,
+                       sink,
+                       concentration,
+                       sources,
+                       mtr,
+                       0.,
+                       mass);
+    apply_feed(d_t);
+    update_concentration(mass, inv_volumes, concentration);
+  }
+
+  void
+  DeviceScalarSolver::step(double d_t,
+                           const concentration_view_type& concentration,
+                           const sources_view_type& sources,
+                           const dense_type& _mtr,
+                           double sign)
+  {
+    upload(mtr, _mtr);
+    update_mass<true>(d_t,
+                      static_cast<int>(n_r),
+                      row_map,
+                      entries,
+                      values,
+                      sink,
+                      concentration,
+                      sources,
+                      mtr,
+                      sign,
+                      mass);
+    apply_feed(d_t);
+    update_concentration(mass, inv_volumes, concentration);
+  }
+
+  void
+  DeviceScalarSolver::clear_negs(const concentration_view_type& concentration,
+                                 double tolerance)
+  {
+    auto c = concentration;
+    Kokkos::parallel_for(
+        "clear_negs_device",
+        Kokkos::MDRangePolicy<
+            ComputeSpace,
+            Kokkos::Rank<2, Kokkos::Iterate::Left, Kokkos::Iterate::Left>>(
+            { 0, 0 }, { c.extent(0), c.extent(1) }),
+        KOKKOS_LAMBDA(const int i, const int j) {
+          const auto val = c(i, j);
+          if (val < 0. && Kokkos::abs(val) < tolerance)
+          {
+            c(i, j) = 0.;
+          }
+        });
+  }
+
+} // namespace Simulation
@@ -6,7 +6,9 @@ EIGEN_DIAG_PUSH
 EIGEN_DIAG_POP
 
 #include <cassert>
+#include <cstdint>
 #include <common/common.hpp>
+#include <compartment_renumbering.hpp>
 #include <hydro/impl_mass_transfer.hpp>
 #include <memory>
 #include <optional>
@@ -94,6 +96,20 @@ namespace
     }
   };
 
+  // Species without kla have a zero mtr row, fused step skips them
+  void
+  update_transfer_mask(Simulation::MassTransfer::MassTransferProxy& proxy)
+  {
+    const auto nrow = static_cast<std::size_t>(proxy.kla.rows());
+    proxy.transfer_mask.resize(nrow);
+    for (std::size_t i = 0; i < nrow; ++i)
+    {
+      proxy.transfer_mask[i]
+          = static_cast<std::uint8_t>((proxy.kla.row(EIGEN_INDEX(i)) != 0.)
+                                          .any());
+    }
+  }
+
 } // namespace
 
 namespace Simulation::MassTransfer
@@ -118,12 +134,15 @@ namespace Simulation::MassTransfer
     _proxy->Henry(1) = 3.181e-2;
 
     std::visit(FunctorKla{ _proxy, nrow }, _type);
+    _proxy->mtr.setZero();
+    update_transfer_mask(*_proxy);
 
     _proxy->db = 5e-3; // FIXME
   }
 
   void
-  MassTransferModel::update(const CmaUtils::IterationStatePtrType& state)
+  MassTransferModel::update(const CmaUtils::IterationStatePtrType& state,
+                            const CompartmentPermutation* permutation)
   {
     PROFILE_SECTION("gas_liquid_mass_transfer")
     if (gas_scalar == nullptr || _proxy == nullptr)
@@ -132,6 +151,18 @@ namespace Simulation::MassTransfer
                                   "called if gas not intialized");
     }
     std::visit(MtrVisitor{ _proxy, liquid_scalar, gas_scalar, state }, type);
+    if (permutation != nullptr)
+    {
+      // kla is ColMajor: one block of species per compartment
+      const Eigen::ArrayXXd kla = _proxy->kla;
+      const auto size = static_cast<std::size_t>(kla.size());
+      permutation->gather<double>({ kla.data(), size },
+                                  { _proxy->kla.data(), size },
+                                  static_cast<std::size_t>(kla.rows()));
+      // mtr computed by visitor mixed both numberings
+      gas_liquid_mass_transfer();
+    }
+    update_transfer_mask(*_proxy);
   }
 
   void
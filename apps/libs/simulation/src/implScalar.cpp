@@ -10,12 +10,213 @@ EIGEN_DIAG_PUSH
 EIGEN_DIAG_POP
 #include <Kokkos_Core.hpp>
 #include <common/common.hpp>
+#include <common/env_var.hpp>
+#include <compartment_renumbering.hpp>
+#include <cstdint>
+#include <hydro/impl_mass_transfer.hpp>
 #include <scalar_simulation.hpp>
 #include <simulation/simulation_exception.hpp>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <span>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace
 {
+  // constexpr float_type TOL = -1e-8;
+  // order of magniture species to clip
+  constexpr double max_species_value = 5e-3;
+  // O(d_t)=1e-4
+  constexpr double scheme_relative_error = 1e-4;
+
+  constexpr double clear_negs_tolerance
+      = scheme_relative_error * max_species_value;
+
+  /**
+   * @brief Raw host data of one phase for the fused step. LayoutLeft
+   * concentration, ColMajor mass and CSC transition: column j holds all the
+   * species of compartment j and all its inflows.
+   */
+  struct FusedPhase
+  {
+    double* concentration;
+    double* mass;
+    const double* sources; // RowMajor
+    const double* sink;
+    const double* volumes;
+    const double* inv_volumes;
+    const int* outer;
+    const int* inner;
+    const double* values;
+    const int* active;
+    int n_active;
+  };
+
+  /**
+   * @brief Gas-liquid transfer data for the fused step, mode holds one
+   * Simulation::SpeciesIntegration per species
+   */
+  struct FusedTransfer
+  {
+    const double* kla;
+    const double* henry;
+    const std::uint8_t* mode;
+    double* mtr;
+    int n_r;
+    int n_c;
+  };
+
+  KOKKOS_INLINE_FUNCTION bool
+  explicit_transfer(const std::uint8_t mode)
+  {
+    using Simulation::SpeciesIntegration;
+    return mode == static_cast<std::uint8_t>(SpeciesIntegration::Explicit)
+           || mode == static_cast<std::uint8_t>(SpeciesIntegration::SubStep);
+  }
+
+  // dM = C T - C S + Src + sign * mtr, accumulated in column j of mass
+  KOKKOS_INLINE_FUNCTION void
+  fused_phase_mass(const FusedPhase& phase,
+                   const FusedTransfer& t,
+                   const int j,
+                   const double d_t,
+                   const double sign)
+  {
+    const int n_r = t.n_r;
+    const int col = j * n_r;
+    const double s = phase.sink[j];
+    for (int a = 0; a < phase.n_active; ++a)
+    {
+      const int r = phase.active[a];
+      double dm
+          = phase.sources[r * t.n_c + j] - phase.concentration[col + r] * s;
+      if (explicit_transfer(t.mode[r]))
+      {
+        dm += sign * t.mtr[col + r];
+      }
+      phase.mass[col + r] += d_t * dm;
+    }
+
+    // Species inner loop reads contiguous concentration of compartment i
+    for (int k = phase.outer[j]; k < phase.outer[j + 1]; ++k)
+    {
+      const int in_col = phase.inner[k] * n_r;
+      const double w = d_t * phase.values[k];
+      for (int a = 0; a < phase.n_active; ++a)
+      {
+        const int r = phase.active[a];
+        phase.mass[col + r] += w * phase.concentration[in_col + r];
+      }
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION void
+  fused_phase_concentration(const FusedPhase& phase,
+                            const int n_r,
+                            const int j,
+                            const bool clip)
+  {
+    const int col = j * n_r;
+    const double inv_v = phase.inv_volumes[j];
+    for (int a = 0; a < phase.n_active; ++a)
+    {
+      const int r = phase.active[a];
+      double c = phase.mass[col + r] * inv_v;
+      if (clip && c < 0. && Kokkos::abs(c) < clear_negs_tolerance)
+      {
+        c = 0.;
+      }
+      phase.concentration[col + r] = c;
+    }
+  }
+
+  /**
+   * @brief Backward Euler of the exchange between liquid and gas masses of
+   * compartment j, other terms are already in the masses:
+   *   Vl cl = Ml + a (H cg - cl), Vg cg = Mg - a (H cg - cl), a = d_t kla Vl
+   * Total mass Ml + Mg is exactly conserved.
+   */
+  KOKKOS_INLINE_FUNCTION void
+  point_implicit_transfer(const FusedPhase& l,
+                          const FusedPhase& g,
+                          const FusedTransfer& t,
+                          const int j,
+                          const double d_t)
+  {
+    const int col = j * t.n_r;
+    const double vl = l.volumes[j];
+    const double vg = g.volumes[j];
+    for (int a_r = 0; a_r < l.n_active; ++a_r)
+    {
+      const int r = l.active[a_r];
+      if (t.mode[r]
+          != static_cast<std::uint8_t>(
+              Simulation::SpeciesIntegration::PointImplicit))
+      {
+        continue;
+      }
+      const int i = col + r;
+      const double a = d_t * t.kla[i] * vl;
+      const double h = t.henry[r];
+      const double det = vl * vg + a * (h * vl + vg);
+      if (!(a > 0.) || !(det > 0.))
+      {
+        t.mtr[i] = 0.;
+        continue;
+      }
+      const double ml = l.mass[i];
+      const double mg = g.mass[i];
+      const double new_ml = vl * (ml * (vg + a * h) + a * h * mg) / det;
+      t.mtr[i] = (new_ml - ml) / d_t;
+      l.mass[i] = new_ml;
+      g.mass[i] = ml + mg - new_ml;
+    }
+  }
+
+  void
+  run_fused_step(const double d_t,
+                 const FusedPhase& l,
+                 const FusedPhase& g,
+                 const FusedTransfer& t)
+  {
+    const int n_r = t.n_r;
+    // Concentrations are read across compartments by transport, new values
+    // are written once all masses are updated
+    Kokkos::parallel_for(
+        "scalar_fused_mass",
+        Kokkos::RangePolicy<HostSpace>(0, t.n_c),
+        KOKKOS_LAMBDA(const int j) {
+          const int col = j * n_r;
+          const double vl = l.volumes[j];
+          for (int a = 0; a < l.n_active; ++a)
+          {
+            const int r = l.active[a];
+            if (explicit_transfer(t.mode[r]))
+            {
+              const int i = col + r;
+              t.mtr[i] = t.kla[i]
+                         * (t.henry[r] * g.concentration[i]
+                            - l.concentration[i])
+                         * vl;
+            }
+          }
+          fused_phase_mass(l, t, j, d_t, 1.);
+          fused_phase_mass(g, t, j, d_t, -1.);
+          point_implicit_transfer(l, g, t, j, d_t);
+        });
+
+    Kokkos::parallel_for(
+        "scalar_fused_concentration",
+        Kokkos::RangePolicy<HostSpace>(0, t.n_c),
+        KOKKOS_LAMBDA(const int j) {
+          fused_phase_concentration(l, n_r, j, true);
+          fused_phase_concentration(g, n_r, j, false);
+        });
+    Kokkos::fence();
+  }
 
   template <typename ViewType1, typename ViewType2>
     requires(ViewType1::rank() == ViewType2::rank()
@@ -51,89 +252,6 @@ namespace
     }
   }
 
-  // void
-  // sparse_from_coo(Eigen::SparseMatrix<double>& res,
-  //                 const std::size_t n_c,
-  //                 std::span<const size_t>&& rows,
-  //                 std::span<const size_t>&& cols,
-  //                 std::span<const double>&& vals)
-  // {
-  //   KOKKOS_ASSERT(res.cols() == EIGEN_INDEX(n_c));
-  //   using T = Eigen::Triplet<double>;
-  //   const auto n = vals.size();
-  //   KOKKOS_ASSERT(rows.size() == n);
-  //   KOKKOS_ASSERT(cols.size() == n);
-  //   KOKKOS_ASSERT(vals.size() == n);
-  //   std::vector<T> triplets(n);
-
-  //   for (std::size_t i = 0; i < n; i++)
-  //   {
-  //     triplets[i]
-  //         = T(static_cast<int>(rows[i]), static_cast<int>(cols[i]), vals[i]);
-  //   }
-  //   res.setFromTriplets(triplets.begin(), triplets.end());
-  //   res.makeCompressed();
-  // }
-
-#define UNROLL_CHECK(i, s)                                                     \
-  if ((i) < (s))                                                               \
-  {                                                                            \
-    triplets[i] = T(rows[i], cols[i], vals[i]);                                \
-  }
-
-#define UNROLL(idx) triplets[idx] = T(rows[idx], cols[idx], vals[idx]);
-  void
-  sparse_from_coo(Eigen::SparseMatrix<double>& res,
-                  std::size_t n_c,
-                  std::span<const size_t>&& rows,
-                  std::span<const size_t>&& cols,
-                  std::span<const double>&& vals)
-  {
-
-    KOKKOS_ASSERT(res.cols() == EIGEN_INDEX(n_c));
-
-    using T = Eigen::Triplet<double>;
-    const auto n = vals.size();
-    std::vector<T> triplets(n);
-
-    // #pragma omp simd
-    for (std::size_t i = 0; i < n; i += 8)
-    {
-      const std::size_t idx0 = i;
-      const std::size_t idx1 = i + 1;
-      const std::size_t idx2 = i + 2;
-      const std::size_t idx3 = i + 3;
-      const std::size_t idx4 = i + 4;
-      const std::size_t idx5 = i + 5;
-      const std::size_t idx6 = i + 6;
-      const std::size_t idx7 = i + 7;
-
-      if (idx7 < n)
-      {
-        UNROLL(idx0);
-        UNROLL(idx1);
-        UNROLL(idx2);
-        UNROLL(idx3);
-        UNROLL(idx4);
-        UNROLL(idx5);
-        UNROLL(idx6);
-        UNROLL(idx7);
-      }
-      else
-      {
-        UNROLL_CHECK(idx0, n)
-        UNROLL_CHECK(idx1, n)
-        UNROLL_CHECK(idx2, n)
-        UNROLL_CHECK(idx3, n)
-        UNROLL_CHECK(idx4, n)
-        UNROLL_CHECK(idx5, n)
-        UNROLL_CHECK(idx6, n)
-      }
-    }
-    res.setFromTriplets(triplets.begin(), triplets.end());
-    res.makeCompressed();
-  }
-
 } // namespace
 
 namespace Simulation
@@ -145,15 +263,15 @@ namespace Simulation
       : n_r(n_species), n_c(n_compartments), total_mass(n_r, n_c),
         concentrations("concentrations", n_r, n_c),
         sources("sources", n_r, n_c), contribs("contribs", n_r, n_c),
-        m_transition(
-            FlowMatrixType<double>(EIGEN_INDEX(n_c), EIGEN_INDEX(n_c))),
+        transitions(n_c),
         m_volumes(KokkosEigen::Alias::DiagonalType<mass_balance_float_type>(
             EIGEN_INDEX(n_c))),
         volumes_inverse(
             KokkosEigen::Alias::DiagonalType<mass_balance_float_type>(
                 EIGEN_INDEX(n_c))),
         sink(KokkosEigen::Alias::DiagonalType<mass_balance_float_type>(
-            EIGEN_INDEX(n_c)))
+            EIGEN_INDEX(n_c))),
+        species_mask(n_species, 0)
   {
     if (volumes.size() != n_compartments)
     {
@@ -168,6 +286,74 @@ namespace Simulation
     this->total_mass.setZero();
 
     this->sink.setZero();
+
+    set_implicit(Common::read_env_or("BIOMC_SCALAR_IMPLICIT", false));
+    set_device(!is_implicit()
+               && Common::read_env_or("BIOMC_SCALAR_DEVICE", false));
+  }
+
+  void
+  ScalarSimulation::set_implicit(bool enable)
+  {
+    if (enable && !implicit_solver)
+    {
+      set_device(false);
+      implicit_solver = std::make_unique<ImplicitScalarSolver>();
+      implicit_solver->set_flowmap(transitions.current(),
+                                   m_volumes.diagonal());
+    }
+    else if (!enable)
+    {
+      implicit_solver.reset();
+    }
+  }
+
+  bool
+  ScalarSimulation::is_implicit() const noexcept
+  {
+    return implicit_solver != nullptr;
+  }
+
+  void
+  ScalarSimulation::set_device(bool enable)
+  {
+    if (enable && !device_solver)
+    {
+      set_implicit(false);
+      concentrations.sync_device();
+      device_solver = std::make_unique<DeviceScalarSolver>(n_r, n_c);
+      device_solver->set_transition(transitions.current());
+      device_solver->set_inverse_volumes(volumes_inverse.diagonal());
+      device_solver->set_mass(total_mass);
+    }
+    else if (!enable && device_solver)
+    {
+      // Mass and concentration live on device, bring them back
+      device_solver->get_mass(total_mass);
+      concentrations.sync_host();
+      sources.sync_host();
+      device_solver.reset();
+    }
+  }
+
+  bool
+  ScalarSimulation::is_device() const noexcept
+  {
+    return device_solver != nullptr;
+  }
+
+  bool
+  ScalarSimulation::implicit_step(double d_t,
+                                  const Eigen::Ref<const Eigen::MatrixXd>& rhs)
+  {
+    auto& c = concentrations.eigen();
+    if (!implicit_solver->solve(
+            d_t, transitions.current(), sink.diagonal(), rhs, c))
+    {
+      return false;
+    }
+    total_mass.noalias() = c * m_volumes;
+    return true;
   }
 
   // simple getters
@@ -175,6 +361,7 @@ namespace Simulation
   [[nodiscard]] ScalarSimulation::concentration_view_t
   ScalarSimulation::get_concentration() noexcept
   {
+    concentrations.sync_host();
     return concentrations.host_view();
   }
 
@@ -201,7 +388,17 @@ namespace Simulation
                   != 0U);
 
     Kokkos::deep_copy(sources.device_view(), contribs);
-    sources.device_to_host_sync();
+    // Particles may contribute to any species
+    std::ranges::fill(species_mask, 1);
+    if (device_solver)
+    {
+      // Host copy is only needed for MPI reduction, done on demand
+      sources.modify_device();
+    }
+    else
+    {
+      sources.device_to_host_sync();
+    }
   }
 
   [[nodiscard]] MC::KernelConcentrationType
@@ -210,6 +407,46 @@ namespace Simulation
     return concentrations.device_view_cst();
   }
 
+  void
+  ScalarSimulation::alias_concentration(
+      std::span<concentration_float_type> data)
+  {
+    if (data.size() != n_r * n_c)
+    {
+      throw std::invalid_argument(
+          "Aliased concentrations do not match dimensions");
+    }
+    concentrations.alias(data.data());
+    concentration_aliased = true;
+  }
+
+  void
+  ScalarSimulation::own_concentration()
+  {
+    if (concentration_aliased)
+    {
+      concentrations.own("concentrations");
+      concentration_aliased = false;
+    }
+  }
+
+  void
+  ScalarSimulation::restrict_compartments(const std::size_t first,
+                                          const std::size_t end)
+  {
+    if (concentration_aliased)
+    {
+      throw std::logic_error("Aliased concentrations cannot be restricted");
+    }
+    if (first >= end || end > n_c)
+    {
+      throw std::invalid_argument("Compartment range is out of the scalar");
+    }
+    concentrations.keep_columns(first, end, "concentrations");
+    sources.keep_columns(first, end, "sources");
+    contribs = MC::kernelContribution("contribs", n_r, end - first);
+  }
+
   // void
   // ScalarSimulation::reduce_contribs(std::span<const double> data)
   // {
@@ -233,15 +470,29 @@ namespace Simulation
   {
     PROFILE_SECTION("performStep_gl")
 
+    if (device_solver)
+    {
+      device_step(d_t, &mtr, static_cast<double>(sign));
+      return;
+    }
+
     auto& c = concentrations.eigen();
     const auto& _sources = sources.eigen();
 
-    auto dmdt = c * m_transition - c * sink + _sources
-                + static_cast<float>(sign) * mtr;
+    // Transport and sink are implicit, mass transfer and sources explicit
+    if (!implicit_solver
+        || !implicit_step(
+            d_t,
+            total_mass
+                + d_t * (_sources + static_cast<float>(sign) * mtr)))
+    {
+      auto dmdt = c * transitions.current() - c * sink + _sources
+                  + static_cast<float>(sign) * mtr;
 
-    total_mass.noalias() += d_t * dmdt;
+      total_mass.noalias() += d_t * dmdt;
 
-    c.noalias() = total_mass * volumes_inverse;
+      c.noalias() = total_mass * volumes_inverse;
+    }
 
     // Make accessible new computed concentration to ComputeSpace
     concentrations.host_to_device_sync();
@@ -252,29 +503,67 @@ namespace Simulation
   {
     PROFILE_SECTION("performStep_l")
 
+    if (device_solver)
+    {
+      device_step(d_t, nullptr, 0.);
+      return;
+    }
+
     auto& c = concentrations.eigen();
     const auto& _sources = sources.cst_eigen();
-    auto dmdt = c * m_transition - c * sink + _sources;
 
-    total_mass.noalias() += d_t * dmdt;
-    c.noalias() = total_mass * volumes_inverse;
+    if (!implicit_solver
+        || !implicit_step(d_t, total_mass + d_t * _sources))
+    {
+      auto dmdt = c * transitions.current() - c * sink + _sources;
+
+      total_mass.noalias() += d_t * dmdt;
+      c.noalias() = total_mass * volumes_inverse;
+    }
 
     // Make accessible new computed concentration to ComputeSpace
     concentrations.host_to_device_sync();
   }
 
+  void
+  ScalarSimulation::device_step(
+      double d_t,
+      const KokkosEigen::Alias::ColMajorMatrixtype<double>* mtr,
+      double sign)
+  {
+    device_solver->set_sink(sink.diagonal());
+    sources.sync_device();
+    concentrations.sync_device();
+    if (mtr != nullptr)
+    {
+      device_solver->step(d_t,
+                          concentrations.device_view(),
+                          sources.device_view(),
+                          *mtr,
+                          sign);
+    }
+    else
+    {
+      device_solver->step(
+          d_t, concentrations.device_view(), sources.device_view());
+    }
+    // No copy back, host concentration is refreshed when read
+    concentrations.modify_device();
+  }
+
   void
   ScalarSimulation::clearNegs()
   {
 
     using float_type = decltype(concentrations)::float_type;
-    // constexpr float_type TOL = -1e-8;
-    // order of magniture species to clip
-    constexpr float_type max_species_value = 5e-3;
-    // O(d_t)=1e-4
-    constexpr float_type scheme_relative_error = 1e-4;
+    constexpr float_type TOL = clear_negs_tolerance;
 
-    constexpr float_type TOL = scheme_relative_error * max_species_value;
+    if (device_solver)
+    {
+      DeviceScalarSolver::clear_negs(concentrations.device_view(), TOL);
+      concentrations.modify_device();
+      return;
+    }
 
     using space = decltype(concentrations)::host_view_type::execution_space;
     auto hv = concentrations.host_view();
@@ -296,6 +585,161 @@ namespace Simulation
     concentrations.host_to_device_sync();
   }
 
+  double
+  ScalarSimulation::min_residence_time() const
+  {
+    const auto& transition = transitions.current();
+    double tau = std::numeric_limits<double>::infinity();
+    for (std::size_t j = 0; j < n_c; ++j)
+    {
+      const auto jj = EIGEN_INDEX(j);
+      // Diagonal of transition is minus the outflow
+      const double out = sink.diagonal().coeff(jj) - transition.coeff(jj, jj);
+      if (out > 0.)
+      {
+        tau = std::min(tau, m_volumes.diagonal().coeff(jj) / out);
+      }
+    }
+    return tau;
+  }
+
+  std::vector<SpeciesPolicy>
+  ScalarSimulation::species_integration(
+      const ScalarSimulation& gas,
+      const MassTransfer::MassTransferProxy& proxy,
+      double d_t) const
+  {
+    std::vector<SpeciesPolicy> policies(
+        n_r, { SpeciesIntegration::NoTransfer, 1 });
+    std::optional<double> residence_time;
+    for (std::size_t i_r = 0; i_r < n_r; ++i_r)
+    {
+      if (proxy.transfer_mask[i_r] == 0)
+      {
+        continue;
+      }
+      // Rate of dc/dt for the two-compartment exchange
+      const double henry = proxy.Henry(EIGEN_INDEX(i_r));
+      double exchange_rate = 0.;
+      for (std::size_t j = 0; j < n_c; ++j)
+      {
+        const auto jj = EIGEN_INDEX(j);
+        const double kla = proxy.kla(EIGEN_INDEX(i_r), jj);
+        if (kla > 0.)
+        {
+          const double ratio = m_volumes.diagonal().coeff(jj)
+                               * gas.volumes_inverse.diagonal().coeff(jj);
+          exchange_rate = std::max(exchange_rate, kla * (1. + henry * ratio));
+        }
+      }
+      if (!residence_time)
+      {
+        residence_time
+            = std::min(min_residence_time(), gas.min_residence_time());
+      }
+      policies[i_r]
+          = select_species_integration(exchange_rate, *residence_time, d_t);
+    }
+    return policies;
+  }
+
+  bool
+  ScalarSimulation::performStepGLFused(double d_t,
+                                       ScalarSimulation& liquid,
+                                       ScalarSimulation& gas,
+                                       MassTransfer::MassTransferProxy& proxy)
+  {
+    if (liquid.implicit_solver || liquid.device_solver || gas.implicit_solver
+        || gas.device_solver)
+    {
+      return false;
+    }
+    PROFILE_SECTION("performStep_gl_fused")
+
+    KOKKOS_ASSERT(liquid.n_r == gas.n_r && liquid.n_c == gas.n_c);
+    KOKKOS_ASSERT(proxy.transfer_mask.size() == liquid.n_r);
+    const auto n_r = static_cast<int>(liquid.n_r);
+    const auto n_c = static_cast<int>(liquid.n_c);
+
+    const auto modes = liquid.species_integration(gas, proxy, d_t);
+
+    // Rows left out stay zero: only transported, no source nor transfer.
+    // Sub-stepped species are integrated afterwards on their own
+    auto active_species = [&](const ScalarSimulation& scalar)
+    {
+      std::vector<int> active;
+      for (std::size_t i_r = 0; i_r < scalar.n_r; ++i_r)
+      {
+        if ((scalar.species_mask[i_r] != 0 || proxy.transfer_mask[i_r] != 0)
+            && modes[i_r].integration != SpeciesIntegration::SubStep)
+        {
+          active.push_back(static_cast<int>(i_r));
+        }
+      }
+      return active;
+    };
+    const auto liquid_active = active_species(liquid);
+    const auto gas_active = active_species(gas);
+
+    auto make_phase = [](ScalarSimulation& scalar,
+                         const std::vector<int>& active)
+    {
+      const auto& transition = scalar.transitions.current();
+      return FusedPhase{
+        .concentration = scalar.concentrations.eigen().data(),
+        .mass = scalar.total_mass.data(),
+        .sources = scalar.sources.cst_eigen().data(),
+        .sink = scalar.sink.diagonal().data(),
+        .volumes = scalar.m_volumes.diagonal().data(),
+        .inv_volumes = scalar.volumes_inverse.diagonal().data(),
+        .outer = transition.outerIndexPtr(),
+        .inner = transition.innerIndexPtr(),
+        .values = transition.valuePtr(),
+        .active = active.data(),
+        .n_active = static_cast<int>(active.size()),
+      };
+    };
+
+    std::vector<std::uint8_t> mode(liquid.n_r);
+    std::ranges::transform(
+        modes,
+        mode.begin(),
+        [](const SpeciesPolicy& policy)
+        { return static_cast<std::uint8_t>(policy.integration); });
+    const FusedTransfer transfer{ .kla = proxy.kla.data(),
+                                  .henry = proxy.Henry.data(),
+                                  .mode = mode.data(),
+                                  .mtr = proxy.mtr.data(),
+                                  .n_r = n_r,
+                                  .n_c = n_c };
+
+    run_fused_step(d_t,
+                   make_phase(liquid, liquid_active),
+                   make_phase(gas, gas_active),
+                   transfer);
+
+    for (int i_r = 0; i_r < n_r; ++i_r)
+    {
+      const auto& policy = modes[i_r];
+      if (policy.integration != SpeciesIntegration::SubStep)
+      {
+        continue;
+      }
+      const std::vector<int> single = { i_r };
+      const auto l = make_phase(liquid, single);
+      const auto g = make_phase(gas, single);
+      const double sub_d_t = d_t / policy.n_substep;
+      for (int i_step = 0; i_step < policy.n_substep; ++i_step)
+      {
+        run_fused_step(sub_d_t, l, g, transfer);
+      }
+    }
+
+    liquid.concentrations.host_to_device_sync();
+    gas.concentrations.host_to_device_sync();
+    return true;
+  }
+
   bool
   ScalarSimulation::deep_copy_concentration(const std::vector<double>& data)
   {
@@ -307,6 +751,7 @@ namespace Simulation
     Kokkos::View<const double**, view_layout> unmanaged_host_view(
         data.data(), n_r, n_c);
 
+    concentrations.sync_host();
     Kokkos::deep_copy(concentrations.host_view(), unmanaged_host_view);
     concentrations.host_to_device_sync();
 
@@ -316,17 +761,76 @@ namespace Simulation
   void
   ScalarSimulation::set_mass()
   {
+    concentrations.sync_host();
     total_mass = this->concentrations.eigen() * m_volumes;
+    for (std::size_t i_r = 0; i_r < n_r; ++i_r)
+    {
+      if ((total_mass.row(EIGEN_INDEX(i_r)).array() != 0.).any())
+      {
+        species_mask[i_r] = 1;
+      }
+    }
+    if (device_solver)
+    {
+      device_solver->set_mass(total_mass);
+    }
   }
 
   void
   ScalarSimulation::set_transition(CmaUtils::StateCooMatrixType&& transition)
   {
-    sparse_from_coo(this->m_transition,
-                    transition->nrows(),
-                    transition->row_indices(),
-                    transition->col_indices(),
-                    transition->values());
+    KOKKOS_ASSERT(transition->nrows() == n_c);
+    set_transition(transition->row_indices(),
+                   transition->col_indices(),
+                   transition->values());
+  }
+
+  void
+  ScalarSimulation::set_transition(std::span<const std::size_t> rows,
+                                   std::span<const std::size_t> cols,
+                                   std::span<const double> values)
+  {
+    transitions.update(rows, cols, values);
+
+    if (device_solver)
+    {
+      device_solver->set_transition(transitions.current());
+    }
+
+    // Volumes are set before transition during hydro update
+    if (implicit_solver)
+    {
+      implicit_solver->set_flowmap(transitions.current(),
+                                   m_volumes.diagonal());
+    }
+  }
+
+  void
+  ScalarSimulation::renumber(const CompartmentPermutation& permutation)
+  {
+    KOKKOS_ASSERT(permutation.size() == n_c);
+
+    // Aliased concentrations are written in internal numbering by their
+    // owner
+    if (!concentration_aliased)
+    {
+      const auto concentration = std::as_const(*this).getConcentrationData();
+      std::vector<double> buffer(concentration.size());
+      permutation.gather(concentration, std::span<double>(buffer), n_r);
+      deep_copy_concentration(buffer);
+    }
+
+    const Eigen::VectorXd volumes = m_volumes.diagonal();
+    const Eigen::VectorXd inverse = volumes_inverse.diagonal();
+    std::vector<double> new_volumes(n_c);
+    std::vector<double> new_inverse(n_c);
+    permutation.gather<double>(
+        { volumes.data(), n_c }, std::span<double>(new_volumes), 1);
+    permutation.gather<double>(
+        { inverse.data(), n_c }, std::span<double>(new_inverse), 1);
+    setVolumes(new_volumes, new_inverse);
+
+    set_mass();
   }
 
 } // namespace Simulation
@@ -0,0 +1,137 @@
+#include <Kokkos_Assert.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <implicit_scalar_solver.hpp>
+#include <memory>
+#include <utility>
+
+namespace
+{
+  // FNV-1a, only used to identify flowmaps, not for security
+  constexpr uint64_t fnv_offset = 14695981039346656037ULL;
+  constexpr uint64_t fnv_prime = 1099511628211ULL;
+
+  template <typename T>
+  uint64_t
+  hash_combine(uint64_t seed, const T* data, std::size_t n)
+  {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data); // NOLINT
+    for (std::size_t i = 0; i < n * sizeof(T); ++i)
+    {
+      seed ^= bytes[i];
+      seed *= fnv_prime;
+    }
+    return seed;
+  }
+
+} // namespace
+
+namespace Simulation
+{
+
+  ImplicitScalarSolver::ImplicitScalarSolver(std::size_t _max_cached) noexcept
+      : max_cached(_max_cached)
+  {
+  }
+
+  void
+  ImplicitScalarSolver::set_flowmap(const sparse_type& transition,
+                                    const vector_type& _volumes)
+  {
+    KOKKOS_ASSERT(transition.isCompressed());
+    const auto n = static_cast<std::size_t>(transition.outerSize());
+    const auto nnz = static_cast<std::size_t>(transition.nonZeros());
+
+    uint64_t key = fnv_offset;
+    key = hash_combine(key, transition.outerIndexPtr(), n + 1);
+    key = hash_combine(key, transition.innerIndexPtr(), nnz);
+    key = hash_combine(key, transition.valuePtr(), nnz);
+    key = hash_combine(
+        key, _volumes.data(), static_cast<std::size_t>(_volumes.size()));
+
+    flowmap_key = key;
+    volumes = _volumes;
+  }
+
+  std::unique_ptr<ImplicitScalarSolver::lu_type>
+  ImplicitScalarSolver::factorize(const double d_t,
+                                  const sparse_type& transition,
+                                  const vector_type& sink) const
+  {
+    // A^T = V + d_t*S - d_t*T^T
+    const auto n = transition.rows();
+    sparse_type diag(n, n);
+    diag.setIdentity();
+    diag.diagonal() = volumes + d_t * sink;
+
+    sparse_type a_t = diag - d_t * sparse_type(transition.transpose());
+    a_t.makeCompressed();
+
+    auto lu = std::make_unique<lu_type>();
+    lu->compute(a_t);
+    if (lu->info() != Eigen::Success)
+    {
+      return nullptr;
+    }
+    return lu;
+  }
+
+  bool
+  ImplicitScalarSolver::solve(const double d_t,
+                              const sparse_type& transition,
+                              const vector_type& sink,
+                              const Eigen::Ref<const dense_type>& rhs,
+                              Eigen::Ref<dense_type> concentration)
+  {
+    // Factorizations are only valid for one time step
+    if (d_t != cached_d_t)
+    {
+      clear();
+      cached_d_t = d_t;
+    }
+
+    // Sink is usually constant but is rebuilt each step from feeds
+    const uint64_t key = hash_combine(
+        flowmap_key, sink.data(), static_cast<std::size_t>(sink.size()));
+
+    auto it = cache.find(key);
+    if (it == cache.end())
+    {
+      auto lu = factorize(d_t, transition, sink);
+      if (!lu)
+      {
+        return false;
+      }
+      ++factorization_counter;
+      if (cache.size() >= max_cached)
+      {
+        cache.clear();
+      }
+      it = cache.emplace(key, std::move(lu)).first;
+    }
+
+    // One solve per species (columns of rhs^T)
+    const dense_type solution = it->second->solve(rhs.transpose());
+    concentration = solution.transpose();
+    return true;
+  }
+
+  std::size_t
+  ImplicitScalarSolver::n_factorization() const noexcept
+  {
+    return factorization_counter;
+  }
+
+  std::size_t
+  ImplicitScalarSolver::n_cached() const noexcept
+  {
+    return cache.size();
+  }
+
+  void
+  ImplicitScalarSolver::clear() noexcept
+  {
+    cache.clear();
+  }
+
+} // namespace Simulation
@@ -0,0 +1,45 @@
+#include <cmath>
+#include <scalar_integration_policy.hpp>
+
+namespace
+{
+  // Explicit Euler of dc/dt = -lambda c is stable and non oscillating for
+  // lambda * d_t < 1, keep a margin
+  constexpr double explicit_margin = 0.5;
+
+  // Point-implicit is accurate when exchange is much faster than transport
+  constexpr double equilibrium_ratio = 10.;
+
+  constexpr int max_substep = 16;
+} // namespace
+
+namespace Simulation
+{
+
+  SpeciesPolicy
+  select_species_integration(double exchange_rate,
+                             double residence_time,
+                             double d_t) noexcept
+  {
+    if (!(exchange_rate > 0.))
+    {
+      return { SpeciesIntegration::NoTransfer, 1 };
+    }
+
+    const double stiffness = exchange_rate * d_t;
+    if (stiffness <= explicit_margin)
+    {
+      return { SpeciesIntegration::Explicit, 1 };
+    }
+
+    const double n_substep = std::ceil(stiffness / explicit_margin);
+    if (n_substep > max_substep
+        || exchange_rate * residence_time >= equilibrium_ratio)
+    {
+      return { SpeciesIntegration::PointImplicit, 1 };
+    }
+
+    return { SpeciesIntegration::SubStep, static_cast<int>(n_substep) };
+  }
+
+} // namespace Simulation
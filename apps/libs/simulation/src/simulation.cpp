@@ -2,6 +2,8 @@
 #include <Kokkos_ScatterView.hpp>
 #include <cma_utils/alias.hpp>
 #include <common/common.hpp>
+#include <common/env_var.hpp>
+#include <compartment_renumbering.hpp>
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
@@ -22,7 +24,30 @@
 #include <simulation/scalar_initializer.hpp>
 #include <simulation/simulation.hpp>
 #include <simulation/simulation_exception.hpp>
+#include <span>
+#include <string>
 #include <utility>
+#include <vector>
+
+namespace
+{
+  void
+  set_scalar_hydro(Simulation::HydroRenumbering& r,
+                   Simulation::ScalarSimulation& scalar,
+                   std::span<const double> volumes,
+                   std::span<const double> inverse_volumes,
+                   CmaUtils::StateCooMatrixType&& transition)
+  {
+    scalar.setVolumes(r.to_internal(volumes, r.buffer_volumes),
+                      r.to_internal(inverse_volumes, r.buffer_inverse_volumes));
+    // Flowmap pattern is relabeled, values keep their COO position
+    scalar.set_transition(
+        r.indices_to_internal(transition->row_indices(), r.buffer_rows),
+        r.indices_to_internal(transition->col_indices(), r.buffer_cols),
+        transition->values());
+  }
+} // namespace
+
 namespace Simulation
 {
 
@@ -38,7 +63,10 @@ namespace Simulation
         f_reaction(other.f_reaction),
         liquid_scalar(std::move(other.liquid_scalar)),
         gas_scalar(std::move(other.gas_scalar)),
-        mt_model(std::move(other.mt_model)), logger(std::move(other.logger))
+        mt_model(std::move(other.mt_model)), logger(std::move(other.logger)),
+        diagnostic_reporter(std::move(other.diagnostic_reporter)),
+        renumbering(std::move(other.renumbering)),
+        renumbering_pending(other.renumbering_pending)
 
   {
   }
@@ -51,6 +79,13 @@ namespace Simulation
         m_feed(_feed.value_or(Feed::SimulationFeed::empty())),
         is_two_phase_flow(scalar_init.gas_flow)
   {
+    // Restored particles already use the saved numbering. Domain
+    // decomposition cuts the internal numbering in contiguous ranges, which
+    // needs a small bandwidth
+    renumbering_pending
+        = Common::read_env_or("BIOMC_RENUMBER_COMPARTMENTS", false)
+          || Common::read_env_or("BIOMC_DOMAIN_DECOMPOSITION", false)
+          || !mc_unit->domain.renumbering().empty();
 
     this->liquid_scalar = std::make_shared<ScalarSimulation>(
         mc_unit->domain.getNumberCompartments(),
@@ -111,13 +146,116 @@ namespace Simulation
   SimulationUnit::updateMCHydro(std::span<const double> newliquid_volume,
                                 std::span<const std::size_t> neighors_flat,
                                 std::span<const double> proba_flat,
-                                std::span<const double> out_flows) const
+                                std::span<const double> out_flows)
   {
     PROFILE_SECTION("simulation::updateMCHydro")
+    if (renumbering_pending) [[unlikely]]
+    {
+      init_renumbering(neighors_flat);
+    }
+
+    if (renumbering)
+    {
+      auto& r = *renumbering;
+      const auto n_neighbors = neighors_flat.size() / r.permutation.size();
+      this->mc_unit->domain.update(
+          r.to_internal(newliquid_volume, r.buffer_volumes),
+          r.neighbors_to_internal(neighors_flat),
+          r.to_internal(out_flows, r.buffer_out_flows),
+          r.to_internal(proba_flat, r.buffer_probabilities, n_neighbors));
+      return;
+    }
+
     this->mc_unit->domain.update(
         newliquid_volume, neighors_flat, out_flows, proba_flat);
   }
 
+  void
+  SimulationUnit::alias_concentration(std::span<double> values)
+  {
+    liquid_scalar->alias_concentration(values);
+  }
+
+  void
+  SimulationUnit::share_domain_tables(std::span<std::byte> memory,
+                                      std::size_t n_neighbors,
+                                      bool writer)
+  {
+    mc_unit->domain.share_tables(memory, n_neighbors, writer);
+  }
+
+  void
+  SimulationUnit::own_shared_memory()
+  {
+    liquid_scalar->own_concentration();
+    mc_unit->domain.own_tables();
+  }
+
+  void
+  SimulationUnit::restrict_compartments(const std::size_t first,
+                                        const std::size_t end,
+                                        const bool local_scalars)
+  {
+    mc_unit->domain.restrict_tables(first, end);
+    if (local_scalars)
+    {
+      liquid_scalar->restrict_compartments(first, end);
+      contribs_scatter = Kokkos::Experimental::create_scatter_view(
+          get_kernel_contribution());
+    }
+  }
+
+  void
+  SimulationUnit::init_renumbering(std::span<const std::size_t> neighors_flat)
+  {
+    renumbering_pending = false;
+    auto& domain = mc_unit->domain;
+    const auto n_compartments = domain.getNumberCompartments();
+
+    std::optional<CompartmentPermutation> permutation;
+    if (!domain.renumbering().empty())
+    {
+      const auto saved = domain.renumbering();
+      permutation.emplace(std::vector<std::size_t>(saved.begin(), saved.end()));
+    }
+    else
+    {
+      auto rcm = CompartmentPermutation::reverse_cuthill_mckee(n_compartments,
+                                                               neighors_flat);
+      const auto before = CompartmentPermutation::identity(n_compartments)
+                              .bandwidth(neighors_flat);
+      const auto after = rcm.bandwidth(neighors_flat);
+      if (logger)
+      {
+        logger->print("Renumbering",
+                      IO::format("compartment bandwidth ",
+                                 std::to_string(before),
+                                 " -> ",
+                                 std::to_string(after)));
+      }
+      if (after >= before)
+      {
+        return;
+      }
+      mc_unit->renumber_compartments(rcm.new_to_old());
+      permutation.emplace(std::move(rcm));
+    }
+
+    liquid_scalar->renumber(*permutation);
+    if (gas_scalar)
+    {
+      gas_scalar->renumber(*permutation);
+    }
+    renumbering = std::make_unique<HydroRenumbering>(std::move(*permutation));
+  }
+
+  std::size_t
+  SimulationUnit::internal_compartment(std::size_t flowmap_index) const noexcept
+  {
+    return renumbering ? renumbering->permutation.to_new(flowmap_index)
+                       : flowmap_index;
+  }
+
   void
   SimulationUnit::updateScalarHydro(
       const CmaUtils::IterationStatePtrType& newstate)
@@ -127,15 +265,39 @@ namespace Simulation
     {
       const auto& liq = newstate->get_liquid();
       std::span<double const> vl = liq->volume();
-      this->liquid_scalar->setVolumes(vl, liq->inverse_volume());
-      this->liquid_scalar->set_transition(newstate->get_liquid()->transition());
+      if (renumbering)
+      {
+        set_scalar_hydro(*renumbering,
+                         *liquid_scalar,
+                         vl,
+                         liq->inverse_volume(),
+                         newstate->get_liquid()->transition());
+      }
+      else
+      {
+        this->liquid_scalar->setVolumes(vl, liq->inverse_volume());
+        this->liquid_scalar->set_transition(
+            newstate->get_liquid()->transition());
+      }
     }
     if (newstate->has_gas() && gas_scalar)
     {
       const auto& gas = newstate->get_gas();
-      this->gas_scalar->setVolumes(gas->volume(), gas->inverse_volume());
-      gas_scalar->set_transition(newstate->get_gas()->transition());
-      mt_model.update(newstate);
+      if (renumbering)
+      {
+        set_scalar_hydro(*renumbering,
+                         *gas_scalar,
+                         gas->volume(),
+                         gas->inverse_volume(),
+                         newstate->get_gas()->transition());
+      }
+      else
+      {
+        this->gas_scalar->setVolumes(gas->volume(), gas->inverse_volume());
+        gas_scalar->set_transition(newstate->get_gas()->transition());
+      }
+      mt_model.update(newstate,
+                      renumbering ? &renumbering->permutation : nullptr);
     }
   }
 
@@ -1,6 +1,7 @@
 #include <Kokkos_Core.hpp>
 #include <cassert>
 #include <common/common.hpp>
+#include <compartment_renumbering.hpp>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -16,6 +17,7 @@
 #include <simulation/simulation_getter.hpp>
 #include <simulation/simulation_times.hpp>
 #include <stdexcept>
+#include <utility>
 
 namespace Simulation
 {
@@ -90,11 +92,21 @@ namespace Simulation
 
   // Wrapper getter
 
+  // Exported data is given in flowmap numbering, ColMajor (species x
+  // compartments) matrices are moved by blocks of n_species
+
   std::span<const double>
   Getter::getCliqData() const
   {
     assert(a_ != nullptr);
-    return a_->liquid_scalar->getConcentrationData();
+    const auto& scalar = std::as_const(*a_->liquid_scalar);
+    if (a_->renumbering)
+    {
+      const auto& r = *a_->renumbering;
+      return r.to_flowmap(
+          scalar.getConcentrationData(), r.export_liquid, scalar.n_row());
+    }
+    return scalar.getConcentrationData();
   }
 
   [[nodiscard]] std::span<double>
@@ -112,7 +124,14 @@ namespace Simulation
     {
       return std::nullopt;
     }
-    return a_->gas_scalar->getConcentrationData();
+    const auto& scalar = std::as_const(*a_->gas_scalar);
+    if (a_->renumbering)
+    {
+      const auto& r = *a_->renumbering;
+      return r.to_flowmap(
+          scalar.getConcentrationData(), r.export_gas, scalar.n_row());
+    }
+    return scalar.getConcentrationData();
   }
 
   std::span<const double>
@@ -126,7 +145,13 @@ namespace Simulation
   Getter::getMTRData() const
   {
     assert(a_ != nullptr);
-    return a_->mt_model.mtr_data();
+    const auto mtr = a_->mt_model.mtr_data();
+    if (mtr && a_->renumbering)
+    {
+      const auto& r = *a_->renumbering;
+      return r.to_flowmap(*mtr, r.export_mtr, a_->liquid_scalar->n_row());
+    }
+    return mtr;
   }
 
   std::span<double>
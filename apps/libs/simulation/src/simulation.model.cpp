@@ -51,18 +51,22 @@ namespace Simulation
 
   namespace
   {
+    // Positions are internal compartment indices
     void
-    set_scalar_feed(ScalarSimulation& scl, const Feed::FeedDescriptor& fd)
+    set_scalar_feed(ScalarSimulation& scl,
+                    const Feed::FeedDescriptor& fd,
+                    std::size_t input_position,
+                    std::optional<std::size_t> output_position)
     {
 
       // Set for each scalar, i.e for each line of the sytem, F=C_feed*Q
       for (auto [concentration, index] : fd.values)
       {
-        scl.set_feed(index, fd.input_position, fd.flow * concentration);
+        scl.set_feed(index, input_position, fd.flow * concentration);
       }
-      if (fd.output_position)
+      if (output_position)
       {
-        scl.set_sink(*fd.output_position, fd.flow);
+        scl.set_sink(*output_position, fd.flow);
       }
     }
 
@@ -77,15 +81,23 @@ namespace Simulation
     const auto rel_t = this->accesor.relative_time();
     const auto abs_t = this->accesor.absolute_time();
 
-    auto update_feed_scalar =
-        [rel_t, abs_t, d_t, update_scalar](auto& scl, Feed::FeedDescriptor& fd)
+    auto update_feed_scalar = [this, rel_t, abs_t, d_t, update_scalar](
+                                  auto& scl, Feed::FeedDescriptor& fd)
     {
       const auto time = fd.use_relative_time ? rel_t : abs_t;
       KOKKOS_ASSERT(time >= 0);
       fd.update(time, d_t);
       if (update_scalar)
       {
-        set_scalar_feed(scl, fd);
+        std::optional<std::size_t> output_position;
+        if (fd.output_position)
+        {
+          output_position = internal_compartment(*fd.output_position);
+        }
+        set_scalar_feed(scl,
+                        fd,
+                        internal_compartment(fd.input_position),
+                        output_position);
       }
     };
 
@@ -101,7 +113,8 @@ namespace Simulation
           // MC update
           if (feed.output_position.has_value())
           {
-            const std::size_t output_position = *feed.output_position;
+            const std::size_t output_position
+                = internal_compartment(*feed.output_position);
             const auto volume = liquid_scalar.volume_at(output_position);
             KOKKOS_ASSERT(volume > 0.);
             this->mc_unit->domain.set_leaving_flow(
@@ -134,6 +147,12 @@ namespace Simulation
 
     if (is_two_phase_flow)
     {
+      if (ScalarSimulation::performStepGLFused(
+              d_t, *this->liquid_scalar, *this->gas_scalar, *mt_model.proxy()))
+      {
+        return;
+      }
+
       mt_model.gas_liquid_mass_transfer();
       const auto& mtr = mt_model.proxy()->mtr;
 
@@ -0,0 +1,112 @@
+#include <Kokkos_Assert.hpp>
+#include <algorithm>
+#include <common/common.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <transition_cache.hpp>
+#include <vector>
+
+namespace
+{
+  constexpr uint64_t fnv_offset = 14695981039346656037ULL;
+  constexpr uint64_t fnv_prime = 1099511628211ULL;
+
+  uint64_t
+  pattern_key(std::span<const std::size_t> rows,
+              std::span<const std::size_t> cols)
+  {
+    uint64_t key = fnv_offset;
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+      key = (key ^ rows[i]) * fnv_prime;
+      key = (key ^ cols[i]) * fnv_prime;
+    }
+    return key;
+  }
+
+} // namespace
+
+namespace Simulation
+{
+
+  TransitionCache::TransitionCache(std::size_t n_compartment)
+      : n_c(n_compartment), empty(EIGEN_INDEX(n_c), EIGEN_INDEX(n_c)),
+        m_current(&empty)
+  {
+  }
+
+  void
+  TransitionCache::build(Entry& entry, std::span<const double> vals) const
+  {
+    using T = Eigen::Triplet<double>;
+    const auto n = vals.size();
+    std::vector<T> triplets(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      triplets[i] = T(EIGEN_INDEX(entry.rows[i]),
+                      EIGEN_INDEX(entry.cols[i]),
+                      vals[i]);
+    }
+
+    entry.matrix = sparse_type(EIGEN_INDEX(n_c), EIGEN_INDEX(n_c));
+    entry.matrix.setFromTriplets(triplets.begin(), triplets.end());
+    entry.matrix.makeCompressed();
+
+    // ColMajor: outer is column, inner indices are sorted rows
+    const auto* outer = entry.matrix.outerIndexPtr();
+    const auto* inner = entry.matrix.innerIndexPtr();
+    entry.permutation.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const auto col = EIGEN_INDEX(entry.cols[i]);
+      const auto* first = inner + outer[col];
+      const auto* last = inner + outer[col + 1];
+      const auto* it = std::lower_bound(first, last, EIGEN_INDEX(entry.rows[i]));
+      KOKKOS_ASSERT(it != last);
+      entry.permutation[i] = static_cast<std::size_t>(it - inner);
+    }
+  }
+
+  const TransitionCache::sparse_type&
+  TransitionCache::update(std::span<const std::size_t> rows,
+                          std::span<const std::size_t> cols,
+                          std::span<const double> vals)
+  {
+    KOKKOS_ASSERT(rows.size() == vals.size() && cols.size() == vals.size());
+
+    const auto key = pattern_key(rows, cols);
+    auto it = entries.find(key);
+
+    const bool same_pattern = it != entries.end()
+                              && std::ranges::equal(it->second.rows, rows)
+                              && std::ranges::equal(it->second.cols, cols);
+
+    if (!same_pattern)
+    {
+      Entry entry{ .rows = { rows.begin(), rows.end() },
+                   .cols = { cols.begin(), cols.end() },
+                   .permutation = {},
+                   .matrix = {} };
+      build(entry, vals);
+      ++build_counter;
+      it = entries.insert_or_assign(key, std::move(entry)).first;
+    }
+    else
+    {
+      // Duplicates in COO are summed like setFromTriplets does
+      auto& matrix = it->second.matrix;
+      const auto& permutation = it->second.permutation;
+      double* values = matrix.valuePtr();
+      std::fill_n(values, matrix.nonZeros(), 0.);
+      for (std::size_t i = 0; i < vals.size(); ++i)
+      {
+        values[permutation[i]] += vals[i];
+      }
+    }
+
+    m_current = &it->second.matrix;
+    return *m_current;
+  }
+
+} // namespace Simulation
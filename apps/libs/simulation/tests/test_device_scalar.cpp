@@ -0,0 +1,127 @@
+#include <Kokkos_Assert.hpp>
+#include <Kokkos_Core.hpp>
+#include <cmath>
+#include <cstddef>
+#include <device_scalar_solver.hpp>
+#include <vector>
+
+using Solver = Simulation::DeviceScalarSolver;
+
+namespace
+{
+  // Closed loop 0->1->...->0 with flow q, diagonal is minus the outflow
+  Solver::sparse_type
+  loop_transition(std::size_t n, double q)
+  {
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const auto ii = static_cast<int>(i);
+      triplets.emplace_back(ii, ii, -q);
+      triplets.emplace_back(ii, static_cast<int>((i + 1) % n), q);
+    }
+    Solver::sparse_type t(static_cast<int>(n), static_cast<int>(n));
+    t.setFromTriplets(triplets.begin(), triplets.end());
+    t.makeCompressed();
+    return t;
+  }
+} // namespace
+
+// Same step as the host Eigen path of ScalarSimulation
+void
+test_match_host()
+{
+  constexpr std::size_t n_c = 5;
+  constexpr std::size_t n_r = 2;
+  constexpr double d_t = 0.01;
+  constexpr double sign = -1.;
+
+  const auto t = loop_transition(n_c, 2.);
+  const Solver::vector_type volumes
+      = Solver::vector_type::LinSpaced(n_c, 1., 2.);
+  const Solver::vector_type inv_volumes = volumes.cwiseInverse();
+  Solver::vector_type sink = Solver::vector_type::Zero(n_c);
+  sink(4) = 0.5;
+
+  Solver::dense_type c = Solver::dense_type::Random(n_r, n_c).cwiseAbs();
+  Solver::dense_type mass = c * volumes.asDiagonal();
+  const Solver::dense_type sources
+      = Solver::dense_type::Constant(n_r, n_c, 0.1);
+  const Solver::dense_type mtr = Solver::dense_type::Constant(n_r, n_c, 0.2);
+  Solver::dense_type feed = Solver::dense_type::Zero(n_r, n_c);
+  feed(1, 0) = 3.;
+
+  Solver solver(n_r, n_c);
+  solver.set_transition(t);
+  solver.set_inverse_volumes(inv_volumes);
+  solver.set_sink(sink);
+  solver.set_mass(mass);
+
+  Solver::concentration_view_type device_c("c", n_r, n_c);
+  Kokkos::View<double**, Kokkos::LayoutRight, ComputeSpace> device_sources(
+      "sources", n_r, n_c);
+  Kokkos::deep_copy(device_sources, 0.1);
+  auto host_c = Kokkos::create_mirror_view(device_c);
+  for (std::size_t i = 0; i < n_r; ++i)
+  {
+    for (std::size_t j = 0; j < n_c; ++j)
+    {
+      host_c(i, j) = c(static_cast<int>(i), static_cast<int>(j));
+    }
+  }
+  Kokkos::deep_copy(device_c, host_c);
+
+  for (int step = 0; step < 10; ++step)
+  {
+    // Feeds are cleared with contributions every step
+    solver.clear_feed();
+    solver.add_feed(1, 0, 2.);
+    solver.add_feed(1, 0, 1.);
+
+    const Solver::dense_type dmdt
+        = c * t - c * sink.asDiagonal() + sources + feed + sign * mtr;
+    mass += d_t * dmdt;
+    c = mass * inv_volumes.asDiagonal();
+
+    solver.step(d_t, device_c, device_sources, mtr, sign);
+  }
+
+  Kokkos::deep_copy(host_c, device_c);
+  Solver::dense_type device_mass;
+  solver.get_mass(device_mass);
+  for (std::size_t i = 0; i < n_r; ++i)
+  {
+    for (std::size_t j = 0; j < n_c; ++j)
+    {
+      const auto ii = static_cast<int>(i);
+      const auto jj = static_cast<int>(j);
+      KOKKOS_ASSERT(std::abs(host_c(i, j) - c(ii, jj)) < 1e-12);
+      KOKKOS_ASSERT(std::abs(device_mass(ii, jj) - mass(ii, jj)) < 1e-12);
+    }
+  }
+}
+
+void
+test_clear_negs()
+{
+  Solver::concentration_view_type device_c("c", 1, 3);
+  auto host_c = Kokkos::create_mirror_view(device_c);
+  host_c(0, 0) = -1e-9;
+  host_c(0, 1) = -1.;
+  host_c(0, 2) = 1.;
+  Kokkos::deep_copy(device_c, host_c);
+
+  Solver::clear_negs(device_c, 1e-7);
+  Kokkos::deep_copy(host_c, device_c);
+  KOKKOS_ASSERT(host_c(0, 0) == 0.);
+  KOKKOS_ASSERT(host_c(0, 1) == -1.);
+  KOKKOS_ASSERT(host_c(0, 2) == 1.);
+}
+
+int
+main()
+{
+  Kokkos::ScopeGuard guard;
+  test_match_host();
+  test_clear_negs();
+}
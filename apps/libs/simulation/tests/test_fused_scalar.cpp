@@ -0,0 +1,195 @@
+#include <Kokkos_Assert.hpp>
+#include <Kokkos_Core.hpp>
+#include <cmath>
+#include <cstddef>
+#include <hydro/impl_mass_transfer.hpp>
+#include <memory>
+#include <scalar_simulation.hpp>
+#include <simulation/mass_transfer.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+
+using Simulation::ScalarSimulation;
+
+namespace
+{
+  constexpr std::size_t n_c = 4;
+  constexpr std::size_t n_r = 3;
+
+  struct Phases
+  {
+    std::unique_ptr<ScalarSimulation> liquid;
+    std::unique_ptr<ScalarSimulation> gas;
+  };
+
+  Phases
+  make_phases()
+  {
+    std::vector<double> vl = { 1., 2., 1.5, 0.5 };
+    std::vector<double> vg = { 0.1, 0.2, 0.1, 0.3 };
+    std::vector<double> inv_vl(n_c);
+    std::vector<double> inv_vg(n_c);
+    for (std::size_t i = 0; i < n_c; ++i)
+    {
+      inv_vl[i] = 1. / vl[i];
+      inv_vg[i] = 1. / vg[i];
+    }
+
+    Phases p{ std::make_unique<ScalarSimulation>(n_c, n_r, vl),
+              std::make_unique<ScalarSimulation>(n_c, n_r, vg) };
+    p.liquid->setVolumes(vl, inv_vl);
+    p.gas->setVolumes(vg, inv_vg);
+
+    // LayoutLeft: species are contiguous for each compartment
+    std::vector<double> cl(n_r * n_c, 0.);
+    std::vector<double> cg(n_r * n_c, 0.);
+    for (std::size_t j = 0; j < n_c; ++j)
+    {
+      cl[j * n_r] = 1. + static_cast<double>(j);
+      cl[j * n_r + 1] = 1e-3;
+      cg[j * n_r + 1] = 0.3;
+    }
+    KOKKOS_ASSERT(p.liquid->deep_copy_concentration(cl));
+    KOKKOS_ASSERT(p.gas->deep_copy_concentration(cg));
+    p.liquid->set_mass();
+    p.gas->set_mass();
+
+    p.liquid->set_zero_contribs();
+    p.gas->set_zero_contribs();
+    p.liquid->set_feed(0, 0, 0.5);
+    p.liquid->set_sink(3, 0.2);
+    p.gas->set_feed(1, 0, 0.1);
+    p.gas->set_sink(2, 0.05);
+    return p;
+  }
+
+  Simulation::MassTransfer::MassTransferProxy
+  make_proxy()
+  {
+    Simulation::MassTransfer::MassTransferProxy proxy;
+    proxy.kla = Eigen::ArrayXXd::Zero(n_r, n_c);
+    proxy.kla.row(1).setConstant(10.);
+    proxy.Henry = Eigen::ArrayXd::Zero(n_r);
+    proxy.Henry(1) = 3.181e-2;
+    proxy.mtr = Eigen::MatrixXd::Zero(n_r, n_c);
+    proxy.transfer_mask = { 0, 1, 0 };
+    proxy.db = 5e-3;
+    return proxy;
+  }
+} // namespace
+
+void
+test_fused_matches_unfused()
+{
+  constexpr double d_t = 1e-3;
+  auto ref = make_phases();
+  auto fused = make_phases();
+  auto ref_proxy = make_proxy();
+  auto fused_proxy = make_proxy();
+
+  // Species 0 and 2 have no gas concentration, feed nor transfer
+  KOKKOS_ASSERT(!fused.gas->is_species_active(0));
+  KOKKOS_ASSERT(fused.gas->is_species_active(1));
+  KOKKOS_ASSERT(!fused.gas->is_species_active(2));
+
+  for (int step = 0; step < 5; ++step)
+  {
+    const auto cl = ref.liquid->getConcentrationArray();
+    const auto cg = ref.gas->getConcentrationArray();
+    ref_proxy.mtr
+        = (ref_proxy.kla * (cg.colwise() * ref_proxy.Henry - cl)).matrix()
+          * ref.liquid->getVolume();
+    ref.gas->performStepGL(
+        d_t, ref_proxy.mtr, Simulation::MassTransfer::Sign::GasToLiquid);
+    ref.liquid->performStepGL(
+        d_t, ref_proxy.mtr, Simulation::MassTransfer::Sign::LiquidToGas);
+    ref.liquid->clearNegs();
+
+    KOKKOS_ASSERT(ScalarSimulation::performStepGLFused(
+        d_t, *fused.liquid, *fused.gas, fused_proxy));
+  }
+
+  auto check = [](std::span<const double> a, std::span<const double> b)
+  {
+    KOKKOS_ASSERT(a.size() == b.size());
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+      KOKKOS_ASSERT(std::abs(a[i] - b[i]) < 1e-12);
+    }
+  };
+  check(std::as_const(*ref.liquid).getConcentrationData(),
+        std::as_const(*fused.liquid).getConcentrationData());
+  check(std::as_const(*ref.gas).getConcentrationData(),
+        std::as_const(*fused.gas).getConcentrationData());
+  check({ ref_proxy.mtr.data(), n_r * n_c },
+        { fused_proxy.mtr.data(), n_r * n_c });
+}
+
+void
+test_stiff_transfer()
+{
+  // kla * d_t = 1e4: explicit transfer would diverge
+  constexpr double d_t = 1.;
+  auto p = make_phases();
+  auto proxy = make_proxy();
+  proxy.kla.row(1).setConstant(1e4);
+
+  for (int step = 0; step < 20; ++step)
+  {
+    KOKKOS_ASSERT(
+        ScalarSimulation::performStepGLFused(d_t, *p.liquid, *p.gas, proxy));
+  }
+
+  const auto cl = p.liquid->getConcentrationArray();
+  const auto cg = p.gas->getConcentrationArray();
+  for (std::size_t j = 0; j < n_c; ++j)
+  {
+    const auto jj = static_cast<int>(j);
+    KOKKOS_ASSERT(std::isfinite(cl(1, jj)) && cl(1, jj) >= 0.);
+    KOKKOS_ASSERT(std::isfinite(cg(1, jj)) && cg(1, jj) >= 0.);
+    // Exchange is at equilibrium within a step: cl = H * cg
+    const double eq = proxy.Henry(1) * cg(1, jj);
+    KOKKOS_ASSERT(std::abs(cl(1, jj) - eq) <= 1e-3 * std::abs(eq));
+  }
+}
+
+void
+test_policy()
+{
+  using Simulation::SpeciesIntegration;
+  using Simulation::select_species_integration;
+  KOKKOS_ASSERT(select_species_integration(0., 1., 1.).integration
+                == SpeciesIntegration::NoTransfer);
+  KOKKOS_ASSERT(select_species_integration(0.1, 1., 1.).integration
+                == SpeciesIntegration::Explicit);
+  // Moderately stiff and not faster than transport: 4 sub-steps
+  const auto sub = select_species_integration(2., 1., 1.);
+  KOKKOS_ASSERT(sub.integration == SpeciesIntegration::SubStep);
+  KOKKOS_ASSERT(sub.n_substep == 4);
+  // Exchange much faster than transport, or too many sub-steps
+  KOKKOS_ASSERT(select_species_integration(2., 10., 1.).integration
+                == SpeciesIntegration::PointImplicit);
+  KOKKOS_ASSERT(select_species_integration(100., 0.01, 1.).integration
+                == SpeciesIntegration::PointImplicit);
+}
+
+void
+test_fallback_implicit()
+{
+  auto p = make_phases();
+  auto proxy = make_proxy();
+  p.liquid->set_implicit(true);
+  KOKKOS_ASSERT(
+      !ScalarSimulation::performStepGLFused(1e-3, *p.liquid, *p.gas, proxy));
+}
+
+int
+main()
+{
+  Kokkos::ScopeGuard guard;
+  test_fused_matches_unfused();
+  test_stiff_transfer();
+  test_policy();
+  test_fallback_implicit();
+}
@@ -0,0 +1,97 @@
+#include <Kokkos_Assert.hpp>
+#include <Kokkos_Core.hpp>
+#include <cmath>
+#include <cstddef>
+#include <implicit_scalar_solver.hpp>
+#include <vector>
+
+using Solver = Simulation::ImplicitScalarSolver;
+
+namespace
+{
+  // Closed loop 0->1->2->0 with flow q, diagonal is minus the outflow
+  Solver::sparse_type
+  loop_transition(std::size_t n, double q)
+  {
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const auto ii = static_cast<int>(i);
+      triplets.emplace_back(ii, ii, -q);
+      triplets.emplace_back(ii, static_cast<int>((i + 1) % n), q);
+    }
+    Solver::sparse_type t(static_cast<int>(n), static_cast<int>(n));
+    t.setFromTriplets(triplets.begin(), triplets.end());
+    t.makeCompressed();
+    return t;
+  }
+} // namespace
+
+void
+test_conservation_and_stability()
+{
+  constexpr std::size_t n_c = 3;
+  constexpr std::size_t n_r = 2;
+  const auto t = loop_transition(n_c, 10.);
+  const Solver::vector_type volumes = Solver::vector_type::Constant(n_c, 1.);
+  const Solver::vector_type sink = Solver::vector_type::Zero(n_c);
+
+  Solver solver;
+  solver.set_flowmap(t, volumes);
+
+  Solver::dense_type c = Solver::dense_type::Zero(n_r, n_c);
+  c(0, 0) = 1.;
+  c(1, 2) = 3.;
+
+  // d_t*q/V = 100, explicit Euler would diverge
+  constexpr double d_t = 10.;
+  for (int i = 0; i < 20; ++i)
+  {
+    const Solver::dense_type mass = c * volumes.asDiagonal();
+    KOKKOS_ASSERT(solver.solve(d_t, t, sink, mass, c));
+    KOKKOS_ASSERT((c.array() >= 0.).all());
+    KOKKOS_ASSERT(std::abs((c * volumes).sum() - 4.) < 1e-10);
+  }
+
+  // Well mixed loop: uniform concentration
+  KOKKOS_ASSERT(std::abs(c(0, 1) - 1. / 3.) < 1e-6);
+  KOKKOS_ASSERT(std::abs(c(1, 0) - 1.) < 1e-6);
+
+  // Same flowmap, sink and d_t: only one factorization
+  KOKKOS_ASSERT(solver.n_factorization() == 1);
+}
+
+void
+test_cache_per_flowmap()
+{
+  constexpr std::size_t n_c = 4;
+  const auto t1 = loop_transition(n_c, 1.);
+  const auto t2 = loop_transition(n_c, 2.);
+  const Solver::vector_type volumes = Solver::vector_type::Constant(n_c, 2.);
+  const Solver::vector_type sink = Solver::vector_type::Zero(n_c);
+  Solver::dense_type c = Solver::dense_type::Ones(1, n_c);
+
+  Solver solver;
+  for (int cycle = 0; cycle < 3; ++cycle)
+  {
+    solver.set_flowmap(t1, volumes);
+    KOKKOS_ASSERT(solver.solve(0.1, t1, sink, c * volumes.asDiagonal(), c));
+    solver.set_flowmap(t2, volumes);
+    KOKKOS_ASSERT(solver.solve(0.1, t2, sink, c * volumes.asDiagonal(), c));
+  }
+  KOKKOS_ASSERT(solver.n_factorization() == 2);
+  KOKKOS_ASSERT(solver.n_cached() == 2);
+
+  // New time step invalidates cache
+  KOKKOS_ASSERT(solver.solve(0.2, t2, sink, c * volumes.asDiagonal(), c));
+  KOKKOS_ASSERT(solver.n_factorization() == 3);
+  KOKKOS_ASSERT(solver.n_cached() == 1);
+}
+
+int
+main()
+{
+  Kokkos::ScopeGuard guard;
+  test_conservation_and_stability();
+  test_cache_per_flowmap();
+}
@@ -1,4 +1,5 @@
 #include "Kokkos_Core_fwd.hpp"
+#include <Kokkos_Assert.hpp>
 #include <Kokkos_Core.hpp>
 #include <cassert>
 #include <cmath>
@@ -11,7 +12,7 @@ using space = Kokkos::DefaultExecutionSpace;
 void
 test_probes_set()
 {
-  auto probe = Simulation::Probes<2>(); // Buffer size 2
+  auto probe = Simulation::Probes<2>(true); // Buffer size 2
   assert(probe.set<space::memory_space>(1) == true);
   assert(probe.need_export() == false);
   assert(probe.set<space::memory_space>(2) == true);
@@ -23,7 +24,7 @@ void
 test_probes_get()
 {
   constexpr std::size_t size_buff = 10;
-  auto probe = Simulation::Probes<size_buff>(); // Buffer size 2
+  auto probe = Simulation::Probes<size_buff>(true); // Buffer size 2
   for (auto i = 0LU; i < size_buff; ++i)
   {
     assert(probe.set<space::memory_space>(static_cast<double>(i)) == true);
@@ -45,7 +46,7 @@ test_probes_clear()
 
   constexpr double val_index_2 = 2. * 2.;
 
-  auto probe = Simulation::Probes<size_buff>(); // Buffer size 2
+  auto probe = Simulation::Probes<size_buff>(true); // Buffer size 2
   for (auto i = 0LU; i < size_buff; ++i)
   {
     assert(probe.set<space::memory_space>(2. * static_cast<double>(i))
@@ -72,6 +73,20 @@ test_probes_clear()
   assert(rd[2] == val_index_2);
 }
 
+void
+test_probes_inactive()
+{
+  // Disabled probe must be a no-op whatever the compile time default is
+  auto probe = Simulation::Probes<2>(false);
+  KOKKOS_ASSERT(!probe.is_active());
+  KOKKOS_ASSERT(probe.set<space::memory_space>(1) == true);
+  KOKKOS_ASSERT(probe.set<space::memory_space>(2) == true);
+  KOKKOS_ASSERT(probe.set<space::memory_space>(3) == true);
+  KOKKOS_ASSERT(probe.need_export() == false);
+  KOKKOS_ASSERT(probe.get().empty());
+  probe.clear();
+}
+
 int
 main()
 {
@@ -83,6 +98,7 @@ main()
   // std::cout<<"test_probes: Get OK"<<std::endl;
   // test_probes_clear();
   // std::cout<<"test_probes: Clear OK"<<std::endl;
+  test_probes_inactive();
   Kokkos::finalize();
 }
 
@@ -0,0 +1,98 @@
+#include <Kokkos_Assert.hpp>
+#include <compartment_renumbering.hpp>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+using Simulation::CompartmentPermutation;
+
+namespace
+{
+  constexpr std::size_t pad = static_cast<std::size_t>(-1);
+
+  // Chain of 8 compartments numbered randomly, 2 neighbors per row (padded)
+  std::vector<std::size_t>
+  shuffled_chain()
+  {
+    const std::vector<std::size_t> chain = { 5, 2, 7, 0, 3, 6, 1, 4 };
+    std::vector<std::size_t> flat(chain.size() * 2, pad);
+    for (std::size_t k = 0; k + 1 < chain.size(); ++k)
+    {
+      flat[chain[k] * 2] = chain[k + 1];
+      flat[chain[k + 1] * 2 + 1] = chain[k];
+    }
+    return flat;
+  }
+} // namespace
+
+void
+test_chain_bandwidth()
+{
+  const auto flat = shuffled_chain();
+  const auto identity = CompartmentPermutation::identity(8);
+  KOKKOS_ASSERT(identity.is_identity());
+  KOKKOS_ASSERT(identity.bandwidth(flat) == 7);
+
+  const auto rcm = CompartmentPermutation::reverse_cuthill_mckee(8, flat);
+  KOKKOS_ASSERT(rcm.size() == 8);
+  KOKKOS_ASSERT(rcm.bandwidth(flat) == 1);
+  for (std::size_t i = 0; i < rcm.size(); ++i)
+  {
+    KOKKOS_ASSERT(rcm.to_old(rcm.to_new(i)) == i);
+  }
+}
+
+void
+test_components()
+{
+  // Two pairs {0,3} {1,2} and isolated 4
+  const std::vector<std::size_t> flat = { 3, 2, 1, 0, 4 };
+  const auto rcm = CompartmentPermutation::reverse_cuthill_mckee(5, flat);
+  KOKKOS_ASSERT(rcm.bandwidth(flat) == 1);
+}
+
+void
+test_gather_scatter()
+{
+  const CompartmentPermutation p({ 2, 0, 1 });
+  // Two values per compartment
+  const std::vector<double> flowmap = { 0., 0.5, 1., 1.5, 2., 2.5 };
+  std::vector<double> internal(flowmap.size());
+  p.gather<double>(flowmap, internal, 2);
+  KOKKOS_ASSERT(internal[0] == 2. && internal[1] == 2.5);
+  KOKKOS_ASSERT(internal[2] == 0. && internal[5] == 1.5);
+
+  std::vector<double> back(flowmap.size());
+  p.scatter<double>(internal, back, 2);
+  KOKKOS_ASSERT(back == flowmap);
+
+  std::vector<std::size_t> indices = { 0, 1, 2, pad };
+  p.relabel(indices);
+  KOKKOS_ASSERT(indices[0] == 1 && indices[1] == 2 && indices[2] == 0);
+  KOKKOS_ASSERT(indices[3] == pad);
+}
+
+void
+test_invalid()
+{
+  bool thrown = false;
+  try
+  {
+    const CompartmentPermutation p({ 0, 0, 1 });
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+  KOKKOS_ASSERT(thrown);
+}
+
+int
+main()
+{
+  test_chain_bandwidth();
+  test_components();
+  test_gather_scatter();
+  test_invalid();
+}
@@ -0,0 +1,76 @@
+#include <Kokkos_Assert.hpp>
+#include <cmath>
+#include <cstddef>
+#include <transition_cache.hpp>
+#include <vector>
+
+using Cache = Simulation::TransitionCache;
+
+namespace
+{
+  bool
+  near(double a, double b)
+  {
+    return std::abs(a - b) < 1e-12;
+  }
+} // namespace
+
+void
+test_value_refresh()
+{
+  // Unsorted COO with a duplicate (1,0)
+  const std::vector<std::size_t> rows = { 2, 0, 1, 1, 0 };
+  const std::vector<std::size_t> cols = { 1, 0, 0, 0, 2 };
+  std::vector<double> vals = { 1., 2., 3., 4., 5. };
+
+  Cache cache(3);
+  KOKKOS_ASSERT(cache.current().nonZeros() == 0);
+
+  const auto& m1 = cache.update(rows, cols, vals);
+  KOKKOS_ASSERT(m1.nonZeros() == 4);
+  KOKKOS_ASSERT(near(m1.coeff(2, 1), 1.));
+  KOKKOS_ASSERT(near(m1.coeff(0, 0), 2.));
+  KOKKOS_ASSERT(near(m1.coeff(1, 0), 7.));
+  KOKKOS_ASSERT(near(m1.coeff(0, 2), 5.));
+
+  // Same pattern: values written in place, no rebuild
+  vals = { -1., 10., 0.5, 0.25, 0. };
+  const auto& m2 = cache.update(rows, cols, vals);
+  KOKKOS_ASSERT(&m1 == &m2);
+  KOKKOS_ASSERT(cache.n_build() == 1);
+  KOKKOS_ASSERT(near(m2.coeff(2, 1), -1.));
+  KOKKOS_ASSERT(near(m2.coeff(0, 0), 10.));
+  KOKKOS_ASSERT(near(m2.coeff(1, 0), 0.75));
+  KOKKOS_ASSERT(near(m2.coeff(0, 2), 0.));
+  KOKKOS_ASSERT(m2.nonZeros() == 4);
+}
+
+void
+test_pattern_switch()
+{
+  const std::vector<std::size_t> rows_a = { 0, 1 };
+  const std::vector<std::size_t> cols_a = { 1, 0 };
+  const std::vector<std::size_t> rows_b = { 0, 1, 1 };
+  const std::vector<std::size_t> cols_b = { 0, 1, 0 };
+  const std::vector<double> vals_a = { 1., 2. };
+  const std::vector<double> vals_b = { 3., 4., 5. };
+
+  Cache cache(2);
+  for (int cycle = 0; cycle < 3; ++cycle)
+  {
+    const auto& a = cache.update(rows_a, cols_a, vals_a);
+    KOKKOS_ASSERT(near(a.coeff(0, 1), 1.) && near(a.coeff(1, 0), 2.));
+    const auto& b = cache.update(rows_b, cols_b, vals_b);
+    KOKKOS_ASSERT(near(b.coeff(1, 1), 4.) && near(b.coeff(1, 0), 5.));
+    KOKKOS_ASSERT(&cache.current() == &b);
+  }
+  KOKKOS_ASSERT(cache.n_build() == 2);
+  KOKKOS_ASSERT(cache.n_pattern() == 2);
+}
+
+int
+main()
+{
+  test_value_refresh();
+  test_pattern_switch();
+}
@@ -0,0 +1,37 @@
+#!/bin/sh
+# Compare the cost of instrumentation disabled at runtime with a build where
+# instrumentation is disabled at compile time.
+#
+# Usage: ./tools/benchs/bench_instrumentation.sh [reference_executable]
+#   reference_executable: optional binary built with use_probe=false and
+#   enable_event_counter=false, run with the same arguments
+#
+# Each configuration is run N_RUN times, wall time is printed in seconds.
+
+export OMP_PROC_BIND=spread
+export OMP_PLACES=threads
+
+N_RUN=${N_RUN:-5}
+CLI=$(echo $(./tools/runner.py bench -n 1 --dry-run))
+EXE=$(echo "$CLI" | cut -d' ' -f1)
+ARGS=$(echo "$CLI" | cut -d' ' -f2-)
+
+run() {
+  label=$1
+  shift
+  i=0
+  while [ "$i" -lt "$N_RUN" ]; do
+    start=$(date +%s.%N)
+    "$@" $ARGS -force 1 >/dev/null 2>&1
+    end=$(date +%s.%N)
+    echo "$label $(echo "$end - $start" | bc)"
+    i=$((i + 1))
+  done
+}
+
+BIOMC_INSTRUMENTATION=none run "runtime_off" "$EXE"
+BIOMC_INSTRUMENTATION=all run "runtime_on" "$EXE"
+
+if [ -n "$1" ]; then
+  run "compile_time_off" "$1"
+fi